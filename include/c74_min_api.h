@@ -5,13 +5,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -22,6 +28,17 @@
 #include <unordered_map>
 #include <utility>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>    // _mm_pause() for spin-waits and the SSE shuffles that transpose buffer~ frames
+#endif
+
+#ifndef _WIN32
+    #include <fcntl.h>        // memory-mapped files for stream_reference, which uses the Windows API included by the Max SDK on Windows
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-variable"
@@ -127,7 +144,9 @@ namespace c74::min {
     class matrix_operator_base;
     class gl_operator_base;
     class mc_operator_base;
+    class poly_operator_base;
     class sample_operator_base;
+    class spectral_operator_base;
     class vector_operator_base;
     class ui_operator_base;
 
@@ -228,13 +247,23 @@ namespace c74::min {
 
     template<class min_class_type>
     using enable_if_vector_operator =
-        typename enable_if<is_base_of<vector_operator_base, min_class_type>::value, int>::type;
+        typename enable_if<is_base_of<vector_operator_base, min_class_type>::value
+        && !is_base_of<poly_operator_base, min_class_type>::value, int>::type;
+
+    template<class min_class_type>
+    using enable_if_poly_operator =
+        typename enable_if<is_base_of<poly_operator_base, min_class_type>::value, int>::type;
+
+    template<class min_class_type>
+    using enable_if_spectral_operator =
+        typename enable_if<is_base_of<spectral_operator_base, min_class_type>::value, int>::type;
 
     template<class min_class_type>
     using enable_if_audio_class =
         typename enable_if<is_base_of<vector_operator_base, min_class_type>::value
         || is_base_of<mc_operator_base, min_class_type>::value
-        || is_base_of<sample_operator_base, min_class_type>::value, int>::type;
+        || is_base_of<sample_operator_base, min_class_type>::value
+        || is_base_of<spectral_operator_base, min_class_type>::value, int>::type;
 
     template<class min_class_type>
     using enable_if_jitter_class =
@@ -251,13 +280,15 @@ namespace c74::min {
     using type_enable_if_audio_class =
         typename enable_if<is_base_of<vector_operator_base, min_class_type>::value
         || is_base_of<mc_operator_base, min_class_type>::value
-        || is_base_of<sample_operator_base, min_class_type>::value>::type;
+        || is_base_of<sample_operator_base, min_class_type>::value
+        || is_base_of<spectral_operator_base, min_class_type>::value>::type;
 
     template<class min_class_type>
     using type_enable_if_not_audio_class =
         typename enable_if<!is_base_of<vector_operator_base, min_class_type>::value
         && !is_base_of<mc_operator_base, min_class_type>::value
-        && !is_base_of<sample_operator_base, min_class_type>::value>::type;
+        && !is_base_of<sample_operator_base, min_class_type>::value
+        && !is_base_of<spectral_operator_base, min_class_type>::value>::type;
 
     template<class min_class_type>
     using type_enable_if_not_jitter_class =
@@ -367,6 +398,8 @@ namespace c74::min {
 #include "c74_min_atom.h"
 #include "c74_min_dictionary.h"
 #include "c74_min_limit.h"      // Library of miscellaneous helper functions (e.g. range clipping)
+#include "c74_min_simd.h"       // Packs of samples for vectorized audio processing
+#include "c74_min_denormal.h"   // Control of denormal numbers for audio processing
 
 #include "c74_min_notification.h"       // A class representing notifications from attached-to objects
 #include "c74_min_patcher.h"            // Wrapper for interfacing with patchers
@@ -382,10 +415,22 @@ namespace c74::min {
 #include "c74_min_argument.h"           // Arguments to objects
 #include "c74_min_message.h"            // Messages to objects
 #include "c74_min_attribute.h"          // Attributes of objects
+#include "c74_min_smoothed.h"           // Ramping of attribute values for audio objects
+#include "c74_min_audio_events.h"       // Sample-accurate scheduling of attribute changes for audio objects
+#include "c74_min_oversampler.h"        // Oversampling of sample_operator<> classes
+#include "c74_min_worker_pool.h"        // Threads for processing audio channels in parallel
+#include "c74_min_background.h"         // A thread shared by objects for work away from the audio and main threads
+#include "c74_min_dsp_profiler.h"       // Timing of perform routines for audio objects
+#include "c74_min_fft.h"                // Fast Fourier transform of real signals
+#include "c74_min_delay_line.h"         // Circular buffers for delay-based audio objects
+#include "c74_min_resampler.h"          // Windowed-sinc samplerate conversion
 #include "c74_min_logger.h"             // Console / Max Window output
 #include "c74_min_operator_vector.h"    // Vector-based MSP object add-ins
 #include "c74_min_operator_sample.h"    // Sample-based MSP object add-ins
 #include "c74_min_operator_mc.h"    	// Vector-based MC object add-ins
+#include "c74_min_operator_spectral.h"  // Frequency-domain MSP object add-ins
+#include "c74_min_operator_poly.h"      // Polyphonic MSP object add-ins
+#include "c74_min_chain.h"              // Composition of sample_operator<> classes
 #include "c74_min_operator_matrix.h"    // Jitter MOP add-ins
 #include "c74_min_operator_ui.h"		// User Interface add-ins
 #include "c74_min_graphics.h"			// Graphics classes for UI objects
@@ -397,7 +442,10 @@ namespace c74::min {
 #include "c74_min_timer.h"              // Wrapper for clocks
 #include "c74_min_queue.h"              // Wrapper for qelems and fifos
 #include "c74_min_buffer.h"             // Wrapper for MSP buffers
+#include "c74_min_convolver.h"          // Partitioned convolution with impulse responses from buffers
+#include "c74_min_buffer_snapshot.h"    // Copies of buffers that the audio thread reads while they are rewritten
 #include "c74_min_path.h"               // Wrapper class for accessing the Max path system
+#include "c74_min_stream.h"             // Audio files played from disk through a read-ahead ring
 #include "c74_min_texteditor.h"         // Wrapper for text editor window
 #include "c74_min_dataspace.h"          // Unit conversion routines (e.g. db-to-linear or hz-to-midi)
 
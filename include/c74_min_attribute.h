@@ -134,6 +134,14 @@ namespace c74::min {
 	};
 
 
+    /// A function that assigns the value of an audio signal directly to an attribute.
+    /// It does not allocate, notify, or call the attribute's setter,
+    /// which makes it suitable for calling once per sample in an audio perform routine.
+    /// @ingroup attributes
+
+    using signal_setter = void (*)(attribute_base& attr, const sample value);
+
+
     // Represents any type of attribute.
     // Used internally to allow heterogenous containers of attributes for the Min class.
     /// @ingroup attributes
@@ -165,6 +173,15 @@ namespace c74::min {
         virtual void set(const atoms& args, const bool notify = true, const bool override_readonly = false) = 0;
 
 
+        // Attributes that can be assigned directly from an audio signal return the function that does so.
+        // Attributes that must be set using atoms (e.g. they are not numeric or have a custom setter) return nullptr.
+        // Called when the dsp chain is compiled, not in the perform routine.
+
+        virtual signal_setter signal_setter_function() const {
+            return nullptr;
+        }
+
+
         // All attributes must define what happens when you get their value.
 
         virtual operator atoms() const = 0;
@@ -621,6 +638,27 @@ namespace c74::min {
         }
 
 
+        /// Set the attribute value from an audio signal.
+        /// The value is range-limited and written directly to the attribute's native storage.
+        /// Unlike set() there is no allocation, no notification, no deferral to the main thread, and no call to a custom setter.
+        /// This is how audio inlets mapped to an attribute update its value for each sample.
+        /// @param	value	The new value to be assigned to the attribute.
+
+        template<class U = T, typename enable_if<std::is_arithmetic<U>::value, int>::type = 0>
+        void set_from_signal(const sample value) {
+            m_value = constrain_value(static_cast<T>(value));
+        }
+
+
+        // Attributes that are numeric and do not define a custom setter may be assigned directly from an audio signal.
+
+        signal_setter signal_setter_function() const override {
+            if (!writable() || m_setter)
+                return nullptr;
+            return select_signal_setter();
+        }
+
+
         /// Get the raw attribute value from an attribute.
         /// @return The attribute value.
 
@@ -769,6 +807,41 @@ namespace c74::min {
         }
 
 
+        // Apply range limiting to a native value as assigned from an audio signal.
+        // Optimization for the most common case: no limiting at all.
+
+        template<class U = T, typename enable_if<is_same<limit_type<U>, limit::none<U>>::value, int>::type = 0>
+        T constrain_value(const T value) const {
+            return value;
+        }
+
+
+        // Apply range limiting to a native value as assigned from an audio signal.
+
+        template<class U = T, typename enable_if<!is_same<limit_type<U>, limit::none<U>>::value, int>::type = 0>
+        T constrain_value(const T value) const {
+            return limit_type<T>::apply(value, m_range[0], m_range[1]);
+        }
+
+
+        // Return the function used by signal_setter_function() for numeric attributes.
+
+        template<class U = T, typename enable_if<std::is_arithmetic<U>::value, int>::type = 0>
+        signal_setter select_signal_setter() const {
+            return [](attribute_base& attr, const sample value) {
+                static_cast<attribute&>(attr).set_from_signal(value);
+            };
+        }
+
+
+        // All other attributes must be set using atoms.
+
+        template<class U = T, typename enable_if<!std::is_arithmetic<U>::value, int>::type = 0>
+        signal_setter select_signal_setter() const {
+            return nullptr;
+        }
+
+
         // Assign the value to the internal data storage member.
         // Occurs after the limits are constrained, the setter is called, etc.
 
@@ -102,7 +102,7 @@ namespace c74::min {
 
 
     template<>
-    void attribute<numbers>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass) {
+    inline void attribute<numbers>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass) {
         long attr_flags {};
         if (visible() == visibility::hide)
             attr_flags |= max::ATTR_SET_OPAQUE_USER;
@@ -126,7 +126,7 @@ namespace c74::min {
 
 
     template<>
-    void attribute<ints>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass) {
+    inline void attribute<ints>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass) {
         long attr_flags {};
         if (visible() == visibility::hide)
             attr_flags |= max::ATTR_SET_OPAQUE_USER;
@@ -204,7 +204,7 @@ namespace c74::min {
 
 
     template<>
-    std::string attribute<numbers>::range_string() const {
+    inline std::string attribute<numbers>::range_string() const {
         if (m_range.empty())
             return "";
 
@@ -218,7 +218,7 @@ namespace c74::min {
 
 
     template<>
-    std::string attribute<ints>::range_string() const {
+    inline std::string attribute<ints>::range_string() const {
         if (m_range.empty())
             return "";
 
@@ -259,7 +259,7 @@ namespace c74::min {
 
 
     template<>
-    void attribute<numbers>::copy_range() {
+    inline void attribute<numbers>::copy_range() {
         if (!m_range.empty()) {
             // the range for this type is a low-bound and high-bound applied to all elements in the vector
             assert(m_range_args.size() == 2);
@@ -272,7 +272,7 @@ namespace c74::min {
 
 
     template<>
-    void attribute<ints>::copy_range() {
+    inline void attribute<ints>::copy_range() {
         if (!m_range.empty()) {
             // the range for this type is a low-bound and high-bound applied to all elements in the vector
             assert(m_range_args.size() == 2);
@@ -290,17 +290,17 @@ namespace c74::min {
     }
 
     template<>
-    bool attribute<number>::compare_to_current_value(const atoms& args) const {
+    inline bool attribute<number>::compare_to_current_value(const atoms& args) const {
         return equivalent<number>(args[0], m_value);
     }
 
     template<>
-    bool attribute<symbol>::compare_to_current_value(const atoms& args) const {
+    inline bool attribute<symbol>::compare_to_current_value(const atoms& args) const {
         return (args[0] == m_value);
     }
 
     template<>
-    bool attribute<numbers>::compare_to_current_value(const atoms& args) const {
+    inline bool attribute<numbers>::compare_to_current_value(const atoms& args) const {
         if (args.size() == m_value.size()) {
             for (auto i=0; i<m_value.size(); ++i) {
                 if (!equivalent<double>(args[i], m_value[i]))
@@ -312,7 +312,7 @@ namespace c74::min {
     }
 
     template<>
-    bool attribute<ints>::compare_to_current_value(const atoms& args) const {
+    inline bool attribute<ints>::compare_to_current_value(const atoms& args) const {
         if (args.size() == m_value.size()) {
             for (auto i=0; i<m_value.size(); ++i) {
                 if (!equivalent<int>(args[i], m_value[i]))
@@ -324,7 +324,7 @@ namespace c74::min {
     }
 
     template<>
-    bool attribute<ui::color>::compare_to_current_value(const atoms& args) const {
+    inline bool attribute<ui::color>::compare_to_current_value(const atoms& args) const {
         return equivalent<double>(args[0], m_value.red())
         && equivalent<double>(args[1], m_value.green())
         && equivalent<double>(args[2], m_value.blue())
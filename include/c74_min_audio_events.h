@@ -0,0 +1,212 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A change to an attribute value that is scheduled to happen at a specific sample of the audio stream.
+    /// Events are created by audio_event_queue::post() and applied by the performer.
+
+    struct audio_event {
+        long long       time;       ///< The sample time at which the value is applied.
+        attribute_base* attr;       ///< The attribute to set.
+        signal_setter   setter;     ///< The allocation-free setter of the attribute.
+        sample          value;      ///< The new value.
+    };
+
+
+    /// A queue of sample-accurate attribute changes for an audio object.
+    ///
+    /// Messages that change attributes arrive between calls to the perform routine,
+    /// so normally any change takes effect at the start of a vector.
+    /// When an audio object declares an audio_event_queue member, attribute changes can instead be posted with a time.
+    /// The performer will then split each vector at the times of the pending events
+    /// and apply each event at the exact sample for which it was scheduled.
+    /// This provides sample-accuracy without requiring a small vector size.
+    /// @code
+    /// attribute<number>   m_gain      { this, "gain", 1.0 };
+    /// audio_event_queue   m_events    { this };
+    ///
+    /// message<> gain_at { this, "gain_at", "Set the gain after a delay in samples.",
+    ///     MIN_FUNCTION {
+    ///         m_events.post(m_gain, args[0], args[1]);
+    ///         return {};
+    ///     }
+    /// };
+    /// @endcode
+    ///
+    /// Times are counted in samples processed by the object since it was created.
+    /// Events may be posted from any thread.
+    /// The audio thread consumes events without locking or allocating memory.
+    /// Only numeric attributes without a custom setter can be scheduled, see attribute_base::signal_setter_function().
+
+    class audio_event_queue {
+    public:
+        /// The maximum number of events that may be pending at any time.
+        /// Events posted beyond this capacity are rejected.
+
+        static constexpr size_t k_capacity = 256;
+
+
+        /// Create an event queue for an audio object.
+        /// @param	an_owner	The owning audio object. Typically you will pass `this`.
+
+        template<class owner_type>
+        explicit audio_event_queue(owner_type* an_owner)
+        : m_incoming { k_capacity } {
+            m_pending.reserve(k_capacity);
+            an_owner->event_queue(this);
+        }
+
+        audio_event_queue(const audio_event_queue& other) = delete;
+        audio_event_queue& operator=(const audio_event_queue& other) = delete;
+
+
+        /// Return the number of samples processed by the owning object.
+        /// This is the time of the first sample of the next vector to be processed.
+        /// @return	The current sample time.
+
+        long long sample_time() const {
+            return m_sample_time.load(std::memory_order_acquire);
+        }
+
+
+        /// Schedule an attribute change at a specific sample time.
+        /// If the time is already in the past the change is applied at the start of the next vector.
+        /// @param	a_time		The sample time at which to apply the change.
+        /// @param	an_attr		The attribute to change.
+        /// @param	a_value		The new value for the attribute.
+        /// @return				True if the event was queued.
+        ///						False if the attribute cannot be scheduled or the queue is full.
+
+        bool post_at(const long long a_time, attribute_base& an_attr, const sample a_value) {
+            const auto setter = an_attr.signal_setter_function();
+
+            if (setter == nullptr)
+                return false;
+
+            guard lock { m_post_mutex };
+            return m_incoming.try_enqueue({ a_time, &an_attr, setter, a_value });
+        }
+
+
+        /// Schedule an attribute change relative to the current sample time.
+        /// @param	an_attr				The attribute to change.
+        /// @param	a_value				The new value for the attribute.
+        /// @param	delay_in_samples	The number of samples after the start of the next vector at which to apply the change.
+        /// @return						True if the event was queued.
+        ///								False if the attribute cannot be scheduled or the queue is full.
+
+        bool post(attribute_base& an_attr, const sample a_value, const long delay_in_samples = 0) {
+            return post_at(sample_time() + delay_in_samples, an_attr, a_value);
+        }
+
+
+        /// Called by the performer when the dsp chain is compiled.
+        /// Allocates the channel pointers used to split vectors.
+        /// @param	input_count		The maximum number of audio inputs.
+        /// @param	output_count	The maximum number of audio outputs.
+
+        void dspsetup(const size_t input_count, const size_t output_count) {
+            m_inputs.resize(input_count);
+            m_outputs.resize(output_count);
+        }
+
+
+        /// Called by the performer at the start of each vector.
+        /// Moves newly posted events into the time-ordered list of pending events.
+
+        void receive() {
+            audio_event event;
+
+            while (m_pending.size() < k_capacity && m_incoming.try_dequeue(event)) {
+                auto position = std::upper_bound(m_pending.begin() + m_head, m_pending.end(), event,
+                    [](const audio_event& a, const audio_event& b) { return a.time < b.time; });
+                m_pending.insert(position, event);
+            }
+        }
+
+
+        /// Called by the performer to apply all events that are due at an offset into the current vector.
+        /// @param	offset	The offset, in samples, from the start of the vector.
+
+        void apply(const long offset) {
+            const auto now = m_sample_time.load(std::memory_order_relaxed) + offset;
+
+            while (m_head < m_pending.size() && m_pending[m_head].time <= now) {
+                auto& event = m_pending[m_head];
+                event.setter(*event.attr, event.value);
+                ++m_head;
+            }
+        }
+
+
+        /// Called by the performer to find where the current vector should next be split.
+        /// @param	frame_count		The number of samples in the vector.
+        /// @return					The offset of the next pending event in the vector, or frame_count if none is due in this vector.
+
+        long next(const long frame_count) const {
+            if (m_head == m_pending.size())
+                return frame_count;
+
+            const auto offset = m_pending[m_head].time - m_sample_time.load(std::memory_order_relaxed);
+            return offset < frame_count ? static_cast<long>(offset) : frame_count;
+        }
+
+
+        /// Called by the performer at the end of each vector.
+        /// @param	frame_count		The number of samples in the vector.
+
+        void advance(const long frame_count) {
+            m_pending.erase(m_pending.begin(), m_pending.begin() + m_head);
+            m_head = 0;
+            m_sample_time.store(m_sample_time.load(std::memory_order_relaxed) + frame_count, std::memory_order_release);
+        }
+
+
+        /// Return the number of input channel pointers allocated by dspsetup().
+        /// @return	The number of input channels that can be split.
+
+        long input_count() const {
+            return static_cast<long>(m_inputs.size());
+        }
+
+
+        /// Return the number of output channel pointers allocated by dspsetup().
+        /// @return	The number of output channels that can be split.
+
+        long output_count() const {
+            return static_cast<long>(m_outputs.size());
+        }
+
+
+        /// Get storage for the channel pointers of a split vector.
+        /// @return	Storage for the input channel pointers, as allocated by dspsetup().
+
+        double** inputs() {
+            return m_inputs.data();
+        }
+
+
+        /// Get storage for the channel pointers of a split vector.
+        /// @return	Storage for the output channel pointers, as allocated by dspsetup().
+
+        double** outputs() {
+            return m_outputs.data();
+        }
+
+    private:
+        fifo<audio_event>       m_incoming;
+        mutex                   m_post_mutex;                   // the fifo permits only one producer at a time
+        vector<audio_event>     m_pending;                      // sorted by time, only accessed from the audio thread
+        size_t                  m_head { 0 };                   // index of the first pending event that has not been applied
+        std::atomic<long long>  m_sample_time { 0 };
+        vector<double*>         m_inputs;
+        vector<double*>         m_outputs;
+    };
+
+}    // namespace c74::min
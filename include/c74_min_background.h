@@ -0,0 +1,181 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A single thread, shared by all objects of an external, for work that must be done neither on the audio thread
+    /// nor on the main thread, e.g. copying a buffer~, computing the partitions of an impulse response or reading a file.
+    ///
+    /// Each object that uses it is a client, whose service() is called on the thread after request() or wake(),
+    /// and again after any delay that service() returns.
+    /// The thread sleeps until then, so an idle client costs nothing.
+    /// Clients are served one at a time, so service() should do a bounded amount of work before returning.
+    /// The audio thread wakes the thread with wake(), e.g. to free memory it has stopped using, which neither locks nor allocates.
+    /// Used by buffer_snapshot, convolver and stream_reference.
+
+    class background_thread {
+    public:
+        /// The interface of an object that does work on the background thread.
+
+        class client {
+        public:
+            virtual ~client() = default;
+
+            /// Do any pending work. Called on the background thread.
+            /// @return	The delay after which to be called again if the thread is not woken before,
+            ///			or zero to wait until it is woken.
+
+            virtual std::chrono::microseconds service() = 0;
+        };
+
+
+        /// The longest time that the work following a wake() may be delayed because the thread missed it.
+        /// A client waiting for the audio thread to wake it should return this from service().
+
+        static constexpr std::chrono::microseconds k_missed_wake_time { 100000 };
+
+
+        /// Get the thread shared by all objects of this external.
+        /// It is started on the first call, which should not be made from the audio thread.
+        /// @return	The shared thread.
+
+        static background_thread& shared() {
+            // never freed, as the thread must not be joined while the external is being unloaded
+            static background_thread* s_thread = new background_thread;
+            return *s_thread;
+        }
+
+        background_thread(const background_thread& other) = delete;
+        background_thread& operator=(const background_thread& other) = delete;
+
+
+        /// Add a client, whose service() is called from then on.
+        /// Must not be called from the audio thread.
+        /// @param	a_client	The client, which must be removed before it is destroyed.
+
+        void add(client* a_client) {
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_clients.push_back({ a_client, clock::time_point::max() });
+                m_woken.store(true, std::memory_order_relaxed);
+            }
+            m_condition.notify_one();
+        }
+
+
+        /// Remove a client, waiting until any call to its service() has returned.
+        /// Must not be called from the audio thread or from service().
+        /// @param	a_client	The client.
+
+        void remove(client* a_client) {
+            std::unique_lock<std::mutex> lock { m_mutex };
+
+            m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(), [a_client](const entry& an_entry) {
+                return an_entry.owner == a_client;
+            }), m_clients.end());
+            m_idle.wait(lock, [this, a_client]() { return m_running != a_client; });
+        }
+
+
+        /// Wake the thread to serve the clients that have new work.
+        /// Must not be called from the audio thread, which calls wake() instead.
+
+        void request() {
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_woken.store(true, std::memory_order_relaxed);
+            }
+            m_condition.notify_one();
+        }
+
+
+        /// Wake the thread from the audio thread, without locking.
+        /// If the thread is just going to sleep it may miss this, see k_missed_wake_time.
+
+        void wake() {
+            m_woken.store(true, std::memory_order_release);
+            m_condition.notify_one();
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct entry {
+            client*             owner;
+            clock::time_point   due;        // time_point::max() until woken
+        };
+
+        std::mutex                  m_mutex;
+        std::condition_variable     m_condition;
+        std::condition_variable     m_idle;
+        std::atomic<bool>           m_woken { false };
+        vector<entry>               m_clients;
+        client*                     m_running { nullptr };    // the client whose service() is being called
+        std::thread                 m_thread;                 // last, so that everything it uses is initialized first
+
+
+        background_thread()
+        : m_thread { [this]() { run(); } }
+        {}
+
+
+        // The loop of the thread.
+        // A wake makes every client due, as it does not say which of them has work.
+        // The mutex is released while a client is served, so clients may be added or removed meanwhile.
+        // A client that moves to an index that was already passed is served in the next round.
+
+        void run() {
+            std::unique_lock<std::mutex> lock { m_mutex };
+
+            while (true) {
+                if (m_woken.exchange(false, std::memory_order_acquire)) {
+                    for (auto& an_entry : m_clients)
+                        an_entry.due = clock::now();
+                }
+
+                const auto now = clock::now();
+
+                for (size_t i = 0; i < m_clients.size(); ++i) {
+                    if (m_clients[i].due > now)
+                        continue;
+
+                    const auto a_client = m_clients[i].owner;
+
+                    m_clients[i].due    = clock::time_point::max();
+                    m_running           = a_client;
+                    lock.unlock();
+
+                    const auto delay = a_client->service();
+
+                    lock.lock();
+                    m_running = nullptr;
+                    m_idle.notify_all();
+
+                    if (delay.count() > 0) {
+                        for (auto& an_entry : m_clients) {
+                            if (an_entry.owner == a_client)
+                                an_entry.due = clock::now() + delay;
+                        }
+                    }
+                }
+
+                auto until = clock::time_point::max();
+                for (const auto& an_entry : m_clients)
+                    until = std::min(until, an_entry.due);
+
+                const auto woken = [this]() { return m_woken.load(std::memory_order_acquire); };
+
+                if (until == clock::time_point::max())
+                    m_condition.wait(lock, woken);
+                else
+                    m_condition.wait_until(lock, until, woken);
+            }
+        }
+    };
+
+}    // namespace c74::min
@@ -162,6 +162,367 @@ namespace c74::min {
     };
 
 
+    /// A view of the samples of one channel of a locked buffer~.
+    /// The samples of a buffer~ are interleaved, so consecutive frames of a channel are channel_count() samples apart.
+    /// The view is only valid while the buffer_lock from which it was obtained exists.
+    /// @ingroup buffers
+
+    class buffer_channel {
+    public:
+        /// Create a view of samples spaced at a regular interval.
+        /// You will not typically have any need to call this: get a view from buffer_lock::channel() instead.
+        /// @param	a_first		The first sample of the channel.
+        /// @param	a_stride	The distance between consecutive frames of the channel, i.e. the number of channels.
+        /// @param	a_size		The number of frames.
+
+        buffer_channel(float* a_first, const size_t a_stride, const size_t a_size)
+        : m_first { a_first }
+        , m_stride { a_stride }
+        , m_size { a_size }
+        {}
+
+
+        /// Read or write a sample without checking the frame.
+        /// @param	frame	The frame, which must be less than size().
+        /// @return			A reference to the sample.
+
+        float& operator[](const size_t frame) const {
+            return m_first[frame * m_stride];
+        }
+
+
+        /// Read or write a sample, limiting the frame to the last frame of the channel as lookup() does.
+        /// The channel must not be empty.
+        /// @param	frame	The frame.
+        /// @return			A reference to the sample.
+
+        float& at(const size_t frame) const {
+            return m_first[std::min(frame, m_size - 1) * m_stride];
+        }
+
+
+        /// Return the number of frames.
+        /// @return	The number of frames in the channel.
+
+        size_t size() const {
+            return m_size;
+        }
+
+
+        /// Return the distance between consecutive frames in the memory of the buffer~.
+        /// @return	The number of samples from one frame of the channel to the next.
+
+        size_t stride() const {
+            return m_stride;
+        }
+
+
+        /// Get the first sample of the channel.
+        /// @return	A pointer to the first sample.
+
+        float* data() const {
+            return m_first;
+        }
+
+    private:
+        float*  m_first;
+        size_t  m_stride;
+        size_t  m_size;
+    };
+
+
+    /// The methods for reading from a buffer_reader between frames.
+    /// @ingroup buffers
+
+    enum class buffer_interpolation {
+        none,       ///< Truncate the position to the frame before it.
+        linear,     ///< Straight line between the two nearest frames.
+        cubic,      ///< Cubic Hermite (Catmull-Rom) spline through the four nearest frames.
+        sinc        ///< Kaiser-windowed sinc filter through the twenty nearest frames, with the tables of the resampler.
+    };
+
+
+    /// How a buffer_reader treats positions before the first frame or after the last frame.
+    /// @ingroup buffers
+
+    enum class buffer_edge {
+        clamp,      ///< Repeat the first or last frame.
+        wrap,       ///< Continue from the other end, e.g. for a loop or a wavetable.
+        fold        ///< Reflect back from the first or last frame.
+    };
+
+
+    /// Read one channel of a locked buffer~ at fractional positions, e.g. for a sampler, a wavetable oscillator, or a granulator.
+    /// Get a reader from buffer_lock::reader() and pass it one position for each sample of the vector:
+    /// @code
+    /// buffer_lock<>	b { my_buffer };
+    /// auto			left = b.reader(0, buffer_interpolation::cubic, buffer_edge::wrap);
+    ///
+    /// left.read(output.samples(0), input.samples(0), input.frame_count());    // positions in frames
+    /// @endcode
+    /// When all positions of a vector are inside the channel, it is read without checking each one against the edges.
+    /// Sinc interpolation does not lower its cutoff when the positions advance by more than one frame per sample,
+    /// so use a resampler to play back faster than the original speed without aliasing.
+    /// The reader is only valid while the buffer_lock from which it was obtained exists.
+    /// @ingroup buffers
+
+    class buffer_reader {
+    public:
+        /// Create a reader.
+        /// You will not typically have any need to call this: get a reader from buffer_lock::reader() instead.
+        /// The table for sinc interpolation is computed when the external is loaded, so readers may be created on the audio thread.
+        /// @param	a_channel		The channel to read.
+        /// @param	interpolation	The method of interpolation.
+        /// @param	edge			How positions outside the channel are treated.
+
+        buffer_reader(const buffer_channel& a_channel, const buffer_interpolation interpolation = buffer_interpolation::linear, const buffer_edge edge = buffer_edge::clamp)
+        : m_channel { a_channel }
+        , m_interpolation { interpolation }
+        , m_edge { edge }
+        {
+            if (m_interpolation == buffer_interpolation::sinc)
+                m_sinc_table = sinc_table<>::s_table;
+        }
+
+
+        /// Return the number of frames in the channel.
+        /// @return	The number of frames.
+
+        size_t size() const {
+            return m_channel.size();
+        }
+
+
+        /// Read a sample at a position between frames.
+        /// @param	position	The position in frames.
+        /// @return				The interpolated sample, or zero if the channel is empty.
+
+        sample read(const double position) const {
+            if (m_channel.size() == 0)
+                return 0.0;
+
+            switch (m_interpolation) {
+                case buffer_interpolation::none:    return read_sample<truncating>(position);
+                case buffer_interpolation::linear:  return read_sample<linear_interpolating>(position);
+                case buffer_interpolation::cubic:   return read_sample<cubic_interpolating>(position);
+                case buffer_interpolation::sinc:    return read_sample<sinc_filtering>(position);
+            }
+            return 0.0;
+        }
+
+
+        /// Read a vector of samples, each at its own position between frames.
+        /// @param	destination		Storage for the samples. This may be the same memory as the positions.
+        /// @param	positions		The position in frames of each sample.
+        /// @param	frame_count		The number of samples.
+
+        void read(sample* destination, const sample* positions, const long frame_count) const {
+            if (m_channel.size() == 0) {
+                std::fill(destination, destination + std::max(frame_count, 0L), 0.0);
+                return;
+            }
+
+            switch (m_interpolation) {
+                case buffer_interpolation::none:    read_vector<truncating>(destination, positions, frame_count); break;
+                case buffer_interpolation::linear:  read_vector<linear_interpolating>(destination, positions, frame_count); break;
+                case buffer_interpolation::cubic:   read_vector<cubic_interpolating>(destination, positions, frame_count); break;
+                case buffer_interpolation::sinc:
+                    for (auto i = 0; i < frame_count; ++i)
+                        destination[i] = read_sample<sinc_filtering>(positions[i]);
+                    break;
+            }
+        }
+
+    private:
+        // The quality of the sinc filter, see resampler. The table has fewer than 4 * k_sinc_quality taps.
+
+        static constexpr size_t k_sinc_quality = 8;
+
+        buffer_channel              m_channel;
+        buffer_interpolation        m_interpolation;
+        buffer_edge                 m_edge;
+        const resampler::table*     m_sinc_table { nullptr };
+
+
+        // The table is fetched during static initialization, when the external is loaded,
+        // rather than by the first reader, which may be created on the audio thread.
+        // It is a member of a template so that only externals that create readers compute it.
+
+        template<class T = void>
+        struct sinc_table {
+            static const resampler::table* const s_table;
+        };
+
+
+        // The interpolators take the frames starting from the whole part of the position plus `first`
+        // and the fractional part of the position.
+
+        struct truncating {
+            static constexpr int first = 0;
+            static constexpr int count = 1;
+
+            static sample interpolate(const sample* x, const sample f) {
+                return x[0];
+            }
+        };
+
+        struct linear_interpolating {
+            static constexpr int first = 0;
+            static constexpr int count = 2;
+
+            static sample interpolate(const sample* x, const sample f) {
+                return x[0] + (x[1] - x[0]) * f;
+            }
+        };
+
+        struct cubic_interpolating {
+            static constexpr int first = -1;
+            static constexpr int count = 4;
+
+            static sample interpolate(const sample* x, const sample f) {
+                const sample c1 = (x[2] - x[0]) * 0.5;
+                const sample c2 = x[0] - x[1] * 2.5 + x[2] * 2.0 - x[3] * 0.5;
+                const sample c3 = (x[3] - x[0]) * 0.5 + (x[1] - x[2]) * 1.5;
+                return ((c3 * f + c2) * f + c1) * f + x[1];
+            }
+        };
+
+        struct sinc_filtering {};
+
+
+        // The edge modes map a frame outside the channel into it with the functions of c74_min_limit.h.
+
+        struct clamping {
+            static long apply(const long frame, const long size) {
+                return limit::clamp<long>::apply(frame, 0, size - 1);
+            }
+        };
+
+        struct wrapping {
+            static long apply(const long frame, const long size) {
+                return limit::wrap<long>::apply(frame, 0, size);
+            }
+        };
+
+        struct folding {
+            static long apply(const long frame, const long size) {
+                return size > 1 ? limit::fold<long>::apply(frame, 0, size - 1) : 0;
+            }
+        };
+
+
+        // The frame at or before a position. std::floor() is a library call on targets without SSE4.1.
+
+        static long frame_before(const double position) {
+            const auto whole = static_cast<long>(position);
+            return whole - (position < whole ? 1 : 0);
+        }
+
+
+        // Load consecutive frames, mapping them into the channel only when some are outside it.
+
+        template<class edge>
+        void gather(sample* x, const long first, const long count) const {
+            const auto size = static_cast<long>(m_channel.size());
+
+            if (first >= 0 && first + count <= size) {
+                for (auto tap = 0; tap < count; ++tap)
+                    x[tap] = m_channel[static_cast<size_t>(first + tap)];
+            }
+            else {
+                for (auto tap = 0; tap < count; ++tap)
+                    x[tap] = m_channel[static_cast<size_t>(edge::apply(first + tap, size))];
+            }
+        }
+
+        template<class interpolator>
+        sample read_sample(const double position) const {
+            switch (m_edge) {
+                case buffer_edge::clamp:    return read_sample<interpolator, clamping>(position);
+                case buffer_edge::wrap:     return read_sample<interpolator, wrapping>(position);
+                case buffer_edge::fold:     return read_sample<interpolator, folding>(position);
+            }
+            return 0.0;
+        }
+
+        template<class interpolator, class edge>
+        typename enable_if<!std::is_same<interpolator, sinc_filtering>::value, sample>::type
+        read_sample(const double position) const {
+            const auto  whole = frame_before(position);
+            sample      x[interpolator::count];
+
+            gather<edge>(x, whole + interpolator::first, interpolator::count);
+            return interpolator::interpolate(x, position - whole);
+        }
+
+        // The sample under the first tap of the filter is half its length before the position.
+
+        template<class interpolator, class edge>
+        typename enable_if<std::is_same<interpolator, sinc_filtering>::value, sample>::type
+        read_sample(const double position) const {
+            const auto      whole   = frame_before(position);
+            const auto      phase   = (position - whole) * resampler::k_phase_count;
+            const auto      row     = static_cast<size_t>(phase);
+            const auto      half    = static_cast<long>(m_sinc_table->half_length);
+            sample          x[4 * k_sinc_quality];
+
+            gather<edge>(x, whole + 1 - half, 2 * half);
+            return m_sinc_table->filter(x, row, phase - row);
+        }
+
+
+        // Read a vector with an interpolator.
+
+        template<class interpolator>
+        void read_vector(sample* destination, const sample* positions, const long frame_count) const {
+            switch (m_edge) {
+                case buffer_edge::clamp:    read_vector<interpolator, clamping>(destination, positions, frame_count); break;
+                case buffer_edge::wrap:     read_vector<interpolator, wrapping>(destination, positions, frame_count); break;
+                case buffer_edge::fold:     read_vector<interpolator, folding>(destination, positions, frame_count); break;
+            }
+        }
+
+        // When every position of the vector is far enough inside the channel the loads need no edge handling,
+        // which leaves a loop without branches that the compiler can vectorize with gather instructions where the target has them.
+        // NaN positions fail the comparisons and so are read with the edge handling.
+
+        template<class interpolator, class edge>
+        void read_vector(sample* destination, const sample* positions, const long frame_count) const {
+            const auto  size    = static_cast<long>(m_channel.size());
+            const auto  low     = static_cast<double>(-interpolator::first);
+            const auto  high    = static_cast<double>(size - interpolator::count - interpolator::first + 1);
+            bool        inside  = true;
+
+            for (auto i = 0; i < frame_count; ++i)
+                inside &= (positions[i] >= low) & (positions[i] < high);
+
+            if (inside) {
+                const auto data     = m_channel.data();
+                const auto stride   = static_cast<long>(m_channel.stride());
+
+                for (auto i = 0; i < frame_count; ++i) {
+                    const auto  position    = positions[i];
+                    const auto  whole       = static_cast<long>(position);    // not negative, so this is the frame before
+                    const auto  first       = data + (whole + interpolator::first) * stride;
+                    sample      x[interpolator::count];
+
+                    for (auto tap = 0; tap < interpolator::count; ++tap)
+                        x[tap] = first[tap * stride];
+                    destination[i] = interpolator::interpolate(x, position - whole);
+                }
+            }
+            else {
+                for (auto i = 0; i < frame_count; ++i)
+                    destination[i] = read_sample<interpolator, edge>(positions[i]);
+            }
+        }
+    };
+
+
+    template<class T>
+    const resampler::table* const buffer_reader::sinc_table<T>::s_table = resampler::cached_table(buffer_reader::k_sinc_quality, 0);
+
+
     /// A lock guard and accessor for buffer~ access.
     ///	@tparam	audio_thread_access	Make this true if you will access the buffer~ from the audio thread.
     ///								Otherwise make this false for access on other threads.
@@ -194,19 +555,21 @@ namespace c74::min {
 
 
         /// Determine the length of the buffer~ in samples.
+        /// This is read once when the buffer~ is locked.
         ///	@return	The length of the buffer~ in samples.
         /// @see	length_in_seconds()
 
         size_t frame_count() const {
-            return max::buffer_getframecount(m_buffer_obj);
+            return m_frame_count;
         }
 
 
         /// Determine the number of channels in the buffer~.
+        /// This is read once when the buffer~ is locked.
         ///	@return	The number of channels in the buffer~.
 
         size_t channel_count() const {
-            return max::buffer_getchannelcount(m_buffer_obj);
+            return m_channel_count;
         }
 
 
@@ -227,26 +590,99 @@ namespace c74::min {
         ///	@return			A reference to the sample data for reading and/or writing.
 
         float& lookup(size_t frame, size_t channel = 0) {
-            if (frame >= frame_count())
-                frame = frame_count() - 1;
+            if (frame >= m_frame_count)
+                frame = m_frame_count - 1;
 
             auto index = frame;
 
-            if (channel_count() > 1)
-                index = index * channel_count() + channel;
+            if (m_channel_count > 1)
+                index = index * m_channel_count + channel;
 
             return m_tab[index];
         }
 
 
+        /// Read or write the value of a specified sample in the buffer without limiting the frame.
+        /// @param frame	The frame from which to fetch the sample reference, which must be less than frame_count().
+        /// @param channel	The channel from which to fetch the sample reference, which must be less than channel_count().
+        ///	@return			A reference to the sample data for reading and/or writing.
+        /// @see			lookup()
+
+        float& lookup_unchecked(const size_t frame, const size_t channel = 0) {
+            return m_tab[frame * m_channel_count + channel];
+        }
+
+
+        /// Get a view of the samples of one channel.
+        /// @param channel	The channel, which is limited to the last channel of the buffer~.
+        ///	@return			A view of the channel, which is empty if the buffer~ is not valid().
+
+        buffer_channel channel(const size_t channel) {
+            if (!m_tab || m_channel_count == 0)
+                return { nullptr, 1, 0 };
+            return { m_tab + std::min(channel, m_channel_count - 1), m_channel_count, m_frame_count };
+        }
+
+
+        /// Get a reader that interpolates between the frames of one channel.
+        /// @param channel			The channel, which is limited to the last channel of the buffer~.
+        /// @param interpolation	The method of interpolation.
+        /// @param edge				How positions before the first frame or after the last frame are treated.
+        ///	@return					The reader, which reads silence if the buffer~ is not valid().
+
+        buffer_reader reader(const size_t channel, const buffer_interpolation interpolation = buffer_interpolation::linear, const buffer_edge edge = buffer_edge::clamp) {
+            return { this->channel(channel), interpolation, edge };
+        }
+
+
+        /// Get the interleaved samples of all channels.
+        ///	@return	A pointer to the first sample, or nullptr if the buffer~ is not valid().
+
+        float* data() {
+            return m_tab;
+        }
+
+
+        /// Copy a range of frames of all channels into a separate vector for each channel,
+        /// e.g. to process each channel with contiguous vector loops rather than with lookup().
+        /// @param destination	Storage for each channel: channel_count() pointers to at least frame_count samples.
+        /// @param first_frame	The first frame to copy.
+        /// @param frame_count	The number of frames, which is limited to the frames from first_frame to the end of the buffer~.
+        ///	@return				The number of frames copied, which is zero if the buffer~ is not valid().
+        /// @see				simd::deinterleave()
+
+        long deinterleave(sample* const* destination, const size_t first_frame, const long frame_count) const {
+            const auto count = frames_from(first_frame, frame_count);
+
+            if (count > 0)
+                simd::deinterleave(destination, m_tab + first_frame * m_channel_count, m_channel_count, count);
+            return count;
+        }
+
+
+        /// Write a range of frames of all channels from a separate vector for each channel.
+        /// Call dirty() afterwards to let other objects know that the buffer~ has changed.
+        /// @param source		The samples of each channel: channel_count() pointers to at least frame_count samples.
+        /// @param first_frame	The first frame to write.
+        /// @param frame_count	The number of frames, which is limited to the frames from first_frame to the end of the buffer~.
+        ///	@return				The number of frames written, which is zero if the buffer~ is not valid().
+        /// @see				simd::interleave()
+
+        long interleave(const sample* const* source, const size_t first_frame, const long frame_count) {
+            const auto count = frames_from(first_frame, frame_count);
+
+            if (count > 0)
+                simd::interleave(m_tab + first_frame * m_channel_count, source, m_channel_count, count);
+            return count;
+        }
+
+
         /// Determine the sample rate of the buffer~ contents.
+        /// This is read once when the buffer~ is locked.
         /// @return	The buffer~ sample rate.
 
         double samplerate() const {
-            max::t_buffer_info info;
-
-            max::buffer_getinfo(m_buffer_obj, &info);
-            return info.b_sr;
+            return m_samplerate;
         }
 
 
@@ -275,6 +711,7 @@ namespace c74::min {
         template<bool U = audio_thread_access, typename enable_if<U == false, int>::type = 0>
         void resize(double length_in_ms) {
             max::object_attr_setfloat(m_buffer_obj, k_sym_size, length_in_ms);
+            update_info();
         }
 
 
@@ -286,12 +723,43 @@ namespace c74::min {
         void resize_in_samples(int length_in_samples) {
             max::t_atom_long newsize = length_in_samples;
             max::object_method(static_cast<max::t_object*>(m_buffer_obj), max::gensym("sizeinsamps"), (void*)newsize, 0);
+            update_info();
         }
 
     private:
         buffer_reference&  m_buffer_ref;
-        max::t_buffer_obj* m_buffer_obj { nullptr };
-        float*             m_tab        { nullptr };
+        max::t_buffer_obj* m_buffer_obj     { nullptr };
+        float*             m_tab            { nullptr };
+        size_t             m_frame_count    { 0 };
+        size_t             m_channel_count  { 0 };
+        double             m_samplerate     { 0.0 };
+
+
+        // Read the properties of the buffer~ once rather than calling the Max API for every access.
+        // When editing, the samples may also have moved if the buffer~ has been resized.
+
+        void update_info() {
+            max::t_buffer_info info;
+
+            if (!m_buffer_obj)
+                return;
+
+            max::buffer_getinfo(m_buffer_obj, &info);
+            m_frame_count   = static_cast<size_t>(info.b_frames);
+            m_channel_count = static_cast<size_t>(info.b_nchans);
+            m_samplerate    = info.b_sr;
+            if (!audio_thread_access)
+                m_tab = info.b_samples;
+        }
+
+
+        // Limit a range of frames to the end of the buffer~.
+
+        long frames_from(const size_t first_frame, const long frame_count) const {
+            if (!m_tab || m_channel_count == 0 || first_frame >= m_frame_count || frame_count <= 0)
+                return 0;
+            return static_cast<long>(std::min(static_cast<size_t>(frame_count), m_frame_count - first_frame));
+        }
     };
 
 }    // namespace c74::min
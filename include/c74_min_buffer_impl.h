@@ -11,34 +11,75 @@ namespace c74::min {
 
 
     template<>
-    buffer_lock<true>::buffer_lock(buffer_reference& a_buffer_ref)
+    inline buffer_lock<true>::buffer_lock(buffer_reference& a_buffer_ref)
     : m_buffer_ref { a_buffer_ref } {
         m_buffer_obj = buffer_ref_getobject(m_buffer_ref.m_instance);
         m_tab        = buffer_locksamples(m_buffer_obj);
         // TODO: handle case where tab is null -- can't throw an exception in audio code...
+        if (m_tab)
+            update_info();
     }
 
     template<>
-    buffer_lock<false>::buffer_lock(buffer_reference& a_buffer_ref)
+    inline buffer_lock<false>::buffer_lock(buffer_reference& a_buffer_ref)
     : m_buffer_ref { a_buffer_ref } {
-        max::t_buffer_info info;
-
         m_buffer_obj = buffer_ref_getobject(m_buffer_ref.m_instance);
         buffer_edit_begin(m_buffer_obj);
-        buffer_getinfo(m_buffer_obj, &info);
-        m_tab = info.b_samples;
+        update_info();
     }
 
 
     template<>
-    buffer_lock<true>::~buffer_lock() {
+    inline buffer_lock<true>::~buffer_lock() {
         if (m_tab)
             buffer_unlocksamples(m_buffer_obj);
     }
 
     template<>
-    buffer_lock<false>::~buffer_lock() {
+    inline buffer_lock<false>::~buffer_lock() {
         buffer_edit_end(m_buffer_obj, true);
     }
 
+
+    // implemented out-of-line because it must follow the specializations of buffer_lock<>
+    // the samples are only read, so they are locked as for the audio thread rather than edited,
+    // which would mark the buffer~ as modified and call us again
+
+    inline void convolver::load(buffer_reference& a_buffer, const size_t a_channel) {
+        if (!a_buffer) {
+            load<float>(nullptr, 0);
+            return;
+        }
+
+        buffer_lock<true> b { a_buffer };
+
+        if (!b.valid() || b.frame_count() == 0) {
+            load<float>(nullptr, 0);
+            return;
+        }
+        load(&b[0], b.frame_count(), b.channel_count(), std::min(a_channel, b.channel_count() - 1));
+    }
+
+
+    // implemented out-of-line for the same reason, and locked for reading in the same way
+    // buffer_locksamples() fails while the buffer~ is being edited, in which case no copy is made
+
+    inline unique_ptr<buffer_snapshot::contents> buffer_snapshot::copy(buffer_reference& a_buffer) {
+        if (!a_buffer)
+            return std::make_unique<contents>();
+
+        buffer_lock<true> b { a_buffer };
+
+        if (!b.valid())
+            return nullptr;
+
+        auto result = std::make_unique<contents>();
+
+        result->m_samples.assign(b.data(), b.data() + b.frame_count() * b.channel_count());
+        result->m_frame_count   = b.frame_count();
+        result->m_channel_count = b.channel_count();
+        result->m_samplerate    = b.samplerate();
+        return result;
+    }
+
 }    // namespace c74::min
@@ -0,0 +1,272 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A copy of the samples of a buffer~ that the audio thread may read while the buffer~ itself is being rewritten.
+    ///
+    /// A buffer_lock<> reads the buffer~ in place, so an audio thread that reads a buffer~ while another thread
+    /// is loading or normalizing it hears a mix of the old and new samples.
+    /// Instead, a buffer_snapshot copies the buffer~ on the background_thread each time update() is called
+    /// and then hands the copy to the audio thread without locking.
+    /// The audio thread takes the newest copy at the start of each vector with acquire(),
+    /// and keeps reading the copy it has until then, so it never sees a copy that is incomplete.
+    /// The copy that is replaced is freed on the background_thread, which the audio thread wakes when it takes a copy.
+    /// Memory is never allocated or freed on the audio thread.
+    /// @code
+    /// buffer_reference sound { this,
+    ///     MIN_FUNCTION {
+    ///         if (args[0] == k_sym_binding || args[0] == k_sym_modified)
+    ///             snapshot.update(sound);
+    ///         return {};
+    ///     }
+    /// };
+    ///
+    /// buffer_snapshot snapshot;
+    ///
+    /// void operator()(audio_bundle input, audio_bundle output) {
+    ///     auto& contents = snapshot.acquire();
+    ///     contents.reader(0, buffer_interpolation::cubic).read(output.samples(0), input.samples(0), input.frame_count());
+    /// }
+    /// @endcode
+    /// @ingroup buffers
+
+    class buffer_snapshot : private background_thread::client {
+    public:
+        /// The samples of a buffer~ at the time it was copied, which never change.
+
+        class contents {
+        public:
+            /// Determine if the copy has any samples.
+            /// @return	True if there is at least one frame.
+
+            bool valid() const {
+                return m_frame_count > 0 && m_channel_count > 0;
+            }
+
+
+            /// Return the number of frames that were copied.
+            /// @return	The number of frames.
+
+            size_t frame_count() const {
+                return m_frame_count;
+            }
+
+
+            /// Return the number of channels that were copied.
+            /// @return	The number of channels.
+
+            size_t channel_count() const {
+                return m_channel_count;
+            }
+
+
+            /// Return the sample rate of the buffer~ when it was copied.
+            /// @return	The sample rate.
+
+            double samplerate() const {
+                return m_samplerate;
+            }
+
+
+            /// Read a sample.
+            /// @param frame	The frame, which is limited to the last frame.
+            /// @param channel	The channel, which must be less than channel_count().
+            ///	@return			The sample, which must not be read if the copy is not valid().
+
+            float lookup(const size_t frame, const size_t channel = 0) const {
+                return m_samples[std::min(frame, m_frame_count - 1) * m_channel_count + channel];
+            }
+
+
+            /// Get the interleaved samples of all channels.
+            ///	@return	A pointer to the first sample, which is nullptr if the copy is not valid().
+
+            const float* data() const {
+                return m_samples.empty() ? nullptr : m_samples.data();
+            }
+
+
+            /// Get a reader that interpolates between the frames of one channel.
+            /// @param channel			The channel, which is limited to the last channel.
+            /// @param interpolation	The method of interpolation.
+            /// @param edge				How positions before the first frame or after the last frame are treated.
+            ///	@return					The reader, which reads silence if the copy is not valid().
+
+            buffer_reader reader(const size_t channel, const buffer_interpolation interpolation = buffer_interpolation::linear, const buffer_edge edge = buffer_edge::clamp) const {
+                if (!valid())
+                    return { buffer_channel { nullptr, 1, 0 }, interpolation, edge };
+
+                // the reader only reads, so the samples are not written through the channel
+                const auto first = const_cast<float*>(m_samples.data()) + std::min(channel, m_channel_count - 1);
+                return { buffer_channel { first, m_channel_count, m_frame_count }, interpolation, edge };
+            }
+
+        private:
+            friend class buffer_snapshot;
+
+            vector<float>   m_samples;
+            size_t          m_frame_count { 0 };
+            size_t          m_channel_count { 0 };
+            double          m_samplerate { 0.0 };
+        };
+
+
+        buffer_snapshot() {
+            background_thread::shared().add(this);
+        }
+
+        buffer_snapshot(const buffer_snapshot& other) = delete;
+        buffer_snapshot& operator=(const buffer_snapshot& other) = delete;
+
+
+        /// Wait for any copy being made on the background_thread and free the copies.
+        /// The audio thread must no longer be processing.
+
+        ~buffer_snapshot() {
+            background_thread::shared().remove(this);
+
+            delete m_active;
+            delete m_published.load();
+            delete m_released.load();
+        }
+
+
+        /// Copy a buffer~ on the background_thread.
+        /// Call this from the notification function of your buffer_reference when it receives k_sym_binding or k_sym_modified.
+        /// If the buffer~ is being edited when it is copied, the copy is skipped and the next k_sym_modified brings it up to date.
+        /// Must not be called from the audio thread.
+        /// @param	a_buffer	The buffer~ to copy, which must exist until the copy has been made or the snapshot is destroyed.
+
+        void update(buffer_reference& a_buffer) {
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_request_buffer    = &a_buffer;
+                m_request_samples.reset();
+            }
+            background_thread::shared().request();
+        }
+
+
+        /// Replace the samples with a copy of some in memory, e.g. from a file.
+        /// The samples are copied immediately and handed to the audio thread by the background_thread.
+        /// Must not be called from the audio thread.
+        /// @param	samples			The interleaved samples. May be nullptr if frame_count is 0, which makes the copy empty.
+        /// @param	frame_count		The number of frames.
+        /// @param	channel_count	The number of interleaved channels.
+        /// @param	samplerate		The sample rate of the samples.
+
+        void update(const float* samples, const size_t frame_count, const size_t channel_count = 1, const double samplerate = 0.0) {
+            auto result = std::make_unique<contents>();
+
+            result->m_samples.assign(samples, samples + frame_count * channel_count);
+            result->m_frame_count   = frame_count;
+            result->m_channel_count = channel_count;
+            result->m_samplerate    = samplerate;
+
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_request_buffer    = nullptr;
+                m_request_samples   = std::move(result);
+            }
+            background_thread::shared().request();
+        }
+
+
+        /// Determine if a copy is still being made.
+        /// When this returns false the copy most recently requested is taken by the audio thread at its next acquire(),
+        /// or the one after if the copy it replaces has not yet been freed.
+        /// @return	True if a copy is pending.
+
+        bool updating() const {
+            std::lock_guard<std::mutex> lock { m_mutex };
+            return m_request_buffer || m_request_samples || m_copying;
+        }
+
+
+        /// Take the newest copy.
+        /// Must only be called from the audio thread, once at the start of each vector.
+        /// @return	The copy, which remains unchanged and valid until acquire() is next called.
+        ///			Other threads of the audio thread, e.g. of a worker_pool, may read it until then.
+
+        const contents& acquire() {
+            // a new copy is only taken once the previous one has been freed, so there is never more than one to free
+            if (m_released.load(std::memory_order_acquire) == nullptr) {
+                if (auto next = m_published.exchange(nullptr, std::memory_order_acq_rel)) {
+                    m_released.store(m_active, std::memory_order_release);
+                    m_active = next;
+                    background_thread::shared().wake();
+                }
+            }
+            return m_active ? *m_active : m_empty;
+        }
+
+    private:
+        // used only by the audio thread
+
+        contents*                   m_active { nullptr };
+        const contents              m_empty {};
+
+        // shared by the audio thread and the background_thread
+
+        std::atomic<contents*>      m_published { nullptr };       // ready to be used by the audio thread
+        std::atomic<contents*>      m_released { nullptr };        // no longer used by the audio thread, to be freed
+
+        // used by the background_thread and, under the mutex, by the thread that requests copies
+
+        mutable std::mutex          m_mutex;
+        buffer_reference*           m_request_buffer { nullptr };
+        unique_ptr<contents>        m_request_samples;
+        bool                        m_copying { false };
+
+
+        // Called on the background_thread to free the copy the audio thread has replaced and to make any copy requested.
+        // Until the audio thread takes a new copy and wakes the thread, it is only called again in case that wake is missed.
+
+        std::chrono::microseconds service() override {
+            std::unique_lock<std::mutex> lock { m_mutex };
+
+            delete m_released.exchange(nullptr, std::memory_order_acquire);
+
+            if (m_request_buffer || m_request_samples) {
+                auto buffer     = m_request_buffer;
+                auto samples    = std::move(m_request_samples);
+
+                m_request_buffer    = nullptr;
+                m_copying           = true;
+                lock.unlock();
+
+                if (buffer)
+                    samples = copy(*buffer);
+                if (samples)
+                    publish(samples.release());
+
+                lock.lock();
+                m_copying = false;
+            }
+
+            if (m_published.load(std::memory_order_acquire) || m_released.load(std::memory_order_acquire))
+                return background_thread::k_missed_wake_time;
+            return {};
+        }
+
+
+        // Copy the samples of a buffer~, or return nullptr if they cannot be locked.
+
+        static unique_ptr<contents> copy(buffer_reference& a_buffer);
+
+
+        // Hand a new copy to the audio thread.
+        // A copy that was published earlier but not yet taken by the audio thread is never used and is freed.
+
+        void publish(contents* a_contents) {
+            delete m_published.exchange(a_contents, std::memory_order_acq_rel);
+        }
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,234 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// An attribute of an object that forwards to an attribute of another object embedded within it.
+    /// The alias takes its type, range, style, and other properties from the target
+    /// but is registered with the owner under a name of its own.
+    /// This is used by chain<> to expose the attributes of its operators.
+    /// @ingroup attributes
+
+    class attribute_alias : public attribute_base {
+    public:
+        /// Create an alias.
+        /// @param	an_owner	The object to which the alias is added. Typically you will pass `this`.
+        /// @param	a_name		The name of the alias.
+        /// @param	a_target	The attribute that is read and written through the alias.
+
+        attribute_alias(object_base* an_owner, const std::string& a_name, attribute_base& a_target)
+        : attribute_base { *an_owner, a_name }
+        , m_target { a_target } {
+            m_owner.attributes()[a_name] = this;
+
+            m_title         = a_target.label_string();
+            m_datatype      = a_target.datatype();
+            m_readonly      = !a_target.writable();
+            m_visibility    = a_target.visible();
+            m_description   = description { a_target.description_string().c_str() };
+            m_style         = a_target.editor_style();
+            m_category      = a_target.editor_category();
+            m_order         = a_target.editor_order();
+        }
+
+
+        /// Get the attribute to which the alias forwards.
+        /// @return	The target attribute.
+
+        attribute_base& target() const {
+            return m_target;
+        }
+
+
+        attribute_base& operator=(const atoms& args) override {
+            set(args);
+            return *this;
+        }
+
+
+        // The target is always set directly because its owner is not known to Max.
+        // Notification is instead made by setting the alias through the Max API of the owner.
+
+        void set(const atoms& args, const bool notify = true, const bool override_readonly = false) override {
+#ifndef MIN_TEST    // At this time the Mock Kernel does not implement object_attr_setvalueof(), so we can't use it for unit tests
+            if (notify && this_class && m_owner.maxobj()) {
+                max::object_attr_setvalueof(m_owner, m_name, static_cast<long>(args.size()), (c74::max::t_atom*)&args[0]);
+                return;
+            }
+#endif    // !MIN_TEST
+            m_target.set(args, false, override_readonly);
+        }
+
+
+        operator atoms() const override {
+            return m_target;
+        }
+
+
+        std::string range_string() const override {
+            return m_target.range_string();
+        }
+
+
+        string default_string() const override {
+            return m_target.default_string();
+        }
+
+
+        void create(max::t_class* c, const max::method getter, const max::method setter, const bool isjitclass = 0) override {
+            long attr_flags {};
+            if (visible() == visibility::hide)
+                attr_flags |= max::ATTR_SET_OPAQUE_USER;
+
+            auto max_attr = max::attr_offset_new(m_name, datatype(), static_cast<long>(flags(isjitclass)) | attr_flags, getter, setter, 0);
+            max::class_addattr(c, max_attr);
+
+            if (visible() == visibility::hide)
+                max::class_attr_addattr_parse(c, m_name.c_str(), "invisible", c74::max::gensym("long"), 1, "1");
+        }
+
+    private:
+        attribute_base& m_target;
+    };
+
+
+    /// Compose several sample_operator<1,1> classes into a single audio operator.
+    ///
+    /// Each operator is embedded in the chain and the call operator of the chain passes a sample through all of them in turn.
+    /// This keeps the intermediate samples in registers, where a patch of separate objects would make a round trip through
+    /// a signal vector in memory for each one.
+    /// The attributes of each operator are exposed by the owner of the chain with a prefix, e.g. a "gain" attribute of an
+    /// operator with the prefix "in" becomes the "in_gain" attribute.
+    /// @code
+    /// class strip : public object<strip>, public sample_operator<1, 1> {
+    /// public:
+    ///     inlet<>     in      { this, "(signal) input" };
+    ///     outlet<>    out     { this, "(signal) output", "signal" };
+    ///
+    ///     chain<gain, dcblocker, clipper> m_chain { this, { "in", "dc", "clip" } };
+    ///
+    ///     message<> dspsetup { this, "dspsetup",
+    ///         MIN_FUNCTION {
+    ///             m_chain.dspsetup(args[0], args[1]);
+    ///             return {};
+    ///         }
+    ///     };
+    ///
+    ///     sample operator()(sample input) {
+    ///         return m_chain(input);
+    ///     }
+    /// };
+    /// @endcode
+    ///
+    /// Only attributes are exposed: messages, inlets, and outlets of the operators are not.
+    /// @tparam	operator_types	The sample_operator<1,1> classes, in the order in which samples pass through them.
+
+    template<class... operator_types>
+    class chain {
+        static_assert(sizeof...(operator_types) > 0, "a chain must contain at least one operator");
+        static_assert((is_base_of<sample_operator<1, 1>, operator_types>::value && ...), "chain only supports sample_operator<1,1> classes");
+
+    public:
+        /// The number of operators in the chain.
+
+        static constexpr size_t k_operator_count = sizeof...(operator_types);
+
+
+        /// Create a chain and expose the attributes of its operators.
+        /// @param	an_owner	The object that exposes the attributes of the operators. Typically you will pass `this`.
+        /// @param	prefixes	The prefix for the attributes of each operator.
+        ///						If a prefix is empty the attributes of that operator are exposed with their own names.
+
+        chain(object_base* an_owner, const std::array<std::string, k_operator_count>& prefixes) {
+            expose(an_owner, prefixes, detail::gen_seq<k_operator_count>());
+        }
+
+        chain(const chain& other) = delete;
+        chain& operator=(const chain& other) = delete;
+
+
+        /// Process a sample through all operators of the chain.
+        /// @param	input	The input sample.
+        /// @return			The output of the last operator.
+
+        sample operator()(sample input) {
+            return process(input, detail::gen_seq<k_operator_count>());
+        }
+
+
+        /// Update all operators of the chain for a new samplerate and vector size.
+        /// Operators that have a "dspsetup" message receive it.
+        /// You should call this from the dspsetup message of the owning class.
+        /// @param	a_samplerate	The samplerate of the signal chain.
+        /// @param	a_vector_size	The vector size of the signal chain.
+
+        void dspsetup(const double a_samplerate, const int a_vector_size) {
+            dspsetup(a_samplerate, a_vector_size, detail::gen_seq<k_operator_count>());
+        }
+
+
+        /// Get one of the operators of the chain.
+        /// @tparam	index	The position of the operator in the chain.
+        /// @return			A reference to the operator.
+
+        template<size_t index>
+        auto& get() {
+            return std::get<index>(m_operators);
+        }
+
+    private:
+        std::tuple<operator_types...>               m_operators;
+        vector<std::unique_ptr<attribute_alias>>    m_aliases;
+
+
+        template<int... Is>
+        sample process(sample x, detail::seq<Is...>) {
+            ((x = std::get<Is>(m_operators)(x)), ...);
+            return x;
+        }
+
+
+        template<int... Is>
+        void expose(object_base* an_owner, const std::array<std::string, k_operator_count>& prefixes, detail::seq<Is...>) {
+            (expose_operator(an_owner, prefixes[Is], std::get<Is>(m_operators)), ...);
+        }
+
+        void expose_operator(object_base* an_owner, const std::string& prefix, object_base& an_operator) {
+            for (auto& an_attribute : an_operator.attributes()) {
+                const auto name = prefix.empty() ? an_attribute.first : prefix + "_" + an_attribute.first;
+                m_aliases.push_back(std::make_unique<attribute_alias>(an_owner, name, *an_attribute.second));
+            }
+        }
+
+
+        template<int... Is>
+        void dspsetup(const double a_samplerate, const int a_vector_size, detail::seq<Is...>) {
+            (dspsetup_operator(std::get<Is>(m_operators), a_samplerate, a_vector_size), ...);
+        }
+
+        template<class operator_type>
+        static typename enable_if<has_dspsetup<operator_type>::value || has_m_dspsetup<operator_type>::value>::type
+        dspsetup_operator(operator_type& an_operator, const double a_samplerate, const int a_vector_size) {
+            an_operator.samplerate(a_samplerate);
+            an_operator.vector_size(a_vector_size);
+
+            atoms args;
+            args.push_back(atom(a_samplerate));
+            args.push_back(atom(max::t_atom_long(a_vector_size)));
+            an_operator.dspsetup(args);
+        }
+
+        template<class operator_type>
+        static typename enable_if<!has_dspsetup<operator_type>::value && !has_m_dspsetup<operator_type>::value>::type
+        dspsetup_operator(operator_type& an_operator, const double a_samplerate, const int a_vector_size) {
+            an_operator.samplerate(a_samplerate);
+            an_operator.vector_size(a_vector_size);
+        }
+    };
+
+}    // namespace c74::min
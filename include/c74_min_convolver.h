@@ -0,0 +1,432 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Convolve a signal with an impulse response, e.g. for a reverb, using uniformly partitioned FFT convolution.
+    ///
+    /// The impulse response is split into partitions of partition_size() samples and the spectrum of each partition is stored.
+    /// While a block of input is being collected, the later partitions are multiplied with the spectra of the earlier input
+    /// a little at a time in each vector.
+    /// When the block is complete, only its own spectrum remains to be multiplied with the first partition and transformed back.
+    /// So with vectors smaller than a partition the cost is spread evenly across them rather than falling on every few vectors.
+    /// It grows only linearly with the length of the impulse response.
+    /// The exception is the block in which a new impulse response is taken, which convolves it completely to crossfade to it.
+    /// The output is delayed by latency() samples, which is the partition size.
+    ///
+    /// Impulse responses are loaded from a buffer~ or from memory.
+    /// Their partitions are computed on the background_thread and then handed to the audio thread without locking.
+    /// The audio thread crossfades from the old to the new impulse response over a single partition so that there is no click.
+    /// The spectra of earlier input are kept when a longer impulse response is loaded, but only as far back as
+    /// the longest impulse response loaded before, so the part of the new tail beyond that fills in over time.
+    /// Memory is never allocated or freed on the audio thread.
+    /// @code
+    /// buffer_reference ir { this,
+    ///     MIN_FUNCTION {
+    ///         if (args[0] == k_sym_binding || args[0] == k_sym_modified)
+    ///             reverb.load(ir);
+    ///         return {};
+    ///     }
+    /// };
+    ///
+    /// convolver reverb { 256 };
+    ///
+    /// void operator()(audio_bundle input, audio_bundle output) {
+    ///     reverb.process(input.samples(0), output.samples(0), input.frame_count());
+    /// }
+    /// @endcode
+    /// @ingroup buffers
+
+    class convolver : private background_thread::client {
+    public:
+        /// Create a convolver with an empty impulse response, which outputs silence.
+        /// @param	a_partition_size	The number of samples in each partition of the impulse response.
+        ///								Must be a power of two no smaller than 2.
+        ///								Smaller partitions reduce the latency but increase the cost.
+
+        explicit convolver(const size_t a_partition_size = 256)
+        : m_partition_size { a_partition_size }
+        , m_bin_count { a_partition_size + 1 }
+        , m_fft { 2 * a_partition_size } {
+            assert(a_partition_size >= 2 && (a_partition_size & (a_partition_size - 1)) == 0);
+
+            m_frame.assign(2 * m_partition_size, 0.0);
+            m_time.assign(2 * m_partition_size, 0.0);
+            m_output.assign(m_partition_size, 0.0);
+            m_crossfade.assign(m_partition_size, 0.0);
+            m_spectrum.assign(m_bin_count, {});
+            m_accumulated_real.assign(m_bin_count, 0.0);
+            m_accumulated_imaginary.assign(m_bin_count, 0.0);
+            m_history_real.assign(m_bin_count, 0.0);
+            m_history_imaginary.assign(m_bin_count, 0.0);
+
+            background_thread::shared().add(this);
+        }
+
+        convolver(const convolver& other) = delete;
+        convolver& operator=(const convolver& other) = delete;
+
+
+        /// Wait for any partitions being computed on the background_thread and free the impulse responses.
+        /// The audio thread must no longer be processing.
+
+        ~convolver() {
+            background_thread::shared().remove(this);
+
+            delete m_active;
+            delete m_published.load();
+            delete m_released.load();
+        }
+
+
+        /// Return the number of samples in each partition of the impulse response.
+        /// @return	The partition size.
+
+        size_t partition_size() const {
+            return m_partition_size;
+        }
+
+
+        /// Return the delay between the input and the output.
+        /// @return	The latency in samples, which is the partition size.
+
+        long latency() const {
+            return static_cast<long>(m_partition_size);
+        }
+
+
+        /// Load an impulse response from a channel of a buffer~.
+        /// The samples are copied immediately and the partitions are computed on the background_thread.
+        /// Call this from the notification function of your buffer_reference when it receives k_sym_modified.
+        /// Must not be called from the audio thread.
+        /// @param	a_buffer	The buffer~ holding the impulse response.
+        /// @param	a_channel	The channel of the buffer~ to use.
+
+        void load(buffer_reference& a_buffer, const size_t a_channel = 0);
+
+
+        /// Load an impulse response from memory.
+        /// The samples are copied immediately and the partitions are computed on the background_thread.
+        /// Must not be called from the audio thread.
+        /// @param	samples			The samples of the impulse response, interleaved if there is more than one channel.
+        ///							May be nullptr if frame_count is 0, which makes the output silent.
+        /// @param	frame_count		The number of samples in each channel.
+        /// @param	channel_count	The number of interleaved channels.
+        /// @param	a_channel		The channel to use.
+
+        template<class sample_type>
+        void load(const sample_type* samples, const size_t frame_count, const size_t channel_count = 1, const size_t a_channel = 0) {
+            assert(a_channel < channel_count || frame_count == 0);
+
+            sample_vector impulse_response(frame_count);
+            for (size_t i = 0; i < frame_count; ++i)
+                impulse_response[i] = static_cast<sample>(samples[i * channel_count + a_channel]);
+
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_request           = std::move(impulse_response);
+                m_request_pending   = true;
+            }
+            background_thread::shared().request();
+        }
+
+
+        /// Determine if an impulse response is still being prepared by the background_thread.
+        /// When this returns false the most recently loaded impulse response is used from the next partition onwards.
+        /// @return	True if the partitions of an impulse response are being computed.
+
+        bool loading() const {
+            std::lock_guard<std::mutex> lock { m_mutex };
+            return m_request_pending || m_building;
+        }
+
+
+        /// Process a vector of audio.
+        /// Must only be called from the audio thread. In-place processing is supported.
+        /// @param	input			The input samples.
+        /// @param	output			The output samples.
+        /// @param	frame_count		The number of samples to process.
+
+        void process(const sample* input, sample* output, const long frame_count) {
+            const auto  block_size  = static_cast<long>(m_partition_size);
+            long        start       = 0;
+
+            while (start < frame_count) {
+                const auto count = std::min(frame_count - start, block_size - m_position);
+
+                // the input is read before the output is written so that processing may be in-place
+                std::copy(input + start, input + start + count, m_frame.begin() + block_size + m_position);
+                std::copy(m_output.begin() + m_position, m_output.begin() + m_position + count, output + start);
+
+                start       += count;
+                m_position  += count;
+
+                accumulate_tail(tail_count() * static_cast<size_t>(m_position) / m_partition_size);
+
+                if (m_position == block_size) {
+                    m_position = 0;
+                    process_block();
+                }
+            }
+        }
+
+    private:
+        // The spectra of the partitions of an impulse response.
+        // If the delay line of input spectra of the audio thread is too short for the number of partitions,
+        // a longer one is allocated along with the partitions and replaces it.
+
+        struct partitions {
+            size_t          count { 0 };
+            sample_vector   real;                   // count * bin_count, one partition after another
+            sample_vector   imaginary;
+            sample_vector   history_real;           // empty unless replacing the delay line of the audio thread
+            sample_vector   history_imaginary;
+        };
+
+        const size_t    m_partition_size;
+        const size_t    m_bin_count;
+
+        // used only by the audio thread, allocated by the constructor
+
+        fft                             m_fft;
+        long                            m_position { 0 };       // the number of samples of the current block collected so far
+        sample_vector                   m_frame;                // the previous block of input followed by the current block
+        sample_vector                   m_time;
+        sample_vector                   m_output;               // the output for the current block
+        sample_vector                   m_crossfade;
+        vector<std::complex<sample>>    m_spectrum;
+        sample_vector                   m_accumulated_real;     // the sum of the products for the current block so far
+        sample_vector                   m_accumulated_imaginary;
+        size_t                          m_accumulated_count { 0 };   // the number of later partitions in the sum
+        sample_vector                   m_history_real;         // the delay line of the spectra of the most recent blocks of input
+        sample_vector                   m_history_imaginary;
+        size_t                          m_history_position { 0 };    // the newest spectrum in the delay line
+        partitions*                     m_active { nullptr };
+
+        // shared by the audio thread and the background_thread
+
+        std::atomic<partitions*>    m_published { nullptr };       // ready to be used by the audio thread
+        std::atomic<partitions*>    m_released { nullptr };        // no longer used by the audio thread, to be freed
+        std::atomic<size_t>         m_history_capacity { 1 };      // the number of spectra in the delay line of the audio thread
+
+        // used by the background_thread and, under the mutex, by the thread that loads impulse responses
+
+        mutable std::mutex          m_mutex;
+        sample_vector               m_request;
+        bool                        m_request_pending { false };
+        bool                        m_building { false };
+
+
+        // Called on the background_thread to free the impulse response the audio thread has replaced and to build any requested.
+        // Until the audio thread takes a new impulse response and wakes the thread, it is only called again in case that wake is missed.
+
+        std::chrono::microseconds service() override {
+            std::unique_lock<std::mutex> lock { m_mutex };
+
+            delete m_released.exchange(nullptr, std::memory_order_acquire);
+
+            if (m_request_pending) {
+                auto impulse_response = std::move(m_request);
+
+                m_request_pending   = false;
+                m_building          = true;
+                lock.unlock();
+
+                publish(build(impulse_response));
+
+                lock.lock();
+                m_building = false;
+            }
+
+            if (m_published.load(std::memory_order_acquire) || m_released.load(std::memory_order_acquire))
+                return background_thread::k_missed_wake_time;
+            return {};
+        }
+
+
+        // Compute the spectrum of each partition of an impulse response.
+
+        partitions* build(const sample_vector& impulse_response) {
+            auto        result      = new partitions;
+            const auto  bin_count   = m_bin_count;
+            auto        transform   = fft { 2 * m_partition_size };
+            auto        time        = sample_vector(2 * m_partition_size, 0.0);
+            auto        spectrum    = vector<std::complex<sample>>(bin_count);
+
+            result->count = (impulse_response.size() + m_partition_size - 1) / m_partition_size;
+            result->real.resize(result->count * bin_count);
+            result->imaginary.resize(result->count * bin_count);
+
+            for (size_t partition = 0; partition < result->count; ++partition) {
+                const auto begin    = impulse_response.begin() + partition * m_partition_size;
+                const auto end      = impulse_response.begin() + std::min(impulse_response.size(), (partition + 1) * m_partition_size);
+
+                std::fill(std::copy(begin, end, time.begin()), time.end(), 0.0);
+                transform.forward(time.data(), spectrum.data());
+
+                for (size_t bin = 0; bin < bin_count; ++bin) {
+                    result->real[partition * bin_count + bin]       = spectrum[bin].real();
+                    result->imaginary[partition * bin_count + bin]  = spectrum[bin].imag();
+                }
+            }
+
+            if (result->count > m_history_capacity.load(std::memory_order_acquire)) {
+                result->history_real.assign(result->count * bin_count, 0.0);
+                result->history_imaginary.assign(result->count * bin_count, 0.0);
+            }
+            return result;
+        }
+
+
+        // Hand new partitions to the audio thread.
+        // Partitions that were published earlier but not yet taken by the audio thread are never used and are freed.
+
+        void publish(partitions* a_partitions) {
+            delete m_published.exchange(a_partitions, std::memory_order_acq_rel);
+        }
+
+
+        // Process a complete block of input on the audio thread.
+        // The later partitions of the active impulse response have already been multiplied with the earlier input,
+        // so only the spectrum of this block remains to be added before transforming back.
+
+        void process_block() {
+            const auto block_size = m_partition_size;
+
+            m_fft.forward(m_frame.data(), m_spectrum.data());
+            accumulate_tail(tail_count());
+            push_history();
+
+            // a new impulse response is only taken once the previous one has been freed, so there is never more than one to free
+            partitions* next = nullptr;
+            if (m_released.load(std::memory_order_acquire) == nullptr)
+                next = m_published.exchange(nullptr, std::memory_order_acq_rel);
+
+            if (partition_count(m_active) > 0)
+                multiply_accumulate(m_active, 0, m_history_position);
+            transform(partition_count(m_active), m_output.data());
+
+            if (next) {
+                // a longer delay line starts with the spectra of the shorter one, newest first, so the tail of earlier input continues
+                if (!next->history_real.empty()) {
+                    const auto capacity = m_history_real.size() / m_bin_count;
+
+                    for (size_t age = 0; age < capacity; ++age) {
+                        const auto from = ((m_history_position + age) % capacity) * m_bin_count;
+                        std::copy_n(m_history_real.begin() + from, m_bin_count, next->history_real.begin() + age * m_bin_count);
+                        std::copy_n(m_history_imaginary.begin() + from, m_bin_count, next->history_imaginary.begin() + age * m_bin_count);
+                    }
+                    std::swap(m_history_real, next->history_real);
+                    std::swap(m_history_imaginary, next->history_imaginary);
+                    m_history_position = 0;
+                    m_history_capacity.store(next->count, std::memory_order_release);
+                }
+
+                for (size_t partition = 0; partition < partition_count(next); ++partition)
+                    multiply_accumulate(next, partition, m_history_position + partition);
+                transform(partition_count(next), m_crossfade.data());
+
+                for (size_t i = 0; i < block_size; ++i) {
+                    const auto gain = (i + 0.5) / block_size;
+                    m_output[i] += (m_crossfade[i] - m_output[i]) * gain;
+                }
+
+                m_released.store(m_active, std::memory_order_release);
+                m_active = next;
+                background_thread::shared().wake();
+            }
+
+            std::copy(m_frame.begin() + block_size, m_frame.end(), m_frame.begin());
+        }
+
+
+        // Add the spectrum of the current block to the delay line, replacing the oldest.
+
+        void push_history() {
+            const auto capacity = m_history_real.size() / m_bin_count;
+
+            m_history_position = (m_history_position + capacity - 1) % capacity;
+
+            auto real       = m_history_real.data() + m_history_position * m_bin_count;
+            auto imaginary  = m_history_imaginary.data() + m_history_position * m_bin_count;
+
+            for (size_t bin = 0; bin < m_bin_count; ++bin) {
+                real[bin]       = m_spectrum[bin].real();
+                imaginary[bin]  = m_spectrum[bin].imag();
+            }
+        }
+
+
+        // The number of partitions of an impulse response for which the delay line holds input.
+
+        size_t partition_count(const partitions* a_partitions) const {
+            return a_partitions ? std::min(a_partitions->count, m_history_real.size() / m_bin_count) : 0;
+        }
+
+
+        // The number of partitions of the active impulse response that are multiplied with input from before the current block.
+
+        size_t tail_count() const {
+            const auto count = partition_count(m_active);
+            return count > 0 ? count - 1 : 0;
+        }
+
+
+        // Multiply the later partitions of the active impulse response, up to the given number of them,
+        // with the spectra of the input that precedes the current block, which is still being collected.
+        // Partition 1 is multiplied with the newest spectrum in the delay line, partition 2 with the one before, etc.
+
+        void accumulate_tail(const size_t count) {
+            for (; m_accumulated_count < count; ++m_accumulated_count)
+                multiply_accumulate(m_active, m_accumulated_count + 1, m_history_position + m_accumulated_count);
+        }
+
+
+        // Add the product of a partition and a spectrum in the delay line to the sum for the current block.
+
+        void multiply_accumulate(const partitions* a_partitions, const size_t partition, const size_t history) {
+            const auto  bin_count   = m_bin_count;
+            const auto  slot        = history % (m_history_real.size() / bin_count);
+            const auto  h_real      = a_partitions->real.data() + partition * bin_count;
+            const auto  h_imag      = a_partitions->imaginary.data() + partition * bin_count;
+            const auto  x_real      = m_history_real.data() + slot * bin_count;
+            const auto  x_imag      = m_history_imaginary.data() + slot * bin_count;
+            auto        sum_real    = m_accumulated_real.data();
+            auto        sum_imag    = m_accumulated_imaginary.data();
+
+            for (size_t bin = 0; bin < bin_count; ++bin) {
+                sum_real[bin] += h_real[bin] * x_real[bin] - h_imag[bin] * x_imag[bin];
+                sum_imag[bin] += h_real[bin] * x_imag[bin] + h_imag[bin] * x_real[bin];
+            }
+        }
+
+
+        // Transform the sum for the current block back to the output and clear it for the next block.
+        // If no partitions were added the output is silent.
+
+        void transform(const size_t count, sample* output) {
+            m_accumulated_count = 0;
+
+            if (count == 0) {
+                std::fill(output, output + m_partition_size, 0.0);
+                return;
+            }
+
+            for (size_t bin = 0; bin < m_bin_count; ++bin)
+                m_spectrum[bin] = { m_accumulated_real[bin], m_accumulated_imaginary[bin] };
+
+            std::fill(m_accumulated_real.begin(), m_accumulated_real.end(), 0.0);
+            std::fill(m_accumulated_imaginary.begin(), m_accumulated_imaginary.end(), 0.0);
+
+            // overlap-save: the first half of the result is aliased and discarded
+            m_fft.inverse(m_spectrum.data(), m_time.data());
+            std::copy(m_time.begin() + m_partition_size, m_time.end(), output);
+        }
+    };
+
+}    // namespace c74::min
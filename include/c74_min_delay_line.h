@@ -0,0 +1,365 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The methods for reading from a delay_line<> between samples.
+
+    enum class delay_interpolation {
+        none,        ///< Truncate the delay to a whole number of samples.
+        linear,      ///< Straight line between the two nearest samples.
+        cubic,       ///< Cubic Hermite (Catmull-Rom) spline through the four nearest samples.
+        allpass,     ///< First-order allpass filter, which is flat in magnitude. Only for delays that change slowly.
+        lagrange     ///< Third-order Lagrange polynomial through the four nearest samples.
+    };
+
+
+    /// A circular buffer of samples that may be read at any delay up to a maximum, e.g. for a chorus, flanger, or reverb.
+    ///
+    /// The buffer is a power of two in size so that positions wrap with a mask rather than a branch or a division.
+    /// Memory is allocated only by dspsetup(), which must be called before any samples are written.
+    /// All delays are measured from the most recently written sample, so that a delay of 0 reads the sample just written.
+    ///
+    /// Delays that change for every sample, e.g. modulated by an LFO, are best read a whole vector at a time:
+    /// @code
+    /// delay_line<> m_delay { time_value { 50.0 } };    // 50 ms, or a number of samples
+    ///
+    /// message<> dspsetup { this, "dspsetup",
+    ///     MIN_FUNCTION {
+    ///         m_delay.dspsetup(args[0], args[1]);
+    ///         return {};
+    ///     }
+    /// };
+    ///
+    /// void operator()(audio_bundle input, audio_bundle output) {
+    ///     m_delay.write(input.samples(0), input.frame_count());
+    ///     m_delay.read(output.samples(0), input.samples(1), input.frame_count(), delay_interpolation::cubic);
+    /// }
+    /// @endcode
+    /// For floating-point samples the interpolation of a vector is computed with lanes<> of several delays at once.
+    ///
+    /// @tparam	T	The type of the samples, e.g. `sample`, `float`, or `lanes<4>` for four channels that share their delays.
+
+    template<class T = sample>
+    class delay_line {
+    public:
+        /// Create a delay line.
+        /// @param	max_delay	The longest delay in samples that will be read.
+
+        explicit delay_line(const size_t max_delay = 0)
+        : m_max_delay_samples { max_delay }
+        {}
+
+
+        /// Create a delay line.
+        /// @param	max_delay	The longest delay that will be read, converted to samples when dspsetup() is called.
+
+        explicit delay_line(const time_value& max_delay)
+        : m_max_delay_ms { static_cast<double>(max_delay) }
+        {}
+
+
+        /// Change the longest delay that will be read.
+        /// Takes effect when dspsetup() is next called.
+        /// @param	max_delay	The longest delay in samples.
+
+        void max_delay(const size_t max_delay) {
+            m_max_delay_samples = max_delay;
+            m_max_delay_ms      = 0.0;
+        }
+
+
+        /// Change the longest delay that will be read.
+        /// Takes effect when dspsetup() is next called.
+        /// @param	max_delay	The longest delay, converted to samples when dspsetup() is called.
+
+        void max_delay(const time_value& max_delay) {
+            m_max_delay_ms = static_cast<double>(max_delay);
+        }
+
+
+        /// Return the longest delay that may be read.
+        /// @return	The delay in samples.
+
+        size_t max_delay() const {
+            return m_max_delay;
+        }
+
+
+        /// Allocate the buffer and clear it.
+        /// Call this from the dspsetup message of your class.
+        /// @param	a_samplerate		The samplerate of the signal chain.
+        /// @param	max_frame_count		The largest number of samples that will be written or read at once.
+
+        void dspsetup(const double a_samplerate, const long max_frame_count) {
+            if (m_max_delay_ms > 0.0)
+                m_max_delay_samples = static_cast<size_t>(std::ceil(m_max_delay_ms * 0.001 * a_samplerate));
+
+            // room for the longest delay of the oldest sample in a vector and the interpolation points on either side
+            m_max_delay         = m_max_delay_samples;
+            m_max_frame_count   = std::max(1L, max_frame_count);
+            m_buffer.assign(limit_to_power_of_two(m_max_delay + static_cast<size_t>(m_max_frame_count) + 4), T {});
+            m_mask              = m_buffer.size() - 1;
+            m_write             = 0;
+            m_allpass_previous  = T {};
+        }
+
+
+        /// Return the number of samples in the buffer.
+        /// @return	A power of two larger than the longest delay.
+
+        size_t size() const {
+            return m_buffer.size();
+        }
+
+
+        /// Set all samples in the buffer to zero.
+
+        void clear() {
+            std::fill(m_buffer.begin(), m_buffer.end(), T {});
+            m_allpass_previous = T {};
+        }
+
+
+        /// Write a sample.
+        /// @param	value	The sample to write.
+
+        void write(const T& value) {
+            m_buffer[m_write] = value;
+            m_write = (m_write + 1) & m_mask;
+        }
+
+
+        /// Write a vector of samples.
+        /// @param	source			The samples to write.
+        /// @param	frame_count		The number of samples, no more than the max_frame_count given to dspsetup().
+
+        void write(const T* source, const long frame_count) {
+            const auto count    = static_cast<size_t>(frame_count);
+            const auto first    = std::min(count, m_buffer.size() - m_write);
+
+            std::copy(source, source + first, m_buffer.begin() + m_write);
+            std::copy(source + first, source + count, m_buffer.begin());
+            m_write = (m_write + count) & m_mask;
+        }
+
+
+        /// Read a sample at a whole number of samples before the most recently written sample.
+        /// @param	delay	The delay in samples, no more than max_delay().
+        /// @return			The sample.
+
+        T read(const size_t delay) const {
+            return m_buffer[(m_write - 1 - delay) & m_mask];
+        }
+
+
+        /// Read a sample between samples, before the most recently written sample.
+        /// @param	delay			The delay in samples, which is limited to the range from 0 to max_delay(),
+        ///							or from 1 for cubic and lagrange interpolation which need the sample after the delay.
+        /// @param	interpolation	The method of interpolation.
+        /// @return					The interpolated sample.
+
+        T read(const sample delay, const delay_interpolation interpolation) {
+            switch (interpolation) {
+                case delay_interpolation::none:     return read_sample<truncating>(delay, 0);
+                case delay_interpolation::linear:   return read_sample<linear_interpolating>(delay, 0);
+                case delay_interpolation::cubic:    return read_sample<cubic_interpolating>(delay, 0);
+                case delay_interpolation::lagrange: return read_sample<lagrange_interpolating>(delay, 0);
+                case delay_interpolation::allpass:  return read_allpass(delay, 0);
+            }
+            return T {};
+        }
+
+
+        /// Read a vector at a whole number of samples before the most recently written vector.
+        /// @param	destination		Storage for the samples.
+        /// @param	delay			The delay in samples, no more than max_delay().
+        /// @param	frame_count		The number of samples, which must match the number most recently written.
+
+        void read(T* destination, const size_t delay, const long frame_count) const {
+            const auto count    = static_cast<size_t>(frame_count);
+            const auto start    = (m_write - count - std::min(delay, m_max_delay)) & m_mask;
+            const auto first    = std::min(count, m_buffer.size() - start);
+
+            std::copy(m_buffer.begin() + start, m_buffer.begin() + start + first, destination);
+            std::copy(m_buffer.begin(), m_buffer.begin() + (count - first), destination + first);
+        }
+
+
+        /// Read a vector with a different delay for each sample, before the most recently written vector.
+        /// Each delay is measured from the sample of the written vector at the same position,
+        /// so a delay of 0 for every sample reads back the vector that was written.
+        /// @param	destination		Storage for the samples.
+        /// @param	delays			The delay in samples for each sample, limited as for read(sample, delay_interpolation).
+        /// @param	frame_count		The number of samples, which must match the number most recently written.
+        /// @param	interpolation	The method of interpolation.
+
+        void read(T* destination, const sample* delays, const long frame_count, const delay_interpolation interpolation) {
+            switch (interpolation) {
+                case delay_interpolation::none:     read_vector<truncating>(destination, delays, frame_count); break;
+                case delay_interpolation::linear:   read_vector<linear_interpolating>(destination, delays, frame_count); break;
+                case delay_interpolation::cubic:    read_vector<cubic_interpolating>(destination, delays, frame_count); break;
+                case delay_interpolation::lagrange: read_vector<lagrange_interpolating>(destination, delays, frame_count); break;
+                case delay_interpolation::allpass:
+                    for (auto i = 0; i < frame_count; ++i)
+                        destination[i] = read_allpass(delays[i], frame_count - 1 - i);
+                    break;
+            }
+        }
+
+    private:
+        vector<T>   m_buffer;
+        size_t      m_mask { 0 };
+        size_t      m_write { 0 };                // the position of the next sample to be written
+        size_t      m_max_delay_samples { 0 };
+        double      m_max_delay_ms { 0.0 };
+        size_t      m_max_delay { 0 };
+        long        m_max_frame_count { 1 };
+        T           m_allpass_previous {};
+
+
+        // The interpolators take the samples at consecutive delays starting from the whole part of the delay plus `first`
+        // and the fractional part of the delay. V and F are either a sample type and a sample, or a lanes<> of each.
+
+        struct truncating {
+            static constexpr int first = 0;
+            static constexpr int count = 1;
+
+            template<class V, class F>
+            static V interpolate(const V* x, const F& f) {
+                return x[0];
+            }
+        };
+
+        struct linear_interpolating {
+            static constexpr int first = 0;
+            static constexpr int count = 2;
+
+            template<class V, class F>
+            static V interpolate(const V* x, const F& f) {
+                return x[0] + (x[1] - x[0]) * f;
+            }
+        };
+
+        struct cubic_interpolating {
+            static constexpr int first = -1;
+            static constexpr int count = 4;
+
+            template<class V, class F>
+            static V interpolate(const V* x, const F& f) {
+                const V c1 = (x[2] - x[0]) * 0.5;
+                const V c2 = x[0] - x[1] * 2.5 + x[2] * 2.0 - x[3] * 0.5;
+                const V c3 = (x[3] - x[0]) * 0.5 + (x[1] - x[2]) * 1.5;
+                return ((c3 * f + c2) * f + c1) * f + x[1];
+            }
+        };
+
+        struct lagrange_interpolating {
+            static constexpr int first = -1;
+            static constexpr int count = 4;
+
+            template<class V, class F>
+            static V interpolate(const V* x, const F& f) {
+                const F fp1 = f + 1.0;
+                const F fm1 = f - 1.0;
+                const F fm2 = f - 2.0;
+                return x[0] * (f * fm1 * fm2 * (-1.0 / 6.0)) + x[1] * (fp1 * fm1 * fm2 * 0.5)
+                    + x[2] * (fp1 * f * fm2 * -0.5) + x[3] * (fp1 * f * fm1 * (1.0 / 6.0));
+            }
+        };
+
+
+        // Limit a delay to the range that can be read with an interpolator.
+
+        template<class interpolator>
+        sample limit_delay(const sample delay) const {
+            return clamp(delay, static_cast<sample>(-interpolator::first), static_cast<sample>(m_max_delay));
+        }
+
+
+        // Read a single sample with an interpolator.
+        // The delay is measured from the sample written `age` samples before the most recent one.
+
+        template<class interpolator>
+        T read_sample(const sample delay, const long age) const {
+            const auto  limited = limit_delay<interpolator>(delay);
+            const auto  whole   = static_cast<size_t>(limited);
+            const auto  start   = m_write - 1 - static_cast<size_t>(age) - whole - interpolator::first;
+            T           x[interpolator::count];
+
+            for (auto tap = 0; tap < interpolator::count; ++tap)
+                x[tap] = m_buffer[(start - tap) & m_mask];
+            return interpolator::interpolate(x, limited - whole);
+        }
+
+
+        // First-order allpass interpolation, y = x1 + eta * (x0 - y[-1]).
+        // The fractional part is kept between 0.5 and 1.5 samples where possible, which keeps the pole away from -1.
+
+        T read_allpass(const sample delay, const long age) {
+            const auto  limited     = limit_delay<truncating>(delay);
+            auto        whole       = static_cast<size_t>(limited);
+            auto        fraction    = limited - whole;
+
+            if (whole > 0 && fraction < 0.5) {
+                --whole;
+                fraction += 1.0;
+            }
+
+            const auto  start   = m_write - 1 - static_cast<size_t>(age) - whole;
+            const auto  eta     = (1.0 - fraction) / (1.0 + fraction);
+            const T     x0      = m_buffer[start & m_mask];
+            const T     x1      = m_buffer[(start - 1) & m_mask];
+
+            m_allpass_previous = x1 + (x0 - m_allpass_previous) * eta;
+            return m_allpass_previous;
+        }
+
+
+        // Read a vector with an interpolator.
+        // For floating-point samples, delays are processed in lanes so that the interpolation is vectorized
+        // and only the loads from the buffer are made one sample at a time.
+
+        template<class interpolator, class U = T>
+        typename enable_if<std::is_floating_point<U>::value>::type
+        read_vector(T* destination, const sample* delays, const long frame_count) const {
+            constexpr auto  width   = simd::k_width;
+            const auto      bulk    = simd::bulk_count(frame_count);
+            const auto      oldest  = m_write - static_cast<size_t>(frame_count) - interpolator::first;
+
+            for (auto i = 0; i < bulk; i += width) {
+                lanes<width> fraction;
+                lanes<width> x[interpolator::count];
+
+                for (auto lane = 0; lane < width; ++lane) {
+                    const auto limited  = limit_delay<interpolator>(delays[i + lane]);
+                    const auto whole    = static_cast<size_t>(limited);
+                    const auto start    = oldest + i + lane - whole;
+
+                    fraction[lane] = limited - whole;
+                    for (auto tap = 0; tap < interpolator::count; ++tap)
+                        x[tap][lane] = m_buffer[(start - tap) & m_mask];
+                }
+
+                const auto y = interpolator::interpolate(x, fraction);
+                for (auto lane = 0; lane < width; ++lane)
+                    destination[i + lane] = static_cast<T>(y[lane]);
+            }
+            for (auto i = bulk; i < frame_count; ++i)
+                destination[i] = read_sample<interpolator>(delays[i], frame_count - 1 - i);
+        }
+
+        template<class interpolator, class U = T>
+        typename enable_if<!std::is_floating_point<U>::value>::type
+        read_vector(T* destination, const sample* delays, const long frame_count) const {
+            for (auto i = 0; i < frame_count; ++i)
+                destination[i] = read_sample<interpolator>(delays[i], frame_count - 1 - i);
+        }
+    };
+
+}    // namespace c74::min
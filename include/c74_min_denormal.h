@@ -0,0 +1,108 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Flush denormal numbers to zero for the lifetime of the guard.
+    ///
+    /// Recursive filters whose output decays towards zero eventually produce denormal (subnormal) numbers,
+    /// which many processors handle at a fraction of the normal speed.
+    /// While a denormal_guard exists the floating-point unit of the current thread treats denormal inputs as zero
+    /// and flushes denormal results to zero.
+    /// The previous state is restored when the guard is destroyed.
+    ///
+    /// On x86 processors this sets the FTZ and DAZ flags of the MXCSR register.
+    /// On ARM64 processors this sets the FZ flag of the FPCR register.
+    /// On other processors the guard has no effect.
+    ///
+    /// Audio classes may declare #MIN_FLUSH_DENORMALS to have the performer create a guard for each vector.
+    /// @code
+    /// {
+    ///     denormal_guard guard;
+    ///     // process audio...
+    /// }
+    /// @endcode
+
+    class denormal_guard {
+    public:
+        /// Set the floating-point unit of the current thread to flush denormals.
+
+        denormal_guard()
+        : m_previous { read() } {
+            write(m_previous | k_flags);
+        }
+
+        denormal_guard(const denormal_guard& other) = delete;
+        denormal_guard& operator=(const denormal_guard& other) = delete;
+
+
+        /// Restore the previous state of the floating-point unit.
+
+        ~denormal_guard() {
+            write(m_previous);
+        }
+
+
+        /// Is flushing of denormals supported on this processor?
+        /// @return	True if the guard has an effect.
+
+        static constexpr bool supported() {
+            return k_flags != 0;
+        }
+
+
+        /// Does the floating-point unit of the current thread flush denormals, e.g. because a guard exists?
+        /// @return	True if denormals are flushed to zero.
+
+        static bool active() {
+            return supported() && (read() & k_flags) == k_flags;
+        }
+
+    private:
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        using state_type = unsigned int;
+
+        static constexpr state_type k_flags = 0x8040;    // FTZ (bit 15) and DAZ (bit 6)
+
+        static state_type read() {
+            return _mm_getcsr();
+        }
+
+        static void write(const state_type state) {
+            _mm_setcsr(state);
+        }
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        using state_type = uint64_t;
+
+        static constexpr state_type k_flags = state_type(1) << 24;    // FZ
+
+        static state_type read() {
+            state_type state;
+            asm volatile("mrs %0, fpcr" : "=r"(state));
+            return state;
+        }
+
+        static void write(const state_type state) {
+            asm volatile("msr fpcr, %0" : : "r"(state));
+        }
+#else
+        using state_type = int;
+
+        static constexpr state_type k_flags = 0;
+
+        static state_type read() {
+            return 0;
+        }
+
+        static void write(const state_type) {}
+#endif
+
+        state_type m_previous;
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,213 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A summary of the time taken by the perform routine of an audio object.
+    /// All times are in microseconds.
+
+    struct dsp_statistics {
+        uint64_t    count { 0 };        ///< The number of vectors that have been measured.
+        double      mean { 0.0 };       ///< The mean time per vector.
+        double      p99 { 0.0 };        ///< The 99th percentile of the time per vector, accurate to within 25%.
+        double      max { 0.0 };        ///< The longest time for a single vector.
+        double      budget { 0.0 };     ///< The duration of the most recent vector, i.e. the time available to process it.
+        uint64_t    overruns { 0 };     ///< The number of vectors that took longer than their duration to process.
+    };
+
+
+    /// Measure the time taken by the perform routine of an audio object.
+    ///
+    /// When Min is compiled with C74_MIN_WITH_DSP_PROFILING defined, every audio object owns a profiler
+    /// and its perform routine is timed on each vector.
+    /// The times are gathered into a histogram with logarithmically spaced buckets.
+    /// The audio thread is the only writer and it neither locks nor allocates memory.
+    /// The statistics may be read at any time from another thread, e.g. by sending the "dspstats" message to the object.
+    /// Without C74_MIN_WITH_DSP_PROFILING the perform routines are not instrumented and cost nothing.
+
+    class dsp_profiler {
+    public:
+        /// The signature of the perform routine being measured.
+
+        using perform_routine = void (*)(max::t_object* x, max::t_object* dsp64, double** ins, long numins, double** outs, long numouts,
+            long sampleframes, long flags, void* userparam);
+
+
+        /// The number of buckets in the histogram.
+        /// Each power of two is split into four buckets, so the histogram spans from 0 to 2^32 nanoseconds.
+
+        static constexpr size_t k_bucket_count = 128;
+
+
+        /// Return the current time for measuring a perform routine.
+        /// @return	A time in nanoseconds from an arbitrary starting point.
+
+        static uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+
+        /// Find the bucket of the histogram that counts a time.
+        /// @param	nanoseconds		The time.
+        /// @return					The index of the bucket.
+
+        static size_t bucket(const uint64_t nanoseconds) {
+            if (nanoseconds < 4)
+                return static_cast<size_t>(nanoseconds);
+
+            const auto clamped  = std::min<uint64_t>(nanoseconds, 0xFFFFFFFF);
+            auto       exponent = 0;
+
+            while ((clamped >> (exponent + 1)) != 0)
+                ++exponent;
+
+            const auto quarter = static_cast<size_t>((clamped >> (exponent - 2)) & 3);
+            return static_cast<size_t>(exponent - 1) * 4 + quarter;
+        }
+
+
+        /// Return the largest time counted by a bucket of the histogram.
+        /// @param	index	The index of the bucket.
+        /// @return			The upper bound of the bucket in nanoseconds (exclusive).
+
+        static uint64_t bucket_upper_bound(const size_t index) {
+            if (index < 4)
+                return index + 1;
+
+            const auto exponent = index / 4 + 1;
+            const auto quarter  = index % 4;
+            return uint64_t(5 + quarter) << (exponent - 2);
+        }
+
+
+        /// Called when the dsp chain is compiled.
+        /// Sets the perform routine to be measured and clears all statistics.
+        /// @param	a_perform_routine	The perform routine that will be called by the profiled perform routine.
+        /// @param	a_samplerate		The samplerate of the signal chain, used to find the duration of each vector.
+
+        void dspsetup(const perform_routine a_perform_routine, const double a_samplerate) {
+            m_perform_routine       = a_perform_routine;
+            m_nanoseconds_per_frame = a_samplerate > 0.0 ? 1e9 / a_samplerate : 0.0;
+            clear();
+        }
+
+
+        /// Get the perform routine being measured.
+        /// @return	The perform routine set by dspsetup().
+
+        perform_routine routine() const {
+            return m_perform_routine;
+        }
+
+
+        /// Called by the audio thread to count the time taken to process a vector.
+        /// @param	nanoseconds		The time taken.
+        /// @param	frame_count		The number of samples in the vector.
+
+        void record(const uint64_t nanoseconds, const long frame_count) {
+            if (m_reset_requested.load(std::memory_order_acquire)) {
+                clear();
+                m_reset_requested.store(false, std::memory_order_release);
+            }
+
+            const auto budget = static_cast<uint64_t>(frame_count * m_nanoseconds_per_frame);
+
+            // There is only a single writer, so a relaxed load and store is sufficient
+            // and avoids the cost of an atomic read-modify-write.
+
+            increment(m_histogram[bucket(nanoseconds)]);
+            add(m_total, nanoseconds);
+            if (nanoseconds > m_max.load(std::memory_order_relaxed))
+                m_max.store(nanoseconds, std::memory_order_relaxed);
+            if (budget > 0 && nanoseconds > budget)
+                increment(m_overruns);
+            m_budget.store(budget, std::memory_order_relaxed);
+            increment(m_count, std::memory_order_release);
+        }
+
+
+        /// Ask the audio thread to clear all statistics before it next records a time.
+        /// May be called from any thread.
+
+        void reset() {
+            m_reset_requested.store(true, std::memory_order_release);
+        }
+
+
+        /// Summarize the times recorded.
+        /// May be called from any thread.
+        /// If the audio thread is recording at the same time the values may differ by a single vector.
+        /// @return	The statistics.
+
+        dsp_statistics statistics() const {
+            dsp_statistics stats;
+
+            stats.count = m_count.load(std::memory_order_acquire);
+            if (stats.count == 0)
+                return stats;
+
+            stats.mean      = nanoseconds_to_microseconds(m_total.load(std::memory_order_relaxed)) / stats.count;
+            stats.max       = nanoseconds_to_microseconds(m_max.load(std::memory_order_relaxed));
+            stats.budget    = nanoseconds_to_microseconds(m_budget.load(std::memory_order_relaxed));
+            stats.overruns  = m_overruns.load(std::memory_order_relaxed);
+
+            uint64_t histogram_count = 0;
+            for (const auto& count : m_histogram)
+                histogram_count += count.load(std::memory_order_relaxed);
+
+            const auto  threshold   = histogram_count - histogram_count / 100;
+            uint64_t    accumulated = 0;
+
+            for (auto i = 0; i < k_bucket_count; ++i) {
+                accumulated += m_histogram[i].load(std::memory_order_relaxed);
+                if (accumulated >= threshold) {
+                    stats.p99 = std::min(nanoseconds_to_microseconds(bucket_upper_bound(i)), stats.max);
+                    break;
+                }
+            }
+            return stats;
+        }
+
+    private:
+        using histogram = std::array<std::atomic<uint64_t>, k_bucket_count>;
+
+        perform_routine         m_perform_routine { nullptr };
+        double                  m_nanoseconds_per_frame { 0.0 };
+        histogram               m_histogram {};
+        std::atomic<uint64_t>   m_count { 0 };
+        std::atomic<uint64_t>   m_total { 0 };          // nanoseconds
+        std::atomic<uint64_t>   m_max { 0 };            // nanoseconds
+        std::atomic<uint64_t>   m_budget { 0 };         // nanoseconds
+        std::atomic<uint64_t>   m_overruns { 0 };
+        std::atomic<bool>       m_reset_requested { false };
+
+
+        static void increment(std::atomic<uint64_t>& value, const std::memory_order order = std::memory_order_relaxed) {
+            value.store(value.load(std::memory_order_relaxed) + 1, order);
+        }
+
+        static void add(std::atomic<uint64_t>& value, const uint64_t amount) {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        static double nanoseconds_to_microseconds(const uint64_t nanoseconds) {
+            return nanoseconds * 1e-3;
+        }
+
+        void clear() {
+            for (auto& count : m_histogram)
+                count.store(0, std::memory_order_relaxed);
+            m_total.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+            m_budget.store(0, std::memory_order_relaxed);
+            m_overruns.store(0, std::memory_order_relaxed);
+            m_count.store(0, std::memory_order_release);
+        }
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,280 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A fast Fourier transform of real signals.
+    ///
+    /// A real signal of N samples is transformed as a complex signal of N/2 samples,
+    /// whose spectrum is then separated into the N/2+1 bins of the real spectrum.
+    /// The complex transform is computed in place with radix-4 butterflies, plus a single radix-2 stage when N/2 is not a power of four.
+    /// Real and imaginary parts are held in separate arrays so that each butterfly loop runs over contiguous memory
+    /// and is vectorized by the compiler.
+    ///
+    /// All memory is allocated by the constructor or by resize().
+    /// forward() and inverse() neither allocate nor lock and are thus safe to call from the audio thread.
+    /// The forward transform is unscaled and the inverse transform is scaled by 1/N, so that inverse(forward(x)) == x.
+    /// @code
+    /// fft                         transform   { 1024 };
+    /// vector<std::complex<sample>> spectrum    (transform.bin_count());
+    ///
+    /// transform.forward(input, spectrum.data());
+    /// transform.inverse(spectrum.data(), output);
+    /// @endcode
+
+    class fft {
+    public:
+        /// Create a transform.
+        /// @param	a_size	The number of real samples to transform. Must be a power of two no smaller than 4, or 0.
+
+        explicit fft(const size_t a_size = 0) {
+            resize(a_size);
+        }
+
+
+        /// Change the size of the transform.
+        /// This allocates memory and should not be called from the audio thread.
+        /// @param	a_size	The number of real samples to transform. Must be a power of two no smaller than 4, or 0.
+
+        void resize(const size_t a_size) {
+            assert(a_size == 0 || (a_size >= 4 && (a_size & (a_size - 1)) == 0));
+
+            m_size = a_size;
+            m_stages.clear();
+
+            if (a_size == 0)
+                return;
+
+            const auto half_size    = a_size / 2;
+            auto       bits         = 0;
+
+            while ((size_t(1) << bits) < half_size)
+                ++bits;
+
+            // bit-reversed order of the complex input
+
+            m_permutation.resize(half_size);
+            for (size_t i = 0; i < half_size; ++i) {
+                size_t reversed = 0;
+                for (auto bit = 0; bit < bits; ++bit)
+                    reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+                m_permutation[i] = reversed;
+            }
+
+            // one radix-2 stage if the number of bits is odd, followed by radix-4 stages
+
+            m_radix2 = (bits % 2) != 0;
+            for (auto quarter = m_radix2 ? size_t(2) : size_t(1); quarter * 4 <= half_size; quarter *= 4) {
+                stage s;
+                s.quarter = quarter;
+                s.w1_real.resize(quarter);
+                s.w1_imaginary.resize(quarter);
+                s.w2_real.resize(quarter);
+                s.w2_imaginary.resize(quarter);
+
+                for (size_t j = 0; j < quarter; ++j) {
+                    const auto angle    = -2.0 * k_pi * j / (4.0 * quarter);
+                    s.w1_real[j]        = std::cos(angle);
+                    s.w1_imaginary[j]   = std::sin(angle);
+                    s.w2_real[j]        = std::cos(2.0 * angle);
+                    s.w2_imaginary[j]   = std::sin(2.0 * angle);
+                }
+                m_stages.push_back(std::move(s));
+            }
+
+            // twiddles that separate the real spectrum from the complex spectrum
+
+            m_real_twiddle.resize(half_size + 1);
+            m_imaginary_twiddle.resize(half_size + 1);
+            for (size_t k = 0; k <= half_size; ++k) {
+                const auto angle        = -2.0 * k_pi * k / a_size;
+                m_real_twiddle[k]       = std::cos(angle);
+                m_imaginary_twiddle[k]  = std::sin(angle);
+            }
+
+            m_real.resize(half_size);
+            m_imaginary.resize(half_size);
+        }
+
+
+        /// Return the number of real samples transformed.
+        /// @return	The size of the transform.
+
+        size_t size() const {
+            return m_size;
+        }
+
+
+        /// Return the number of bins in the spectrum of a real signal.
+        /// @return	The number of bins, which is size()/2+1.
+
+        size_t bin_count() const {
+            return m_size / 2 + 1;
+        }
+
+
+        /// Transform a real signal to its spectrum.
+        /// @param	input	size() samples.
+        /// @param	output	bin_count() bins, from 0 Hz to the Nyquist frequency. The input and output must not overlap.
+
+        void forward(const sample* input, std::complex<sample>* output) {
+            const auto half_size = m_size / 2;
+
+            for (size_t n = 0; n < half_size; ++n) {
+                m_real[m_permutation[n]]        = input[2 * n];
+                m_imaginary[m_permutation[n]]   = input[2 * n + 1];
+            }
+
+            transform();
+
+            // separate the spectra of the even and odd samples and combine them into the real spectrum
+
+            for (size_t k = 0; k <= half_size; ++k) {
+                const auto a        = k % half_size;
+                const auto b        = (half_size - k) % half_size;
+                const auto even_r   = 0.5 * (m_real[a] + m_real[b]);
+                const auto even_i   = 0.5 * (m_imaginary[a] - m_imaginary[b]);
+                const auto odd_r    = 0.5 * (m_imaginary[a] + m_imaginary[b]);
+                const auto odd_i    = -0.5 * (m_real[a] - m_real[b]);
+                const auto w_r      = m_real_twiddle[k];
+                const auto w_i      = m_imaginary_twiddle[k];
+
+                output[k] = { even_r + w_r * odd_r - w_i * odd_i, even_i + w_r * odd_i + w_i * odd_r };
+            }
+        }
+
+
+        /// Transform a spectrum to a real signal.
+        /// @param	input	bin_count() bins, from 0 Hz to the Nyquist frequency.
+        ///					The imaginary parts of the first and last bins are ignored.
+        /// @param	output	size() samples. The input and output must not overlap.
+
+        void inverse(const std::complex<sample>* input, sample* output) {
+            const auto half_size = m_size / 2;
+
+            // the complex spectrum is conjugated so that the forward transform computes the inverse
+
+            for (size_t k = 0; k < half_size; ++k) {
+                const auto x        = input[k];
+                const auto y        = std::conj(input[half_size - k]);
+                const auto even_r   = 0.5 * (x.real() + y.real());
+                const auto even_i   = 0.5 * (x.imag() + y.imag());
+                const auto diff_r   = 0.5 * (x.real() - y.real());
+                const auto diff_i   = 0.5 * (x.imag() - y.imag());
+                const auto w_r      = m_real_twiddle[k];
+                const auto w_i      = -m_imaginary_twiddle[k];
+                const auto odd_r    = diff_r * w_r - diff_i * w_i;
+                const auto odd_i    = diff_r * w_i + diff_i * w_r;
+
+                m_real[m_permutation[k]]        = even_r - odd_i;
+                m_imaginary[m_permutation[k]]   = -(even_i + odd_r);
+            }
+
+            transform();
+
+            const auto scale = 1.0 / half_size;
+
+            for (size_t n = 0; n < half_size; ++n) {
+                output[2 * n]       = m_real[n] * scale;
+                output[2 * n + 1]   = -m_imaginary[n] * scale;
+            }
+        }
+
+    private:
+        static constexpr double k_pi = 3.14159265358979323846;
+
+        struct stage {
+            size_t          quarter;        // the distance between the inputs of each butterfly
+            sample_vector   w1_real;
+            sample_vector   w1_imaginary;
+            sample_vector   w2_real;
+            sample_vector   w2_imaginary;
+        };
+
+        size_t          m_size { 0 };
+        bool            m_radix2 { false };
+        vector<size_t>  m_permutation;
+        vector<stage>   m_stages;
+        sample_vector   m_real_twiddle;
+        sample_vector   m_imaginary_twiddle;
+        sample_vector   m_real;
+        sample_vector   m_imaginary;
+
+
+        // The in-place complex forward transform of the bit-reversed data in m_real and m_imaginary.
+        // Each radix-4 butterfly combines two radix-2 stages:
+        // the first stage uses the twiddle w2 = w1^2 and the second uses w1 and -i * w1.
+
+        void transform() {
+            const auto  half_size   = m_size / 2;
+            auto        re          = m_real.data();
+            auto        im          = m_imaginary.data();
+
+            if (m_radix2) {
+                for (size_t i = 0; i < half_size; i += 2) {
+                    const auto r = re[i + 1];
+                    const auto j = im[i + 1];
+                    re[i + 1] = re[i] - r;
+                    im[i + 1] = im[i] - j;
+                    re[i]    += r;
+                    im[i]    += j;
+                }
+            }
+
+            for (const auto& s : m_stages) {
+                const auto  h       = s.quarter;
+                const auto  w1r     = s.w1_real.data();
+                const auto  w1i     = s.w1_imaginary.data();
+                const auto  w2r     = s.w2_real.data();
+                const auto  w2i     = s.w2_imaginary.data();
+
+                for (size_t block = 0; block < half_size; block += 4 * h) {
+                    auto r0 = re + block;
+                    auto i0 = im + block;
+                    auto r1 = r0 + h;
+                    auto i1 = i0 + h;
+                    auto r2 = r1 + h;
+                    auto i2 = i1 + h;
+                    auto r3 = r2 + h;
+                    auto i3 = i2 + h;
+
+                    for (size_t j = 0; j < h; ++j) {
+                        const auto t1r = w2r[j] * r1[j] - w2i[j] * i1[j];
+                        const auto t1i = w2r[j] * i1[j] + w2i[j] * r1[j];
+                        const auto t3r = w2r[j] * r3[j] - w2i[j] * i3[j];
+                        const auto t3i = w2r[j] * i3[j] + w2i[j] * r3[j];
+
+                        const auto a0r = r0[j] + t1r;
+                        const auto a0i = i0[j] + t1i;
+                        const auto a1r = r0[j] - t1r;
+                        const auto a1i = i0[j] - t1i;
+                        const auto a2r = r2[j] + t3r;
+                        const auto a2i = i2[j] + t3i;
+                        const auto a3r = r2[j] - t3r;
+                        const auto a3i = i2[j] - t3i;
+
+                        const auto u2r = w1r[j] * a2r - w1i[j] * a2i;
+                        const auto u2i = w1r[j] * a2i + w1i[j] * a2r;
+                        const auto u3r = w1r[j] * a3r - w1i[j] * a3i;
+                        const auto u3i = w1r[j] * a3i + w1i[j] * a3r;
+
+                        r0[j] = a0r + u2r;
+                        i0[j] = a0i + u2i;
+                        r2[j] = a0r - u2r;
+                        i2[j] = a0i - u2i;
+                        r1[j] = a1r + u3i;    // a1 + (-i * u3)
+                        i1[j] = a1i - u3r;
+                        r3[j] = a1r - u3i;
+                        i3[j] = a1i + u3r;
+                    }
+                }
+            }
+        }
+    };
+
+}    // namespace c74::min
@@ -32,6 +32,15 @@ namespace c74::min {
     };
 
 
+    /// Audio flags determine how MSP will treat the signal vectors of your audio object.
+
+    enum class audio_flags : int {
+        none,       ///< No flags. Use the default behavior (outputs never share memory with inputs).
+        inplace     ///< The object reads each input sample before writing the corresponding output sample,
+                    ///< so MSP may use the same memory for an input and an output.
+    };
+
+
     /// An amalgamation that represents all available class-level flags for a Min object.
     /// This class should be created through the use of the #MIN_FLAGS macro in your Min class definition rather than directly.
 
@@ -64,15 +73,26 @@ namespace c74::min {
         {}
 
 
+        /// Declare flags for your class.
+        /// @param	audio	Audio flags for the class.
+        /// @see			audio_flags
+
+        explicit constexpr flags(audio_flags audio)
+        : m_audio{audio}
+        {}
+
+
         /// Declare flags for your class.
         /// @param	behavior	Behavior flags for the class.
         /// @param	doc			Documentation flags for the class.
         /// @param	host		Host flags for the class.
+        /// @param	audio		Audio flags for the class.
 
-        explicit constexpr flags(behavior_flags behavior, documentation_flags doc, host_flags host = host_flags::none)
+        explicit constexpr flags(behavior_flags behavior, documentation_flags doc, host_flags host = host_flags::none, audio_flags audio = audio_flags::none)
         : m_documentation{doc}
         , m_behavior{behavior}
         , m_host{host}
+        , m_audio{audio}
         {}
 
 
@@ -99,10 +119,19 @@ namespace c74::min {
             return m_host;
         }
 
+
+        /// Get the audio flags of the class.
+        /// @return	The audio flags of the class.
+
+        constexpr operator audio_flags() const {
+            return m_audio;
+        }
+
     private:
         const documentation_flags m_documentation{};
         const behavior_flags      m_behavior{};
         const host_flags          m_host{};
+        const audio_flags         m_audio{};
     };
 
 
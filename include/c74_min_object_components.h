@@ -21,6 +21,7 @@ namespace c74::min {
     class argument_base;
     class message_base;
     class attribute_base;
+    class smoothed;
 
     template<typename T, threadsafe threadsafety = threadsafe::undefined, template<typename> class limit_type = limit::none, allow_repetitions repetitions = allow_repetitions::yes>
     class attribute;
@@ -225,6 +226,15 @@ namespace c74::min {
         }
 
 
+        /// Get a reference to this object's smoothed attribute followers.
+        /// Their storage is allocated when the dsp chain is compiled.
+        /// @return	A reference to this object's smoothed attribute followers.
+
+        auto smoothed_attributes() -> std::vector<smoothed*>& {
+            return m_smoothed;
+        }
+
+
         /// Is this object done being initialized?
         ///	@return	True if it is done with initialization and construction. Otherwise false.
 
@@ -317,6 +327,7 @@ namespace c74::min {
         std::vector<inlet_base*>                         m_inlets;
         std::vector<outlet_base*>                        m_outlets;
         std::vector<argument_base*>                      m_arguments;
+        std::vector<smoothed*>                           m_smoothed;
         std::unordered_map<std::string, message_base*>   m_messages;      // written at class init -- readonly thereafter
         std::unordered_map<std::string, attribute_base*> m_attributes;    // written at class init -- readonly thereafter
         dict                                             m_state;
@@ -420,7 +431,8 @@ namespace c74::min {
     template<class min_class_type>
     struct minwrap<min_class_type, typename enable_if<!is_base_of<vector_operator_base, min_class_type>::value
                                                         && !is_base_of<mc_operator_base, min_class_type>::value
-                                                        && !is_base_of<sample_operator_base, min_class_type>::value>::type> {
+                                                        && !is_base_of<sample_operator_base, min_class_type>::value
+                                                        && !is_base_of<spectral_operator_base, min_class_type>::value>::type> {
         maxobject_header m_max_header;
         min_class_type   m_min_object;
 
@@ -686,6 +686,9 @@ namespace c74::min {
     template<class min_class_type>
     type_enable_if_not_audio_class<min_class_type> wrap_as_max_external_audio(max::t_class*) {}
 
+    template<class min_class_type, typename enable_if<!is_base_of<mc_operator_base, min_class_type>::value || !has_channel_state<min_class_type>::value, int>::type = 0>
+    void wrap_as_max_external_mc(max::t_class*) {}
+
     template<class min_class_type>
     type_enable_if_not_ui_class<min_class_type> wrap_as_max_external_ui(max::t_class*, min_class_type&) {}
 
@@ -727,6 +730,7 @@ namespace c74::min {
         auto c = wrap_as_max_external_common<min_class_type>(*instance, cppname, maxname, resources);
 
         wrap_as_max_external_audio<min_class_type>(c);
+        wrap_as_max_external_mc<min_class_type>(c);
 
         instance->try_call("maxclass_setup", c);
         wrap_as_max_external_finish<min_class_type>(c, *instance);
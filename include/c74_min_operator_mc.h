@@ -13,18 +13,120 @@ namespace c74::min {
     class mc_operator_base {};
 
 
-    /// Inheriting from sample_operator extends your class functionality to processing audio
-    /// by calculating samples one at a time using the call operator member of your class.
+    /// Storage for the per-channel state of an mc_operator<> class that declares a channel_state.
+    /// The state is stored as one channel_state<lanes<N>> for each group of N channels,
+    /// so that each member of the state is laid out as a contiguous array across the channels in the group.
+    /// It is resized by the framework when the dsp chain is compiled and the number of channels has changed.
+
+    class mc_channel_storage {
+    public:
+        /// The number of channels processed together in each group.
+
+        static constexpr long k_width = static_cast<long>(simd::k_width);
+
+
+        /// Return the number of channel groups for a number of channels.
+        /// @param	channel_count	The number of channels.
+        /// @return					The number of groups required.
+
+        static size_t group_count(const long channel_count) {
+            return static_cast<size_t>((std::max(channel_count, 1L) + k_width - 1) / k_width);
+        }
+
+
+        /// Allocate the state for a number of channels.
+        /// The state of existing channels is preserved.
+        /// @tparam	state_type		The channel_state<lanes<N>> of the owning class.
+        /// @param	channel_count	The number of channels.
+        /// @param	frame_count		The vector size of the signal chain.
+
+        template<class state_type>
+        void resize(const long channel_count, const long frame_count) {
+            if (!m_states)
+                m_states = std::make_shared<vector<state_type>>();
+            states<state_type>().resize(group_count(channel_count));
+            m_silence.assign(frame_count, 0.0);
+            m_discard.assign(frame_count, 0.0);
+        }
+
+
+        /// Get the state of all channel groups.
+        /// @tparam	state_type	The channel_state<lanes<N>> of the owning class.
+        /// @return				The state of each group of channels.
+
+        template<class state_type>
+        vector<state_type>& states() {
+            return *static_cast<vector<state_type>*>(m_states.get());
+        }
+
+
+        /// Is storage allocated?
+        /// @return	True if resize() has been called.
+
+        bool allocated() const {
+            return m_states != nullptr;
+        }
+
+
+        /// Get a vector of zeros to read in place of a missing input channel.
+        /// @return	A pointer to the zeros.
+
+        const sample* silence() const {
+            return m_silence.data();
+        }
+
+
+        /// Get a vector to write in place of a missing output channel.
+        /// @return	A pointer to the vector, the contents of which are discarded.
+
+        sample* discard() {
+            return m_discard.data();
+        }
+
+
+        /// Return the number of samples in the silence() and discard() vectors.
+        /// @return	The number of samples.
+
+        long frame_count() const {
+            return static_cast<long>(m_silence.size());
+        }
+
+    private:
+        std::shared_ptr<void>   m_states;       // a vector<state_type>, the type of which is known only to the performer
+        sample_vector           m_silence;
+        sample_vector           m_discard;
+    };
+
+
+    /// Inheriting from mc_operator extends your class functionality to processing multichannel (MC) audio.
     ///
-    /// Your call operator must take the same number of parameters as the input_count template arg.
-    /// Additionally, your call operator must return an array of samples of the same size as the output_count template arg.
-    /// For example, if your object inherits from sample_operator<3,2> then your call operator will be prototyped as:
+    /// Like a vector_operator<> you may implement a call operator that receives the audio of all channels:
     /// @code
-    /// samples<2> operator() (sample input1, sample input2, sample input3);
+    /// void operator()(audio_bundle input, audio_bundle output);
     /// @endcode
     ///
-    /// @tparam vector_operator_placeholder_type Unused.
-
+    /// Alternatively, if each channel of the first inlet is processed independently, you may declare the state of a single
+    /// channel as a template struct named channel_state and implement the call operator as a template on the sample type.
+    /// The framework then stores the state of all channels, resizes it when the number of channels changes,
+    /// and processes groups of channels in lock-step using lanes<> packs.
+    /// Each output channel is calculated from the input channel with the same index.
+    /// The number of output channels follows the number of input channels.
+    /// @code
+    /// template<class T>
+    /// struct channel_state {
+    ///     T previous { 0.0 };
+    /// };
+    ///
+    /// template<class T>
+    /// T operator()(T input, channel_state<T>& state) {
+    ///     auto output = input + state.previous * m_coefficient;
+    ///     state.previous = output;
+    ///     return output;
+    /// }
+    /// @endcode
+    ///
+    /// In this case do not define messages named "multichanneloutputs" or "inputchanged" as these are provided for you.
+    ///
     template<placeholder vector_operator_placeholder_type = placeholder::none>
     class mc_operator : public mc_operator_base {
     public:
@@ -69,6 +171,49 @@ namespace c74::min {
             return m_vector_size;
         }
 
+        /// Get the queue of sample-accurate events for this object.
+        /// @return	The queue, or nullptr if the object has not declared an audio_event_queue member.
+
+        audio_event_queue* event_queue() const {
+            return m_event_queue;
+        }
+
+
+        /// Attach a queue of sample-accurate events to this object.
+        /// You will not typically have any need to call this.
+        /// It is called by the constructor of audio_event_queue.
+        /// @param	a_queue		The queue to attach.
+
+        void event_queue(audio_event_queue* a_queue) {
+            m_event_queue = a_queue;
+        }
+
+
+        ///	Set the number of channels in the first inlet.
+        /// You will not typically have any need to call this.
+        /// It is called internally when the number of channels connected to the object changes.
+        /// @param	a_channel_count	The new number of channels.
+
+        void channel_count(const long a_channel_count) {
+            m_channel_count = a_channel_count;
+        }
+
+
+        /// Return the number of channels in the first inlet.
+        /// @return	The number of channels.
+
+        long channel_count() const {
+            return m_channel_count;
+        }
+
+
+        /// Get the storage for the per-channel state of a class that declares a channel_state.
+        /// @return	The storage.
+
+        mc_channel_storage& channels() {
+            return m_channels;
+        }
+
 
         // Ideally we would also declare a pure virtual function call operator
         // for the inheriting class to implement.
@@ -86,9 +231,159 @@ namespace c74::min {
                                                        // dsp chain is compiled.
         int m_vector_size{c74::max::sys_getblksize()};    // ...
         vector<std::pair<int,attribute_base*>> m_attributes_mapped_to_inlets;
+        audio_event_queue* m_event_queue { nullptr };
+        long m_channel_count { 1 };
+        mc_channel_storage m_channels;
+    };
+
+
+    template<class min_class_type>
+    using enable_if_mc_channel_state = typename enable_if<is_base_of<mc_operator_base, min_class_type>::value
+                                                          && has_channel_state<min_class_type>::value, int>::type;
+
+
+    /// Process a vector of multichannel audio using the per-channel call operator of an mc_operator<> class.
+    /// Channels are processed in groups of mc_channel_storage::k_width using lanes<> packs.
+    /// Input channels that are missing are read as silence and output channels that have no state allocated are cleared.
+    /// This is called by the performer and is primarily useful for unit testing.
+    /// @param	object			The Min object.
+    /// @param	in_chans		The input channels.
+    /// @param	numins			The number of input channels.
+    /// @param	out_chans		The output channels.
+    /// @param	numouts			The number of output channels.
+    /// @param	sampleframes	The number of samples in each channel.
+    /// @param	first_channel	The first output channel to process. Must be a multiple of mc_channel_storage::k_width.
+    /// @param	end_channel		One past the last output channel to process, or -1 to process all remaining channels.
+
+    template<class min_class_type, enable_if_mc_channel_state<min_class_type> = 0>
+    void perform_channels(min_class_type& object, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes,
+        const long first_channel = 0, const long end_channel = -1)
+    {
+        using state_type = typename min_class_type::template channel_state<lanes<mc_channel_storage::k_width>>;
+
+        constexpr auto  width           = mc_channel_storage::k_width;
+        auto&           channels        = object.channels();
+        auto&           states          = channels.template states<state_type>();
+        const auto      last_channel    = end_channel < 0 ? numouts : std::min(end_channel, numouts);
+        const auto      state_channels  = std::min(static_cast<long>(states.size()) * width, last_channel);
+        const sample*   ins[width];
+        sample*         outs[width];
+
+        assert(first_channel % width == 0);
+        assert(sampleframes <= channels.frame_count());
+
+        for (auto group = first_channel / width; group * width < state_channels; ++group) {
+            auto& state = states[group];
+
+            for (auto lane = 0; lane < width; ++lane) {
+                const auto channel = group * width + lane;
+                ins[lane]  = channel < numins ? in_chans[channel] : channels.silence();
+                outs[lane] = channel < last_channel ? out_chans[channel] : channels.discard();
+            }
+
+            for (auto i = 0; i < sampleframes; ++i) {
+                lanes<width> input;
+
+                for (auto lane = 0; lane < width; ++lane)
+                    input[lane] = ins[lane][i];
+
+                const lanes<width> output = object(input, state);
+
+                for (auto lane = 0; lane < width; ++lane)
+                    outs[lane][i] = output[lane];
+            }
+        }
+
+        for (auto channel = std::max(first_channel, state_channels); channel < last_channel; ++channel)
+            simd::clear(out_chans[channel], sampleframes);
+    }
+
+
+    // Process a range of channels for perform_parallel(), see c74_min_operator_vector.h
+    // The range starts at a whole group of channels, so its channel state is not shared with any other range.
+
+    template<class min_class_type, enable_if_mc_channel_state<min_class_type> = 0>
+    void perform_channel_range(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts,
+        const long sampleframes, const long first_channel, const long channel_count)
+    {
+        perform_channels(self->m_min_object, in_chans, numins, out_chans, numouts, sampleframes, first_channel, first_channel + channel_count);
+    }
+
+
+    // The performer for mc_operator<> classes that declare a channel_state.
+    // Other mc_operator<> classes use the vector_operator<> performer in c74_min_operator_vector.h
+
+    template<class min_class_type>
+    class performer<min_class_type, typename enable_if<is_base_of<mc_operator_base, min_class_type>::value && has_channel_state<min_class_type>::value>::type> {
+    public:
+        // The traditional Max audio "perform" callback routine
+
+        static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+            perform_channels(self->m_min_object, in_chans, numins, out_chans, numouts, sampleframes);
+        }
     };
 
     template<class min_class_type, enable_if_mc_operator<min_class_type> = 0>
     void min_dsp64_attrmap(minwrap<min_class_type>* self, const short* count) {}
 
+
+    // When the dsp chain is compiled, update the number of channels and resize the per-channel state if there is one.
+    // Without a dsp64 object, e.g. in the render_harness<>, the number of channels is left as it was set.
+
+    template<class min_class_type, enable_if_mc_operator<min_class_type> = 0>
+    void min_dsp64_channels(minwrap<min_class_type>* self, max::t_object* dsp64) {
+        if (dsp64) {
+            const auto channel_count = reinterpret_cast<max::t_ptr_int>(max::object_method(dsp64, max::gensym("getnuminputchannels"), self->maxobj(), 0));
+            self->m_min_object.channel_count(static_cast<long>(channel_count));
+        }
+        min_dsp64_channel_states(self);
+    }
+
+    template<class min_class_type, enable_if_mc_channel_state<min_class_type> = 0>
+    void min_dsp64_channel_states(minwrap<min_class_type>* self) {
+        using state_type = typename min_class_type::template channel_state<lanes<mc_channel_storage::k_width>>;
+
+        auto& object = self->m_min_object;
+        object.channels().template resize<state_type>(object.channel_count(), object.vector_size());
+    }
+
+    template<class min_class_type, typename enable_if<!has_channel_state<min_class_type>::value, int>::type = 0>
+    void min_dsp64_channel_states(minwrap<min_class_type>* self) {}
+
+    template<class min_class_type, enable_if_mc_operator<min_class_type> = 0>
+    max::t_perfroutine64 min_dsp64_perform(minwrap<min_class_type>* self) {
+        return min_dsp64_perform_parallel(self);
+    }
+
+
+    // The "multichanneloutputs" method called by Max to determine the number of channels for each outlet.
+
+    template<class min_class_type>
+    long min_mc_multichanneloutputs(minwrap<min_class_type>* self, const long index) {
+        return self->m_min_object.channel_count();
+    }
+
+
+    // The "inputchanged" method called by Max when the number of channels connected to an inlet changes.
+    // Returns true if the number of output channels has changed as a result.
+
+    template<class min_class_type>
+    long min_mc_inputchanged(minwrap<min_class_type>* self, const long index, const long count) {
+        if (index != 0 || count == self->m_min_object.channel_count())
+            return false;
+        self->m_min_object.channel_count(count);
+        return true;
+    }
+
+
+    // Add the multichannel methods to a Max external when the max::t_class is being setup.
+    // Only mc_operator<> classes that declare a channel_state manage their output channels this way.
+    // The (non-)specialization for all other classes is in c74_min_object_wrapper.h
+
+    template<class min_class_type, enable_if_mc_channel_state<min_class_type> = 0>
+    void wrap_as_max_external_mc(max::t_class* c) {
+        max::class_addmethod(c, reinterpret_cast<max::method>(min_mc_multichanneloutputs<min_class_type>), "multichanneloutputs", max::A_CANT, 0);
+        max::class_addmethod(c, reinterpret_cast<max::method>(min_mc_inputchanged<min_class_type>), "inputchanged", max::A_CANT, 0);
+    }
+
 }    // namespace c74::min
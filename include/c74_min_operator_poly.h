@@ -0,0 +1,415 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// How a poly_operator<> chooses the voice to take over when a note starts and all voices are sounding.
+    /// Voices that have been released are always stolen before voices whose note is still held.
+
+    enum class voice_stealing {
+        none,        ///< Ignore the new note.
+        oldest,      ///< Steal the voice that was started first.
+        quietest,    ///< Steal the voice started with the lowest velocity.
+        lowest,      ///< Steal the voice playing the lowest pitch.
+        highest      ///< Steal the voice playing the highest pitch.
+    };
+
+
+    // Represents any specialized type of poly_operator<>.
+
+    class poly_operator_base {};
+
+
+    /// Inherit from poly_operator to run many voices of a synthesizer within a single object,
+    /// rather than one voice for each instance of an object in poly~.
+    ///
+    /// The voices are stored contiguously in the object.
+    /// Notes started and stopped with note_on() and note_off() are assigned to voices by the audio thread at the start of the next vector,
+    /// stealing a voice according to the stealing() policy if all voices are sounding.
+    /// Only voices that are sounding are processed, and their output is summed to the outputs of the object.
+    /// You declare the outlets of your object and a voice class, but no call operator:
+    /// @code
+    /// struct sine_voice {
+    ///     void note_on(number pitch, number velocity) { ... }     // start a note, or restart a voice that is stolen
+    ///     void note_off() { ... }                                 // start the release of the note
+    ///     bool active() const { ... }                             // false once the release has finished
+    ///     void operator()(audio_bundle output) { ... }            // add a vector of output to the output channels
+    ///
+    ///     void dspsetup(double samplerate, long vector_size) { ... }    // optional, called when the dsp chain is compiled
+    /// };
+    ///
+    /// class synth : public object<synth>, public poly_operator<sine_voice, 64> {
+    /// public:
+    ///     outlet<> output { this, "(signal) Output", "signal" };
+    ///
+    ///     message<> note { this, "note", "Start or stop a note with a pitch and velocity.",
+    ///         MIN_FUNCTION {
+    ///             note_on(args[0], args[1]);
+    ///             return {};
+    ///         }
+    ///     };
+    /// };
+    /// @endcode
+    ///
+    /// If the voices are expensive they may be processed in groups on multiple cores by the shared worker_pool.
+    /// Each group is summed into outputs of its own, which are then summed to the outputs of the object.
+    ///
+    /// @tparam voice_type				The class of a single voice.
+    /// @tparam voice_count_param		The number of voices.
+    /// @tparam voices_per_task_param	The number of voices in each group that is processed in parallel,
+    ///									or 0 to process all voices on the audio thread.
+    /// @see worker_pool
+
+    template<class voice_type, size_t voice_count_param, size_t voices_per_task_param = 0>
+    class poly_operator : public vector_operator<>, public poly_operator_base {
+        static_assert(voice_count_param > 0, "a poly_operator must have at least one voice");
+
+    public:
+        /// The maximum number of note events that may be pending at the start of a vector.
+        /// Events posted beyond this capacity are rejected.
+
+        static constexpr size_t k_event_capacity = 256;
+
+
+        /// Return the number of voices of this poly operator class.
+        /// @return	The number of voices.
+
+        static constexpr size_t voice_count() {
+            return voice_count_param;
+        }
+
+
+        /// Default constructor.
+
+        poly_operator()
+        : m_incoming { k_event_capacity }
+        {}
+
+
+        /// Start a note.
+        /// May be called from any thread; the note is assigned to a voice at the start of the next vector.
+        /// If a voice is already sounding the same pitch it is restarted.
+        /// @param	pitch		The pitch of the note, e.g. as a MIDI note number.
+        /// @param	velocity	The velocity of the note. A velocity of 0 or less stops the note, as with MIDI.
+        /// @return				True if the note was queued, false if too many notes are pending.
+
+        bool note_on(const number pitch, const number velocity) {
+            return post({ velocity > 0.0 ? note_kind::on : note_kind::off, pitch, velocity });
+        }
+
+
+        /// Stop a note.
+        /// All voices playing the pitch whose note is still held are released.
+        /// May be called from any thread.
+        /// @param	pitch	The pitch of the note.
+        /// @return			True if the note was queued, false if too many notes are pending.
+
+        bool note_off(const number pitch) {
+            return post({ note_kind::off, pitch, 0.0 });
+        }
+
+
+        /// Stop all notes that are held.
+        /// May be called from any thread.
+        /// @return	True if the event was queued, false if too many notes are pending.
+
+        bool all_notes_off() {
+            return post({ note_kind::all_off, 0.0, 0.0 });
+        }
+
+
+        /// Set how voices are stolen when a note starts and all voices are sounding.
+        /// @param	a_policy	The new policy.
+
+        void stealing(const voice_stealing a_policy) {
+            m_stealing = a_policy;
+        }
+
+
+        /// Return how voices are stolen when a note starts and all voices are sounding.
+        /// @return	The current policy. The default is voice_stealing::oldest.
+
+        voice_stealing stealing() const {
+            return m_stealing;
+        }
+
+
+        /// Get one of the voices, e.g. to update its parameters from the audio thread.
+        /// @param	index	The index of the voice.
+        /// @return			The voice.
+
+        voice_type& voice(const size_t index) {
+            return m_voices[index];
+        }
+
+
+        /// Return the number of voices that are sounding.
+        /// This is updated by the audio thread at the end of each vector.
+        /// @return	The number of voices that were processed in the last vector.
+
+        size_t active_voice_count() const {
+            return m_active_count.load(std::memory_order_relaxed);
+        }
+
+
+        /// Allocate memory for processing the voices and call the dspsetup() of each voice if it has one.
+        /// You will not typically have any need to call this.
+        /// It is called internally any time the dsp chain containing your object is compiled.
+        /// @param	output_count	The maximum number of output channels.
+
+        void prepare_voices(const size_t output_count) {
+            constexpr auto task_count = voices_per_task_param > 0 ? (voice_count_param + voices_per_task_param - 1) / voices_per_task_param : 0;
+
+            for (auto& voice : m_voices)
+                voice_dspsetup(voice);
+
+            m_output_count = output_count;
+            m_group_outputs.assign(task_count * output_count, sample_vector(vector_size(), 0.0));
+            m_group_pointers.clear();
+            for (auto& group_output : m_group_outputs)
+                m_group_pointers.push_back(group_output.data());
+
+            if (task_count > 1)
+                worker_pool::shared();
+        }
+
+
+        /// Assign pending notes to voices and process all voices that are sounding.
+        /// This is called by the performer for each vector.
+        /// @param	input	The incoming audio, which is not used.
+        /// @param	output	The sum of the output of all voices.
+
+        void operator()(audio_bundle input, audio_bundle output) override {
+            receive();
+
+            for (auto channel = 0; channel < output.channel_count(); ++channel)
+                simd::clear(output.samples(channel), output.frame_count());
+
+            constexpr auto  voices_per_task = static_cast<long>(voices_per_task_param);
+            const auto      task_count      = voices_per_task > 0 ? (static_cast<long>(m_playing_count) + voices_per_task - 1) / voices_per_task : 0L;
+            const auto      channel_count   = std::min(static_cast<size_t>(output.channel_count()), m_output_count);
+
+            if (task_count < 2 || m_group_pointers.empty() || output.frame_count() < k_parallel_min_frames || output.frame_count() > vector_size()) {
+                for (size_t i = 0; i < m_playing_count; ++i)
+                    m_voices[m_playing[i]](output);
+            }
+            else {
+                render_context context { this, output.frame_count() };
+
+                worker_pool::shared().run(render_task, &context, static_cast<size_t>(task_count));
+                for (auto task = 0; task < task_count; ++task) {
+                    for (size_t channel = 0; channel < channel_count; ++channel)
+                        simd::add(output.samples(static_cast<long>(channel)), m_group_pointers[task * m_output_count + channel], output.frame_count());
+                }
+            }
+
+            retire();
+        }
+
+    private:
+        enum class note_kind { on, off, all_off };
+
+        struct note_event {
+            note_kind   kind;
+            number      pitch;
+            number      velocity;
+        };
+
+        struct voice_status {
+            number      pitch { 0.0 };
+            number      velocity { 0.0 };
+            uint64_t    started { 0 };      // the number of notes started before this one, to find the oldest voice
+            bool        held { false };     // note_off() has not yet been called for the note
+            bool        playing { false };  // the voice is processed
+        };
+
+        struct render_context {
+            poly_operator*  self;
+            long            frame_count;
+        };
+
+        std::array<voice_type, voice_count_param>   m_voices;
+        std::array<voice_status, voice_count_param> m_status;
+        std::array<size_t, voice_count_param>       m_playing;                  // the indices of the voices that are processed, in the order they started
+        size_t                                      m_playing_count { 0 };
+        std::atomic<size_t>                         m_active_count { 0 };
+        uint64_t                                    m_started { 0 };
+        std::atomic<voice_stealing>                 m_stealing { voice_stealing::oldest };
+        fifo<note_event>                            m_incoming;
+        mutex                                       m_post_mutex;               // the fifo permits only one producer at a time
+        size_t                                      m_output_count { 0 };
+        vector<sample_vector>                       m_group_outputs;            // the outputs of each group of voices processed in parallel
+        vector<double*>                             m_group_pointers;
+
+
+        bool post(const note_event& event) {
+            guard lock { m_post_mutex };
+            return m_incoming.try_enqueue(event);
+        }
+
+
+        template<class T = voice_type, typename enable_if<has_dspsetup<T>::value, int>::type = 0>
+        void voice_dspsetup(T& voice) {
+            voice.dspsetup(samplerate(), static_cast<long>(vector_size()));
+        }
+
+        template<class T = voice_type, typename enable_if<!has_dspsetup<T>::value, int>::type = 0>
+        void voice_dspsetup(T& voice) {}
+
+
+        // Apply the note events posted since the last vector.
+
+        void receive() {
+            note_event event;
+
+            while (m_incoming.try_dequeue(event)) {
+                if (event.kind == note_kind::on)
+                    start(event.pitch, event.velocity);
+                else {
+                    for (size_t i = 0; i < m_playing_count; ++i) {
+                        auto& status = m_status[m_playing[i]];
+
+                        if (status.held && (event.kind == note_kind::all_off || status.pitch == event.pitch)) {
+                            status.held = false;
+                            m_voices[m_playing[i]].note_off();
+                        }
+                    }
+                }
+            }
+        }
+
+
+        void start(const number pitch, const number velocity) {
+            const auto index = choose_voice(pitch);
+
+            if (index == voice_count_param)
+                return;
+
+            auto& status = m_status[index];
+
+            if (status.playing)
+            {
+                const auto position = std::find(m_playing.begin(), m_playing.begin() + m_playing_count, index);
+                std::rotate(position, position + 1, m_playing.begin() + m_playing_count);
+            }
+            else
+                m_playing[m_playing_count++] = index;
+
+            status.pitch    = pitch;
+            status.velocity = velocity;
+            status.started  = m_started++;
+            status.held     = true;
+            status.playing  = true;
+            m_voices[index].note_on(pitch, velocity);
+        }
+
+
+        // Find the voice for a new note: one already sounding the pitch, then an idle voice, then a voice to steal.
+        // Returns voice_count_param if the note should be ignored.
+
+        size_t choose_voice(const number pitch) const {
+            for (size_t i = 0; i < m_playing_count; ++i) {
+                if (m_status[m_playing[i]].pitch == pitch)
+                    return m_playing[i];
+            }
+
+            if (m_playing_count < voice_count_param) {
+                for (size_t index = 0; index < voice_count_param; ++index) {
+                    if (!m_status[index].playing)
+                        return index;
+                }
+            }
+
+            const auto policy = m_stealing.load();
+
+            if (policy == voice_stealing::none)
+                return voice_count_param;
+
+            auto any_released   = std::any_of(m_status.begin(), m_status.end(), [](const voice_status& status) { return !status.held; });
+            auto chosen         = voice_count_param;
+
+            for (size_t index = 0; index < voice_count_param; ++index) {
+                const auto& status = m_status[index];
+
+                if (any_released && status.held)
+                    continue;
+                if (chosen == voice_count_param || steal_before(policy, status, m_status[chosen]))
+                    chosen = index;
+            }
+            return chosen;
+        }
+
+
+        static bool steal_before(const voice_stealing policy, const voice_status& a, const voice_status& b) {
+            switch (policy) {
+                case voice_stealing::quietest:
+                    return a.velocity < b.velocity || (a.velocity == b.velocity && a.started < b.started);
+                case voice_stealing::lowest:
+                    return a.pitch < b.pitch || (a.pitch == b.pitch && a.started < b.started);
+                case voice_stealing::highest:
+                    return a.pitch > b.pitch || (a.pitch == b.pitch && a.started < b.started);
+                default:
+                    return a.started < b.started;
+            }
+        }
+
+
+        // Stop processing the voices that have finished, keeping the others in the order they started.
+
+        void retire() {
+            size_t count = 0;
+
+            for (size_t i = 0; i < m_playing_count; ++i) {
+                const auto index = m_playing[i];
+
+                if (m_voices[index].active())
+                    m_playing[count++] = index;
+                else
+                    m_status[index] = voice_status {};
+            }
+            m_playing_count = count;
+            m_active_count.store(count, std::memory_order_relaxed);
+        }
+
+
+        // Process one group of voices into the outputs of the group, for the worker_pool.
+
+        static void render_task(void* a_context, const size_t task) {
+            const auto& context         = *static_cast<render_context*>(a_context);
+            auto&       self            = *context.self;
+            const auto  first           = task * voices_per_task_param;
+            const auto  last            = std::min(first + voices_per_task_param, self.m_playing_count);
+            const auto  group_outputs   = self.m_group_pointers.data() + task * self.m_output_count;
+
+            for (size_t channel = 0; channel < self.m_output_count; ++channel)
+                simd::clear(group_outputs[channel], context.frame_count);
+
+            audio_bundle output { group_outputs, static_cast<long>(self.m_output_count), context.frame_count };
+
+            for (auto i = first; i < last; ++i)
+                self.m_voices[self.m_playing[i]](output);
+        }
+    };
+
+
+    template<class min_class_type, enable_if_poly_operator<min_class_type> = 0>
+    void min_dsp64_attrmap(minwrap<min_class_type>* self, const short* count)
+    {}
+
+
+    // The min_dsp64_perform function selects the perform routine for the Min class.
+    // The memory for processing the voices of the poly_operator<> is allocated here, when the dsp chain is compiled.
+    // The voices are processed by the call operator of poly_operator<> using the vector_operator<> performer.
+
+    template<class min_class_type, enable_if_poly_operator<min_class_type> = 0>
+    max::t_perfroutine64 min_dsp64_perform(minwrap<min_class_type>* self) {
+        self->m_min_object.prepare_voices(self->m_min_object.outlets().size());
+        return min_dsp64_perform_events<min_class_type, performer<min_class_type>::perform>(self);
+    }
+
+}    // namespace c74::min
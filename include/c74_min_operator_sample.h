@@ -13,6 +13,16 @@ namespace c74::min {
     class sample_operator_base {};
 
 
+    /// An audio inlet that is mapped to an attribute, as gathered when the dsp chain is compiled.
+
+    struct attribute_mapping {
+        int             inlet;                  ///< The index of the inlet carrying the signal.
+        attribute_base* attr;                   ///< The attribute to which the signal is mapped.
+        signal_setter   setter { nullptr };     ///< The allocation-free setter for the attribute, if it has one.
+        bool            constant { false };     ///< Used by the performer: the signal is constant for the current vector.
+    };
+
+
     /// Inheriting from sample_operator extends your class functionality to processing audio
     /// by calculating samples one at a time using the call operator member of your class.
     ///
@@ -23,6 +33,19 @@ namespace c74::min {
     /// samples<2> operator() (sample input1, sample input2, sample input3);
     /// @endcode
     ///
+    /// If your call operator is free of per-sample state (e.g. a gain stage or a waveshaper) you may also declare
+    /// #MIN_BATCH_LANES and implement the call operator as a template on the sample type.
+    /// The performer will then call it with lanes<N> packs of consecutive samples and only process the remaining tail
+    /// of each vector one sample at a time:
+    /// @code
+    /// MIN_BATCH_LANES { 4 };
+    ///
+    /// template<class T>
+    /// T operator() (T input) {
+    ///     return input * m_gain;
+    /// }
+    /// @endcode
+    ///
     /// @tparam input_count_param		The number of audio inputs for your object.
     /// @tparam output_count_param	The number of audio outputs for your object.
 
@@ -93,6 +116,41 @@ namespace c74::min {
             return m_vector_size;
         }
 
+        /// Get the queue of sample-accurate events for this object.
+        /// @return	The queue, or nullptr if the object has not declared an audio_event_queue member.
+
+        audio_event_queue* event_queue() const {
+            return m_event_queue;
+        }
+
+
+        /// Attach a queue of sample-accurate events to this object.
+        /// You will not typically have any need to call this.
+        /// It is called by the constructor of audio_event_queue.
+        /// @param	a_queue		The queue to attach.
+
+        void event_queue(audio_event_queue* a_queue) {
+            m_event_queue = a_queue;
+        }
+
+
+        /// Get the oversampler for this object.
+        /// @return	The oversampler, or nullptr if the object has not declared an oversampler member.
+
+        oversampler* oversampling() const {
+            return m_oversampler;
+        }
+
+
+        /// Attach an oversampler to this object.
+        /// You will not typically have any need to call this.
+        /// It is called by the constructor of oversampler.
+        /// @param	an_oversampler	The oversampler to attach.
+
+        void oversampling(oversampler* an_oversampler) {
+            m_oversampler = an_oversampler;
+        }
+
 
         // Ideally we would also declare a pure virtual function call operator
         // for the inheriting class to implement.
@@ -109,7 +167,9 @@ namespace c74::min {
         double m_samplerate {c74::max::sys_getsr()};    // initialized to the global samplerate, but updated to the local samplerate when the
                                                        // dsp chain is compiled.
         int m_vector_size {c74::max::sys_getblksize()};    // ...
-        vector<std::pair<int,attribute_base*>> m_attributes_mapped_to_inlets;
+        vector<attribute_mapping> m_attributes_mapped_to_inlets;
+        audio_event_queue* m_event_queue { nullptr };
+        oversampler* m_oversampler { nullptr };
     };
 
 
@@ -123,7 +183,51 @@ namespace c74::min {
         for (auto i=0; i<inlets.size(); ++i) {
             auto& inlet = inlets[i];
             if (inlet->has_signal_connection() && inlet->has_attribute_mapping())
-                attrs.push_back( { i, inlet->attribute() } );
+                attrs.push_back( { i, inlet->attribute(), inlet->attribute()->signal_setter_function() } );
+        }
+    }
+
+
+    // Update the attributes mapped to audio inlets prior to processing a vector.
+    // Signals that are constant for the entire vector (e.g. a sig~ object) are assigned here once
+    // so that the per-sample update can skip them.
+
+    inline void perform_mapped_attributes_begin(vector<attribute_mapping>& attrs, const double** in_chans, const long sampleframes) {
+        for (auto& mapping : attrs) {
+            mapping.constant = false;
+
+            if (mapping.setter) {
+                const auto samps { in_chans[mapping.inlet] };
+                const auto first { samps[0] };
+                auto       same  { true };
+
+                for (auto i = 1; i < sampleframes; ++i)
+                    same &= (samps[i] == first);
+
+                if (same) {
+                    mapping.setter(*mapping.attr, first);
+                    mapping.constant = true;
+                }
+            }
+        }
+    }
+
+
+    // Update the attributes mapped to audio inlets for a single sample.
+
+    inline void perform_mapped_attributes(vector<attribute_mapping>& attrs, const double** in_chans, const long index) {
+        for (auto& mapping : attrs) {
+            if (mapping.constant)
+                continue;
+
+            const auto value { in_chans[mapping.inlet][index] };
+
+            if (mapping.setter)
+                mapping.setter(*mapping.attr, value);
+            else {
+                atoms a {{value}};
+                mapping.attr->set(a, false, false);
+            }
         }
     }
 
@@ -194,12 +298,147 @@ namespace c74::min {
     }
 
 
+    /// Declare that the call operator of your sample_operator<> class may be called with lanes<N> packs of samples.
+    /// The value given is the number of lanes, e.g. `MIN_BATCH_LANES { 4 };`
+    /// @see lanes
+
+    #define MIN_BATCH_LANES static constexpr size_t batch_lanes
+
+
+    // SFINAE implementation used internally to determine if the Min class has
+    // declared a batch width using the macro above.
+
+    template<typename min_class_type>
+    struct has_batch_lanes {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::batch_lanes)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+    // The batched counterpart to callable_samples:
+    // a container of N packs of samples, one for each inlet, that then makes a call to be processed by a sample_operator<>.
+
+    template<class min_class_type, int count, size_t width>
+    struct callable_lanes {
+
+        explicit callable_lanes(minwrap<min_class_type>* a_self)
+        : self(a_self)
+        {}
+
+        void load(const size_t index, const sample* source) {
+            data[index] = lanes<width>::load(source);
+        }
+
+        void set(const size_t index, const sample value) {
+            data[index] = lanes<width>(value);
+        }
+
+        auto call() {
+            return call(detail::gen_seq<count>());
+        }
+
+        template<int... Is>
+        auto call(detail::seq<Is...>) {
+            return self->m_min_object(data[Is]...);
+        }
+
+        lane_samples<count, width> data;
+        minwrap<min_class_type>*   self;
+    };
+
+
+    // version of perform_copy_batch_output() for lane_samples<N,W> returned by a batched call operator.
+
+    template<class min_class_type, size_t count, size_t width>
+    void perform_copy_batch_output(minwrap<min_class_type>* self, const size_t index, double** out_chans, const lane_samples<count, width>& vals) {
+        for (size_t chan = 0; chan < count; ++chan)
+            vals[chan].store(out_chans[chan] + index);
+    }
+
+
+    // version of perform_copy_batch_output() for a single pack returned by a batched call operator.
+
+    template<class min_class_type, size_t width>
+    void perform_copy_batch_output(minwrap<min_class_type>* self, const size_t index, double** out_chans, const lanes<width>& vals) {
+        vals.store(out_chans[0] + index);
+    }
+
+
+    // Process one pack of frames for a sample_operator<> with outputs.
+    // Only the inputs with a bit set in the signal_mask are loaded, the others hold the value set by perform_batch().
+
+    template<class min_class_type, int signal_mask, size_t width, typename enable_if<(min_class_type::output_count() > 0), int>::type = 0>
+    void perform_batch_frame(minwrap<min_class_type>* self, callable_lanes<min_class_type, min_class_type::input_count(), width>& ins, const size_t index, const double** in_chans, double** out_chans) {
+        for (size_t chan = 0; chan < min_class_type::input_count(); ++chan) {
+            if (signal_mask & (1 << chan))
+                ins.load(chan, in_chans[chan] + index);
+        }
+        perform_copy_batch_output(self, index, out_chans, ins.call());
+    }
+
+
+    // Process one pack of frames for a sample_operator<> without outputs.
+
+    template<class min_class_type, int signal_mask, size_t width, typename enable_if<(min_class_type::output_count() == 0), int>::type = 0>
+    void perform_batch_frame(minwrap<min_class_type>* self, callable_lanes<min_class_type, min_class_type::input_count(), width>& ins, const size_t index, const double** in_chans, double** out_chans) {
+        for (size_t chan = 0; chan < min_class_type::input_count(); ++chan) {
+            if (signal_mask & (1 << chan))
+                ins.load(chan, in_chans[chan] + index);
+        }
+        ins.call();
+    }
+
+
+    // Process as many whole packs of frames as fit in the vector when the Min class declares MIN_BATCH_LANES.
+    // Returns the number of frames processed so that the performer can finish the tail one sample at a time.
+    // Inputs without a bit in the signal_mask have no signal connection: their value is read once and copied to every lane.
+
+    template<class min_class_type, int signal_mask = -1>
+    typename enable_if<has_batch_lanes<min_class_type>::value, long>::type
+    perform_batch(minwrap<min_class_type>* self, const double** in_chans, double** out_chans, const long sampleframes) {
+        constexpr auto width       = min_class_type::batch_lanes;
+        const auto     batchframes = sampleframes - (sampleframes % static_cast<long>(width));
+
+        callable_lanes<min_class_type, min_class_type::input_count(), width> ins(self);
+
+        for (size_t chan = 0; chan < min_class_type::input_count(); ++chan) {
+            if (!(signal_mask & (1 << chan)))
+                ins.set(chan, in_chans[chan][0]);
+        }
+
+        for (long i = 0; i < batchframes; i += width)
+            perform_batch_frame<min_class_type, signal_mask, width>(self, ins, i, in_chans, out_chans);
+        return batchframes;
+    }
+
+
+    // Classes that do not declare MIN_BATCH_LANES are processed entirely one sample at a time.
+
+    template<class min_class_type, int signal_mask = -1>
+    typename enable_if<!has_batch_lanes<min_class_type>::value, long>::type
+    perform_batch(minwrap<min_class_type>* self, const double** in_chans, double** out_chans, const long sampleframes) {
+        return 0;
+    }
+
+
     // The performer class wraps the C callback routine for a Max audio "perform" method.
     // It adapts the calls coming from the Max application to the call operator implemented in the Min class.
     // The correct version of this enabled using SFINAE template enabling depending on whether this is a
     // vector_operator<> or one of the sample_operator<> extending class.
     //
     // For sample_operator<> there are several versions of this wrapping/adapting callback.
+    //
+    // All of these versions read every input for a frame (or a pack of frames) before writing any output for that frame.
+    // They are thus safe for MSP to process in-place when a class declares audio_flags::inplace.
     // This one is optimized for the most common case: a single input and a single output.
 
     template<class min_class_type>
@@ -211,7 +450,7 @@ namespace c74::min {
             auto in_samps  = in_chans[0];
             auto out_samps = out_chans[0];
 
-            for (auto i = 0; i < sampleframes; ++i) {
+            for (auto i = perform_batch(self, in_chans, out_chans, sampleframes); i < sampleframes; ++i) {
                 auto in      = in_samps[i];
                 auto out     = self->m_min_object(in);
                 out_samps[i] = out;
@@ -231,7 +470,7 @@ namespace c74::min {
         static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
             auto in_samps = in_chans[0];
 
-            for (auto i = 0; i < sampleframes; ++i) {
+            for (auto i = perform_batch(self, in_chans, out_chans, sampleframes); i < sampleframes; ++i) {
                 auto in = in_samps[i];
                 self->m_min_object(in);
             }
@@ -257,7 +496,7 @@ namespace c74::min {
 
                 // the typical case:
 
-                for (auto i = 0; i < sampleframes; ++i) {
+                for (auto i = perform_batch(self, in_chans, out_chans, sampleframes); i < sampleframes; ++i) {
                     callable_samples<min_class_type, min_class_type::input_count()> ins(self);
 
                     for (auto chan = 0; chan < input_count; ++chan)
@@ -273,17 +512,12 @@ namespace c74::min {
 
                 // the case where audio inlets are mapped to attributes
 
+                perform_mapped_attributes_begin(attrs, in_chans, sampleframes);
+
                 for (auto i = 0; i < sampleframes; ++i) {
                     callable_samples<min_class_type, min_class_type::input_count()> ins(self);
 
-                    for (auto& inletnum_and_attr : attrs) {
-                        int 			inletnum { inletnum_and_attr.first };
-                        attribute_base*	attr { inletnum_and_attr.second };
-                        auto			value { in_chans[inletnum][i] };
-                        atoms			a {{value}};
-
-                        attr->set(a, false, false);
-                    }
+                    perform_mapped_attributes(attrs, in_chans, i);
 
                     for (auto chan = 0; chan < input_count; ++chan)
                         ins.set(chan, in_chans[chan][i]);
@@ -297,4 +531,138 @@ namespace c74::min {
         }
     };
 
+
+    // The largest number of inputs for which perform routines are specialized on which inputs carry signals.
+    // Each additional input doubles the number of instantiations.
+
+    static constexpr size_t k_max_scalar_inputs = 4;
+
+
+    // The perform routine used in place of performer<>::perform() when some inputs have no signal connection.
+    // MSP passes a constant vector to such an input, so its value is read once per vector and held for the whole vector
+    // rather than being loaded for every sample.
+    // The signal_mask has a bit set for each input that carries a signal, so the test of each bit is resolved at compile time.
+    // As with the other performers, every input for a frame is read before any output for that frame is written.
+
+    template<class min_class_type, int signal_mask>
+    struct scalar_input_performer {
+        static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+            callable_samples<min_class_type, min_class_type::input_count()> ins(self);
+
+            for (size_t chan = 0; chan < min_class_type::input_count(); ++chan) {
+                if (!(signal_mask & (1 << chan)))
+                    ins.set(chan, in_chans[chan][0]);
+            }
+
+            for (auto i = perform_batch<min_class_type, signal_mask>(self, in_chans, out_chans, sampleframes); i < sampleframes; ++i) {
+                for (size_t chan = 0; chan < min_class_type::input_count(); ++chan) {
+                    if (signal_mask & (1 << chan))
+                        ins.set(chan, in_chans[chan][i]);
+                }
+                perform_copy_output(self, i, out_chans, ins.call());
+            }
+        }
+    };
+
+
+    // Select the scalar_input_performer<> for a combination of connected inputs from a table of all combinations.
+
+    template<class min_class_type, int... signal_masks>
+    max::t_perfroutine64 min_dsp64_perform_scalar_inputs(minwrap<min_class_type>* self, const int signal_mask, detail::seq<signal_masks...>) {
+        using selector = max::t_perfroutine64 (*)(minwrap<min_class_type>*);
+
+        static constexpr selector selectors[] = { min_dsp64_perform_events<min_class_type, scalar_input_performer<min_class_type, signal_masks>::perform>... };
+        return selectors[signal_mask](self);
+    }
+
+
+    // Select a perform routine according to which inputs have a signal connection.
+    // The regular performer is used if all inputs carry signals or if any input is mapped to an attribute.
+
+    template<class min_class_type, typename enable_if<(min_class_type::input_count() > 0 && min_class_type::input_count() <= k_max_scalar_inputs
+        && min_class_type::output_count() > 0), int>::type = 0>
+    max::t_perfroutine64 min_dsp64_perform_inputs(minwrap<min_class_type>* self) {
+        constexpr auto  all_signals = (1 << min_class_type::input_count()) - 1;
+        auto&           inlets      = self->m_min_object.inlets();
+        auto            signal_mask = 0;
+
+        for (size_t chan = 0; chan < min_class_type::input_count(); ++chan) {
+            if (inlets[chan]->has_signal_connection())
+                signal_mask |= 1 << chan;
+        }
+
+        if (signal_mask == all_signals || !self->m_min_object.mapped_attributes().empty())
+            return min_dsp64_perform_events<min_class_type, performer<min_class_type>::perform>(self);
+        return min_dsp64_perform_scalar_inputs(self, signal_mask, detail::gen_seq<all_signals>());
+    }
+
+    template<class min_class_type, typename enable_if<!(min_class_type::input_count() > 0 && min_class_type::input_count() <= k_max_scalar_inputs
+        && min_class_type::output_count() > 0), int>::type = 0>
+    max::t_perfroutine64 min_dsp64_perform_inputs(minwrap<min_class_type>* self) {
+        return min_dsp64_perform_events<min_class_type, performer<min_class_type>::perform>(self);
+    }
+
+
+    // The perform routine used in place of performer<>::perform() when the Min class has an oversampler.
+    // The inputs are upsampled, the regular performer is called at the oversampled rate, and the outputs are decimated.
+    // A change of the factor switches between the filters allocated by min_dsp64_oversampling() without sending dspsetup,
+    // which may allocate, so only the samplerate and vector size reported by the class follow the factor.
+
+    template<class min_class_type>
+    void perform_oversampled(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+        auto& os = *self->m_min_object.oversampling();
+
+        os.update();
+
+        if (!os.active(numins, numouts, sampleframes)) {
+            self->m_min_object.samplerate(os.base_samplerate());
+            self->m_min_object.vector_size(static_cast<int>(os.base_vector_size()));
+            performer<min_class_type>::perform(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, 0, nullptr);
+            return;
+        }
+
+        self->m_min_object.samplerate(os.samplerate());
+        self->m_min_object.vector_size(static_cast<int>(os.vector_size()));
+
+        // all inputs are read before any output is written, so this is safe for in-place processing
+        auto ins    = os.upsample(in_chans, numins, sampleframes);
+        auto outs   = os.outputs(numouts);
+
+        performer<min_class_type>::perform(self, dsp64, const_cast<const double**>(ins), numins, outs, numouts, sampleframes * os.factor(), 0, nullptr);
+        os.downsample(out_chans, numouts, sampleframes);
+    }
+
+
+    // If the Min class has an oversampler its memory is allocated for every factor when the dsp chain is compiled.
+    // The storage of smoothed members is allocated for the largest factor, as the factor may change while audio is running.
+    // The samplerate and vector size of the class are then set to those at which the call operator will run,
+    // so that they are already correct when the dspsetup message of the class is called.
+
+    template<class min_class_type, enable_if_sample_operator<min_class_type> = 0>
+    void min_dsp64_oversampling(minwrap<min_class_type>* self) {
+        auto os = self->m_min_object.oversampling();
+
+        if (os == nullptr)
+            return;
+
+        os->dspsetup(min_class_type::input_count(), min_class_type::output_count(), self->m_min_object.samplerate(), self->m_min_object.vector_size());
+        for (auto a_smoothed : self->m_min_object.smoothed_attributes())
+            a_smoothed->dspsetup(os->max_vector_size());
+
+        self->m_min_object.samplerate(os->samplerate());
+        self->m_min_object.vector_size(static_cast<int>(os->vector_size()));
+    }
+
+
+    // The min_dsp64_perform function selects the perform routine for the Min class.
+    // If the class has an oversampler, prepared by min_dsp64_oversampling(), the oversampling perform routine is used.
+    // Otherwise the perform routine is specialized on which inputs have a signal connection.
+
+    template<class min_class_type, enable_if_sample_operator<min_class_type> = 0>
+    max::t_perfroutine64 min_dsp64_perform(minwrap<min_class_type>* self) {
+        if (self->m_min_object.oversampling() == nullptr)
+            return min_dsp64_perform_inputs(self);
+        return min_dsp64_perform_events<min_class_type, perform_oversampled<min_class_type>>(self);
+    }
+
 }    // namespace c74::min
@@ -0,0 +1,466 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A spectral bundle is a container for N channels of the spectrum of one frame of audio.
+    /// Each channel has the same number of bins, from 0 Hz up to and including the Nyquist frequency.
+
+    struct spectral_bundle {
+
+        /// Create a spectral bundle from an existing array of channels of bins.
+        /// This is used internally by Min to pass frames to a spectral_operator class.
+        /// @param	bins			A pointer to an array of pointers to the bins of each channel.
+        /// @param	channel_count	The number of channels.
+        /// @param	bin_count		The number of bins in each channel.
+
+        spectral_bundle(std::complex<sample>** bins, const long channel_count, const long bin_count)
+        : m_bins { bins }
+        , m_channel_count { channel_count }
+        , m_bin_count { bin_count }
+        {}
+
+
+        /// Get a pointer to the bins for a specific channel.
+        /// @param	channel		The channel for which to fetch the pointer.
+        ///						NOTE: No bounds checking is performed!
+        /// @return				A pointer to the first bin of the specified channel.
+
+        std::complex<sample>* bins(const size_t channel) {
+            return m_bins[channel];
+        }
+
+
+        /// Determine the number of channels in a spectral bundle.
+        /// @return		The number of channels.
+
+        long channel_count() const {
+            return m_channel_count;
+        }
+
+
+        /// Determine the number of bins in each channel of a spectral bundle.
+        /// @return		The number of bins, which is half the frame size plus one.
+
+        long bin_count() const {
+            return m_bin_count;
+        }
+
+    private:
+        std::complex<sample>**  m_bins { nullptr };
+        long                    m_channel_count {};
+        long                    m_bin_count {};
+    };
+
+
+    /// The machinery of a short-time Fourier transform with overlap-add resynthesis.
+    ///
+    /// Incoming audio is collected into frames of frame_size() samples, which start every hop_size() samples.
+    /// Each frame is windowed and transformed to a spectrum, the spectrum is processed by a callback,
+    /// and the result is transformed back, windowed again, and added into the output.
+    /// The square root of a periodic Hann window is used for both analysis and synthesis,
+    /// so that an unaltered spectrum is reconstructed exactly with a latency of frame_size() samples.
+    ///
+    /// All memory is allocated by dspsetup(), which prepares new storage completely before replacing the old.
+    /// process() neither allocates nor locks and processes any number of samples, independent of the frame size.
+
+    class overlap_add {
+    public:
+        /// Allocate all working memory.
+        /// This is called when the dsp chain is compiled and should not be called from the audio thread.
+        /// @param	input_count		The number of channels analysed.
+        /// @param	output_count	The number of channels synthesized.
+        /// @param	frame_size		The number of samples in each frame. Must be a power of two no smaller than 4.
+        /// @param	overlap			The number of frames that overlap each sample. Must be a power of two between 2 and the frame size.
+
+        void dspsetup(const size_t input_count, const size_t output_count, const size_t frame_size, const size_t overlap) {
+            assert(frame_size >= 4 && (frame_size & (frame_size - 1)) == 0);
+            assert(overlap >= 2 && overlap <= frame_size && (overlap & (overlap - 1)) == 0);
+
+            const auto  bin_count = frame_size / 2 + 1;
+            overlap_add next;
+
+            // all of the new storage is allocated before any of the old storage is replaced
+            next.m_fft.resize(frame_size);
+            next.m_hop_size = static_cast<long>(frame_size / overlap);
+
+            next.m_analysis_window.resize(frame_size);
+            next.m_synthesis_window.resize(frame_size);
+            for (size_t n = 0; n < frame_size; ++n) {
+                next.m_analysis_window[n]   = std::sqrt(0.5 - 0.5 * std::cos(2.0 * k_pi * n / frame_size));
+                next.m_synthesis_window[n]  = next.m_analysis_window[n] * 2.0 / overlap;    // the overlapping Hann windows sum to overlap/2
+            }
+
+            next.m_frame.assign(frame_size, 0.0);
+            next.m_inputs.assign(input_count, sample_vector(frame_size, 0.0));
+            next.m_outputs.assign(output_count, sample_vector(frame_size, 0.0));
+            next.m_input_bins.assign(input_count, vector<std::complex<sample>>(bin_count));
+            next.m_output_bins.assign(output_count, vector<std::complex<sample>>(bin_count));
+
+            next.m_input_bin_pointers.resize(input_count);
+            for (size_t channel = 0; channel < input_count; ++channel)
+                next.m_input_bin_pointers[channel] = next.m_input_bins[channel].data();
+            next.m_output_bin_pointers.resize(output_count);
+            for (size_t channel = 0; channel < output_count; ++channel)
+                next.m_output_bin_pointers[channel] = next.m_output_bins[channel].data();
+
+            // moving the vectors keeps their memory, so the bin pointers remain valid
+            *this = std::move(next);
+        }
+
+
+        /// Return the number of samples in each frame.
+        /// @return	The frame size set by dspsetup().
+
+        long frame_size() const {
+            return static_cast<long>(m_fft.size());
+        }
+
+
+        /// Return the number of samples between the start of consecutive frames.
+        /// @return	The hop size set by dspsetup().
+
+        long hop_size() const {
+            return m_hop_size;
+        }
+
+
+        /// Return the delay between the input and the output.
+        /// @return	The latency in samples, which is the frame size.
+
+        long latency() const {
+            return frame_size();
+        }
+
+
+        /// Process a vector of audio.
+        /// Every input for a sample is read before the output for that sample is written, so this is safe for in-place processing.
+        /// @param	in_chans		The input channels.
+        /// @param	numins			The number of input channels.
+        /// @param	out_chans		The output channels.
+        /// @param	numouts			The number of output channels.
+        /// @param	sampleframes	The number of samples in each channel.
+        /// @param	callback		A callable taking (spectral_bundle input, spectral_bundle output), called once for each frame.
+        ///							The output bins are initialized with a copy of the input bins of the same channel (or zeros).
+
+        template<class callback_type>
+        void process(const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, callback_type&& callback) {
+            const auto input_count  = static_cast<long>(m_inputs.size());
+            const auto output_count = static_cast<long>(m_outputs.size());
+            long       start        = 0;
+
+            while (start < sampleframes) {
+                const auto count = std::min(sampleframes - start, m_hop_size - m_hop_position);
+
+                for (auto channel = 0; channel < input_count; ++channel) {
+                    if (channel < numins)
+                        simd::copy(m_inputs[channel].data() + m_position, in_chans[channel] + start, count);
+                    else
+                        simd::clear(m_inputs[channel].data() + m_position, count);
+                }
+
+                for (auto channel = 0; channel < numouts; ++channel) {
+                    if (channel < output_count) {
+                        auto accumulated = m_outputs[channel].data() + m_position;
+                        simd::copy(out_chans[channel] + start, accumulated, count);
+                        simd::clear(accumulated, count);
+                    }
+                    else
+                        simd::clear(out_chans[channel] + start, count);
+                }
+
+                start           += count;
+                m_position      += count;
+                m_hop_position  += count;
+
+                if (m_hop_position == m_hop_size) {
+                    m_hop_position = 0;
+                    if (m_position == frame_size())
+                        m_position = 0;
+                    process_frame(callback);
+                }
+            }
+        }
+
+    private:
+        static constexpr double k_pi = 3.14159265358979323846;
+
+        fft                                 m_fft;
+        long                                m_hop_size { 0 };
+        long                                m_position { 0 };        // where the next sample is written in the circular buffers
+        long                                m_hop_position { 0 };    // the number of samples received since the last frame
+        sample_vector                       m_analysis_window;
+        sample_vector                       m_synthesis_window;
+        sample_vector                       m_frame;
+        vector<sample_vector>               m_inputs;                // circular buffers of the most recent frame of input
+        vector<sample_vector>               m_outputs;               // circular buffers of output being accumulated
+        vector<vector<std::complex<sample>>> m_input_bins;
+        vector<vector<std::complex<sample>>> m_output_bins;
+        vector<std::complex<sample>*>       m_input_bin_pointers;
+        vector<std::complex<sample>*>       m_output_bin_pointers;
+
+
+        // Analyse the most recent frame, pass it to the callback, and add the resynthesized frame to the output.
+        // The oldest sample of the frame is at m_position in the circular buffers,
+        // and so is the next sample of output to be read.
+
+        template<class callback_type>
+        void process_frame(callback_type& callback) {
+            const auto size         = frame_size();
+            const auto wrap         = size - m_position;
+            const auto bin_count    = size / 2 + 1;
+            auto       frame        = m_frame.data();
+            auto       window       = m_analysis_window.data();
+
+            for (size_t channel = 0; channel < m_inputs.size(); ++channel) {
+                const auto input = m_inputs[channel].data();
+
+                for (auto n = 0; n < wrap; ++n)
+                    frame[n] = input[m_position + n] * window[n];
+                for (auto n = wrap; n < size; ++n)
+                    frame[n] = input[n - wrap] * window[n];
+                m_fft.forward(frame, m_input_bins[channel].data());
+            }
+
+            for (size_t channel = 0; channel < m_outputs.size(); ++channel) {
+                if (channel < m_inputs.size())
+                    std::copy(m_input_bins[channel].begin(), m_input_bins[channel].end(), m_output_bins[channel].begin());
+                else
+                    std::fill(m_output_bins[channel].begin(), m_output_bins[channel].end(), std::complex<sample> {});
+            }
+
+            callback(spectral_bundle { m_input_bin_pointers.data(), static_cast<long>(m_inputs.size()), bin_count },
+                spectral_bundle { m_output_bin_pointers.data(), static_cast<long>(m_outputs.size()), bin_count });
+
+            window = m_synthesis_window.data();
+
+            for (size_t channel = 0; channel < m_outputs.size(); ++channel) {
+                auto output = m_outputs[channel].data();
+
+                m_fft.inverse(m_output_bins[channel].data(), frame);
+                for (auto n = 0; n < wrap; ++n)
+                    output[m_position + n] += frame[n] * window[n];
+                for (auto n = wrap; n < size; ++n)
+                    output[n - wrap] += frame[n] * window[n];
+            }
+        }
+    };
+
+
+    // Represents any specialized type of spectral_operator<>.
+
+    class spectral_operator_base {};
+
+
+    /// Inherit from spectral_operator to extend your class for processing audio in the frequency domain.
+    ///
+    /// Min collects the incoming audio into overlapping frames, windows them, and transforms them to spectra.
+    /// Your call operator is then called once for each frame with the spectra of all inputs
+    /// and the spectra of all outputs, which it is to fill.
+    /// The output spectra initially hold a copy of the input spectra, so an empty call operator passes the audio through.
+    /// The frames are transformed back, windowed, and overlapped to produce the output.
+    /// @code
+    /// void operator()(spectral_bundle input, spectral_bundle output) {
+    ///     auto bins = output.bins(0);
+    ///     for (auto i = 0; i < output.bin_count(); ++i)
+    ///         bins[i] *= m_gains[i];
+    /// }
+    /// @endcode
+    ///
+    /// The frame size and overlap are independent of the vector size of MSP.
+    /// They may be changed at any time, e.g. by an attribute setter, and take effect the next time the dsp chain is compiled,
+    /// when all working memory is allocated.
+    /// The output is delayed by the frame size.
+    ///
+    /// @tparam input_count_param		The number of audio inputs for your object.
+    /// @tparam output_count_param		The number of audio outputs for your object.
+    /// @see	fft
+
+    template<size_t input_count_param, size_t output_count_param>
+    class spectral_operator : public spectral_operator_base {
+    public:
+        /// Return the number of audio inputs for this spectral operator class.
+        /// @return The number of audio inputs.
+
+        static constexpr size_t input_count() {
+            return input_count_param;
+        }
+
+
+        /// Return the number of audio outputs for this spectral operator class.
+        /// @return The number of audio outputs.
+
+        static constexpr size_t output_count() {
+            return output_count_param;
+        }
+
+
+        ///	Set a new samplerate.
+        /// You will not typically have any need to call this.
+        /// It is called internally any time the dsp chain containing your object is compiled.
+        /// @param	a_samplerate	A new samplerate with which your object will be updated.
+
+        void samplerate(const double a_samplerate) {
+            m_samplerate = a_samplerate;
+        }
+
+
+        /// Return the current samplerate for this object's signal chain.
+        /// @return	The samplerate in hz.
+
+        double samplerate() const {
+            return m_samplerate;
+        }
+
+
+        ///	Set a new vector size.
+        /// You will not typically have any need to call this.
+        /// It is called internally any time the dsp chain containing your object is compiled.
+        /// @param	a_vector_size	A new vector size with which your object will be updated.
+
+        void vector_size(const int a_vector_size) {
+            m_vector_size = a_vector_size;
+        }
+
+
+        /// Return the current vector size for this object's signal chain.
+        /// @return	The vector size in samples.
+
+        int vector_size() const {
+            return m_vector_size;
+        }
+
+
+        /// Set the number of samples in each frame.
+        /// Takes effect the next time the dsp chain is compiled.
+        /// @param	a_frame_size	The frame size, which is rounded up to a power of two no smaller than 16.
+
+        void frame_size(const size_t a_frame_size) {
+            size_t size = 16;
+            while (size < a_frame_size)
+                size *= 2;
+            m_frame_size = size;
+        }
+
+
+        /// Return the number of samples in each frame.
+        /// @return	The frame size that will be used the next time the dsp chain is compiled.
+
+        size_t frame_size() const {
+            return m_frame_size;
+        }
+
+
+        /// Set the number of frames that overlap each sample.
+        /// Takes effect the next time the dsp chain is compiled.
+        /// @param	an_overlap	The overlap, which is rounded up to a power of two no smaller than 2.
+
+        void overlap(const size_t an_overlap) {
+            size_t value = 2;
+            while (value < an_overlap)
+                value *= 2;
+            m_overlap = value;
+        }
+
+
+        /// Return the number of frames that overlap each sample.
+        /// @return	The overlap that will be used the next time the dsp chain is compiled.
+
+        size_t overlap() const {
+            return m_overlap;
+        }
+
+
+        /// Return the frequency at the center of a bin.
+        /// @param	a_bin	The index of the bin.
+        /// @return			The frequency in hz, for the frame size currently in use.
+
+        double bin_frequency(const size_t a_bin) const {
+            return a_bin * m_samplerate / m_frames.frame_size();
+        }
+
+
+        /// Get the overlap-add machinery for this object.
+        /// You will not typically have any need to call this.
+        /// @return	The overlap_add used by the performer.
+
+        overlap_add& frames() {
+            return m_frames;
+        }
+
+
+        /// Get the queue of sample-accurate events for this object.
+        /// @return	The queue, or nullptr if the object has not declared an audio_event_queue member.
+
+        audio_event_queue* event_queue() const {
+            return m_event_queue;
+        }
+
+
+        /// Attach a queue of sample-accurate events to this object.
+        /// You will not typically have any need to call this.
+        /// It is called by the constructor of audio_event_queue.
+        /// @param	a_queue		The queue to attach.
+
+        void event_queue(audio_event_queue* a_queue) {
+            m_event_queue = a_queue;
+        }
+
+
+        /// All classes extending spectral_operator<> must implement this operator
+        /// which is called once for each frame.
+        /// @param	input	The spectra of the inputs.
+        /// @param	output	The spectra of the outputs.
+
+        virtual void operator()(spectral_bundle input, spectral_bundle output) = 0;
+
+    private:
+        double              m_samplerate { c74::max::sys_getsr() };
+        int                 m_vector_size { c74::max::sys_getblksize() };
+        size_t              m_frame_size { 1024 };
+        size_t              m_overlap { 4 };
+        overlap_add         m_frames;
+        audio_event_queue*  m_event_queue { nullptr };
+    };
+
+
+    template<class min_class_type, enable_if_spectral_operator<min_class_type> = 0>
+    void min_dsp64_attrmap(minwrap<min_class_type>* self, const short* count)
+    {}
+
+
+    // The performer class wraps the C callback routine for a Max audio "perform" method.
+    // This specialization is for spectral_operator<> classes:
+    // the audio is passed through the overlap-add machinery, which calls the Min class for each frame.
+
+    template<class min_class_type>
+    class performer<min_class_type, typename enable_if<is_base_of<spectral_operator_base, min_class_type>::value>::type> {
+    public:
+        static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+            auto& object = self->m_min_object;
+
+            object.frames().process(in_chans, numins, out_chans, numouts, sampleframes, [&object](spectral_bundle input, spectral_bundle output) {
+                object(input, output);
+            });
+        }
+    };
+
+
+    // The min_dsp64_perform function selects the perform routine for the Min class.
+    // The working memory for the frame size and overlap of the spectral_operator<> is allocated here,
+    // when the dsp chain is compiled.
+
+    template<class min_class_type, enable_if_spectral_operator<min_class_type> = 0>
+    max::t_perfroutine64 min_dsp64_perform(minwrap<min_class_type>* self) {
+        auto& object = self->m_min_object;
+
+        object.frames().dspsetup(min_class_type::input_count(), min_class_type::output_count(), object.frame_size(), std::min(object.overlap(), object.frame_size()));
+        return min_dsp64_perform_events<min_class_type, performer<min_class_type>::perform>(self);
+    }
+
+}    // namespace c74::min
@@ -67,10 +67,8 @@ namespace c74::min {
         /// Zero-out the data in the entire audio bundle.
 
         void clear() {
-            for (auto channel = 0; channel < m_channel_count; ++channel) {
-                for (auto i = 0; i < m_frame_count; ++i)
-                    m_samples[channel][i] = 0.0;
-            }
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                simd::clear(m_samples[channel], m_frame_count);
         }
 
 
@@ -91,11 +89,89 @@ namespace c74::min {
             assert(m_channel_count <= other.m_channel_count);
             assert(m_frame_count == other.m_frame_count);
 
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                simd::copy(m_samples[channel], other.m_samples[channel], m_frame_count);
+            return *this;
+        }
+
+
+        /// Add the contents of another audio_bundle to this audio_bundle, channel by channel.
+        /// The same requirements for channel count and framesize apply as for the copy assignment operator.
+        /// @param	other	The audio_bundle to add.
+
+        void add(const audio_bundle& other) {
+            assert(m_channel_count <= other.m_channel_count);
+            assert(m_frame_count == other.m_frame_count);
+
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                simd::add(m_samples[channel], other.m_samples[channel], m_frame_count);
+        }
+
+
+        /// Add the contents of another audio_bundle, scaled by a gain, to this audio_bundle, channel by channel.
+        /// The same requirements for channel count and framesize apply as for the copy assignment operator.
+        /// @param	other	The audio_bundle to scale and add.
+        /// @param	gain	The linear gain applied to the other audio_bundle.
+
+        void multiply_add(const audio_bundle& other, const sample gain) {
+            assert(m_channel_count <= other.m_channel_count);
+            assert(m_frame_count == other.m_frame_count);
+
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                simd::multiply_add(m_samples[channel], other.m_samples[channel], gain, m_frame_count);
+        }
+
+
+        /// Scale the entire audio bundle by a gain.
+        /// @param	gain	The linear gain to apply.
+
+        void gain(const sample gain) {
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                simd::gain(m_samples[channel], m_samples[channel], gain, m_frame_count);
+        }
+
+
+        /// Scale the entire audio bundle by a linear ramp from one gain to another.
+        /// The ramp ends one sample past the end of the vector so that the next vector can begin at end_gain.
+        /// @param	start_gain	The linear gain applied to the first sample.
+        /// @param	end_gain	The linear gain at which the ramp ends.
+
+        void gain_ramp(const sample start_gain, const sample end_gain) {
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                simd::gain_ramp(m_samples[channel], m_samples[channel], start_gain, end_gain, m_frame_count);
+        }
+
+
+        /// Replace the contents of this audio_bundle with a mix of a source with more channels.
+        /// Source channel N is summed into channel (N modulo channel_count()) of this audio_bundle.
+        /// No gain compensation is applied.
+        /// @param	source	The audio_bundle to mix down.
+
+        void mixdown(const audio_bundle& source) {
+            assert(m_channel_count > 0);
+            assert(m_frame_count == source.m_frame_count);
+
             for (auto channel = 0; channel < m_channel_count; ++channel) {
-                for (auto i = 0; i < m_frame_count; ++i)
-                    m_samples[channel][i] = other.m_samples[channel][i];
+                if (channel < source.m_channel_count)
+                    simd::copy(m_samples[channel], source.m_samples[channel], m_frame_count);
+                else
+                    simd::clear(m_samples[channel], m_frame_count);
             }
-            return *this;
+            for (auto channel = m_channel_count; channel < source.m_channel_count; ++channel)
+                simd::add(m_samples[channel % m_channel_count], source.m_samples[channel], m_frame_count);
+        }
+
+
+        /// Replace the contents of this audio_bundle with a source with fewer channels.
+        /// Channel N of this audio_bundle is a copy of source channel (N modulo source.channel_count()).
+        /// @param	source	The audio_bundle to spread across the channels of this audio_bundle.
+
+        void upmix(const audio_bundle& source) {
+            assert(source.m_channel_count > 0);
+            assert(m_frame_count == source.m_frame_count);
+
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                simd::copy(m_samples[channel], source.m_samples[channel % source.m_channel_count], m_frame_count);
         }
 
     private:
@@ -114,22 +190,33 @@ namespace c74::min {
     struct minwrap<min_class_type, type_enable_if_audio_class<min_class_type>> {
         maxobject_header m_max_header;
         min_class_type   m_min_object;
+        long long        m_silent_frames { 0 };    // consecutive frames of silent input, see #MIN_SILENCE_TAIL
+#ifdef C74_MIN_WITH_DSP_PROFILING
+        dsp_profiler     m_dsp_profiler;
+#endif
 
 
         // Setup is called at instantiation.
+        // Unless the class declares audio_flags::inplace using #MIN_FLAGS we
+        // prevent MSP from sharing memory between input and output vectors.
 
         void setup() {
             max::dsp_setup(m_max_header, (long)m_min_object.inlets().size());
 
+            audio_flags flags = audio_flags::none;
+            class_get_flags<min_class_type>(m_min_object, flags);
+
             if (m_min_object.is_ui_class()) {
                 max::t_pxjbox* x = m_max_header;
-                x->z_misc |= Z_NO_INPLACE;
+                if (flags != audio_flags::inplace)
+                    x->z_misc |= Z_NO_INPLACE;
                 if (is_base_of<mc_operator_base, min_class_type>::value)
                     x->z_misc |= Z_MC_INLETS;
             }
             else {
                 max::t_pxobject* x = m_max_header;
-                x->z_misc |= Z_NO_INPLACE;
+                if (flags != audio_flags::inplace)
+                    x->z_misc |= Z_NO_INPLACE;
                 if (is_base_of<mc_operator_base, min_class_type>::value)
                     x->z_misc |= Z_MC_INLETS;
             }
@@ -138,6 +225,21 @@ namespace c74::min {
         }
 
 
+        // May MSP share memory between the input and output vectors of this object?
+        // Used by the render_harness<> to do the same.
+
+        bool inplace() {
+            if (m_min_object.is_ui_class()) {
+                max::t_pxjbox* x = m_max_header;
+                return (x->z_misc & Z_NO_INPLACE) == 0;
+            }
+            else {
+                max::t_pxobject* x = m_max_header;
+                return (x->z_misc & Z_NO_INPLACE) == 0;
+            }
+        }
+
+
         // Cleanup is called when the object is freed.
 
         void cleanup() {
@@ -216,6 +318,23 @@ namespace c74::min {
             return m_vector_size;
         }
 
+        /// Get the queue of sample-accurate events for this object.
+        /// @return	The queue, or nullptr if the object has not declared an audio_event_queue member.
+
+        audio_event_queue* event_queue() const {
+            return m_event_queue;
+        }
+
+
+        /// Attach a queue of sample-accurate events to this object.
+        /// You will not typically have any need to call this.
+        /// It is called by the constructor of audio_event_queue.
+        /// @param	a_queue		The queue to attach.
+
+        void event_queue(audio_event_queue* a_queue) {
+            m_event_queue = a_queue;
+        }
+
 
         /// Process one sample of audio using the derived class.
         /// This will call your Min object's operator for processing vectors with a vector size of 1.
@@ -236,6 +355,7 @@ namespace c74::min {
     private:
         double  m_samplerate { c74::max::sys_getsr() };        // initialized to the global samplerate, but updated to the local samplerate when the dsp chain is compiled.
         int     m_vector_size { c74::max::sys_getblksize() };  // ...
+        audio_event_queue*  m_event_queue { nullptr };
     };
 
 
@@ -299,6 +419,105 @@ namespace c74::min {
     };
 
 
+    // SFINAE implementation used internally to determine if the Min class declares a template struct named channel_state.
+
+    template<typename min_class_type>
+    struct has_channel_state {
+        template<typename C>
+        static std::true_type test(typename C::template channel_state<sample>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+
+    /// Declare that the channels of an mc_operator<> class with a channel_state may be processed in parallel on multiple cores.
+    /// The value given is the number of channels processed by each task, e.g. `MIN_PARALLEL_CHANNELS { 16 };`
+    /// It is rounded up to a multiple of mc_channel_storage::k_width so that each task owns whole groups of channel state.
+    /// Other classes may not declare it, as their call operator processes all channels with state shared by the whole object.
+    /// @see worker_pool
+
+    #define MIN_PARALLEL_CHANNELS static constexpr size_t parallel_channels
+
+
+    // SFINAE implementation used internally to determine if the Min class has
+    // declared parallel processing using the macro above.
+
+    template<typename min_class_type>
+    struct has_parallel_channels {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::parallel_channels)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+    /// Declare that denormal numbers should be flushed to zero while an audio class is processing,
+    /// e.g. `MIN_FLUSH_DENORMALS { true };`
+    /// @see denormal_guard
+
+    #define MIN_FLUSH_DENORMALS static constexpr bool flush_denormals
+
+
+    // SFINAE implementation used internally to determine if the Min class has
+    // declared that denormals should be flushed using the macro above.
+
+    template<typename min_class_type>
+    struct has_flush_denormals {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::flush_denormals)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+    /// Declare that an audio class may be bypassed while all of its inputs are silent.
+    /// The value given is the length of the tail, in samples, for which the class continues to produce output
+    /// after its inputs become silent, e.g. `MIN_SILENCE_TAIL { 48000 };` for a reverb with a one-second decay.
+    /// Once the tail has elapsed the call operator is no longer called and the outputs are filled with zeros
+    /// until any input is no longer silent.
+    /// Classes that produce sound without input (e.g. oscillators) must not declare a tail.
+
+    #define MIN_SILENCE_TAIL static constexpr long long silence_tail
+
+
+    // SFINAE implementation used internally to determine if the Min class has
+    // declared a silence tail using the macro above.
+
+    template<typename min_class_type>
+    struct has_silence_tail {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::silence_tail)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
     // The "dsp64" method for Max audio objects is split up into several components here.
     // The main "dsp64" method is min_dsp64(), which needs to obey basic C rules because it is called by Max.
     // This in-turn then calls min_dsp64_sel() which is a templated C++ function that is specialized based on the properties of the Min
@@ -328,49 +547,380 @@ namespace c74::min {
     {}
 
 
+    // The min_dsp64_channels function updates the number of channels of mc_operator<> classes.
+    // For all other classes the channels are fixed by the number of inlets and outlets.
+    // The mc_operator<> version is implemented in c74_min_operator_mc.h
+
+    template<class min_class_type, typename enable_if<!is_base_of<mc_operator_base, min_class_type>::value, int>::type = 0>
+    void min_dsp64_channels(minwrap<min_class_type>* self, max::t_object* dsp64)
+    {}
+
+
+    // The min_dsp64_oversampling function prepares the oversampler of a sample_operator<> class, if it has one.
+    // For all other classes the call operator runs at the samplerate of the signal chain.
+    // The sample_operator<> version is implemented in c74_min_operator_sample.h
+
+    template<class min_class_type, typename enable_if<!is_base_of<sample_operator_base, min_class_type>::value, int>::type = 0>
+    void min_dsp64_oversampling(minwrap<min_class_type>* self)
+    {}
+
+
+    // Call a perform routine from another perform routine, e.g. for part of a vector.
+    // The vector_operator<> performer takes non-const inputs while the sample_operator<> performers take const inputs,
+    // so the correct overload is chosen by the type of the perform routine.
+
+    template<class min_class_type>
+    void perform_subvector(void (*perform)(minwrap<min_class_type>*, max::t_object*, double**, const long, double**, const long, const long, const long, const void*),
+        minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes)
+    {
+        perform(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, 0, nullptr);
+    }
+
+    template<class min_class_type>
+    void perform_subvector(void (*perform)(minwrap<min_class_type>*, max::t_object*, const double**, const long, double**, const long, const long, const long, const void*),
+        minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes)
+    {
+        perform(self, dsp64, const_cast<const double**>(in_chans), numins, out_chans, numouts, sampleframes, 0, nullptr);
+    }
+
+
+    // The perform routine used in place of the regular perform routine when the Min class declares MIN_SILENCE_TAIL.
+    // While any input carries sound, and for the length of the tail afterwards, the regular perform routine is called.
+    // After that the outputs are cleared without calling the regular perform routine.
+
+    template<class min_class_type, auto perform>
+    void perform_with_silence(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+        auto silent = true;
+
+        for (auto channel = 0; channel < numins && silent; ++channel)
+            silent = simd::silent(in_chans[channel], sampleframes);
+
+        if (!silent)
+            self->m_silent_frames = 0;
+        else if (self->m_silent_frames < min_class_type::silence_tail)
+            self->m_silent_frames += sampleframes;
+        else {
+            for (auto channel = 0; channel < numouts; ++channel)
+                simd::clear(out_chans[channel], sampleframes);
+            return;
+        }
+        perform_subvector(perform, self, dsp64, in_chans, numins, out_chans, numouts, sampleframes);
+    }
+
+
+    // Wrap a perform routine with perform_with_silence() if the Min class declares MIN_SILENCE_TAIL.
+    // This is resolved at compile time so that the result may itself be wrapped by perform_with_events(),
+    // which must keep applying events and counting time while the object is bypassed.
+
+    template<class min_class_type, auto perform>
+    constexpr typename enable_if<has_silence_tail<min_class_type>::value, decltype(&perform_with_silence<min_class_type, perform>)>::type
+    min_dsp64_perform_silence() {
+        return perform_with_silence<min_class_type, perform>;
+    }
+
+    template<class min_class_type, auto perform>
+    constexpr typename enable_if<!has_silence_tail<min_class_type>::value, decltype(perform)>::type
+    min_dsp64_perform_silence() {
+        return perform;
+    }
+
+
+    // The perform routine used in place of the regular perform routine when the Min class has an audio_event_queue.
+    // The vector is split at the time of each pending event so that the event is applied at the exact sample
+    // for which it was scheduled. Each part of the vector is then processed by the regular perform routine.
+
+    template<class min_class_type, auto perform>
+    void perform_with_events(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+        auto& events    = *self->m_min_object.event_queue();
+        auto  ins       = events.inputs();
+        auto  outs      = events.outputs();
+        long  start     = 0;
+
+        events.receive();
+
+        // more channels than ports (e.g. multichannel connections) cannot be split with the storage allocated in dspsetup
+        // so all events due in this vector are applied at its start
+        if (numins > events.input_count() || numouts > events.output_count()) {
+            events.apply(sampleframes - 1);
+            perform_subvector(perform, self, dsp64, in_chans, numins, out_chans, numouts, sampleframes);
+            events.advance(sampleframes);
+            return;
+        }
+
+        while (start < sampleframes) {
+            events.apply(start);
+
+            const auto end = events.next(sampleframes);
+
+            for (auto channel = 0; channel < numins; ++channel)
+                ins[channel] = in_chans[channel] + start;
+            for (auto channel = 0; channel < numouts; ++channel)
+                outs[channel] = out_chans[channel] + start;
+
+            perform_subvector(perform, self, dsp64, ins, numins, outs, numouts, end - start);
+            start = end;
+        }
+        events.advance(sampleframes);
+    }
+
+
+    // The perform routine used in place of the regular perform routine when the Min class declares MIN_FLUSH_DENORMALS.
+    // Denormals are flushed to zero for the duration of the regular perform routine.
+
+    template<class min_class_type, auto perform>
+    void perform_flush_denormals(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+        denormal_guard guard;
+        perform_subvector(perform, self, dsp64, in_chans, numins, out_chans, numouts, sampleframes);
+    }
+
+
+    // Wrap a perform routine with perform_flush_denormals() if the Min class declares MIN_FLUSH_DENORMALS with a value of true.
+
+    template<class min_class_type, auto perform>
+    typename enable_if<has_flush_denormals<min_class_type>::value, max::t_perfroutine64>::type
+    min_dsp64_perform_denormals() {
+        if (min_class_type::flush_denormals && denormal_guard::supported())
+            return reinterpret_cast<max::t_perfroutine64>(perform_flush_denormals<min_class_type, perform>);
+        return reinterpret_cast<max::t_perfroutine64>(perform);
+    }
+
+    template<class min_class_type, auto perform>
+    typename enable_if<!has_flush_denormals<min_class_type>::value, max::t_perfroutine64>::type
+    min_dsp64_perform_denormals() {
+        return reinterpret_cast<max::t_perfroutine64>(perform);
+    }
+
+
+    // Wrap a perform routine with perform_with_silence() if the Min class declares a silence tail,
+    // then with perform_with_events() if the Min class has an audio_event_queue,
+    // and then with perform_flush_denormals() if the Min class requests it.
+
+    template<class min_class_type, auto perform>
+    max::t_perfroutine64 min_dsp64_perform_events(minwrap<min_class_type>* self) {
+        constexpr auto  routine = min_dsp64_perform_silence<min_class_type, perform>();
+        auto            events  = self->m_min_object.event_queue();
+
+        self->m_silent_frames = 0;
+
+        if (events == nullptr)
+            return min_dsp64_perform_denormals<min_class_type, routine>();
+
+        events->dspsetup(self->m_min_object.inlets().size(), self->m_min_object.outlets().size());
+        return min_dsp64_perform_denormals<min_class_type, perform_with_events<min_class_type, routine>>();
+    }
+
+
+    // Splitting a vector across threads does not pay off below this size.
+
+    static constexpr long k_parallel_min_frames = 32;
+
+
+    // The arguments of a perform call, shared with the tasks of perform_parallel().
+
+    template<class min_class_type>
+    struct parallel_perform_context {
+        minwrap<min_class_type>*    self;
+        max::t_object*              dsp64;
+        double**                    in_chans;
+        long                        numins;
+        double**                    out_chans;
+        long                        numouts;
+        long                        sampleframes;
+        long                        channels_per_task;
+    };
+
+
+    // Process one range of channels for perform_parallel().
+    // perform_channel_range() is implemented in c74_min_operator_mc.h
+
+    template<class min_class_type>
+    void perform_parallel_task(void* a_context, const size_t index) {
+        const auto& context = *static_cast<parallel_perform_context<min_class_type>*>(a_context);
+        const auto  first   = static_cast<long>(index) * context.channels_per_task;
+        const auto  count   = std::min(context.channels_per_task, context.numouts - first);
+
+        perform_channel_range(context.self, context.dsp64, context.in_chans, context.numins, context.out_chans, context.numouts,
+            context.sampleframes, first, count);
+    }
+
+
+    // The perform routine used in place of performer<>::perform() when the Min class declares MIN_PARALLEL_CHANNELS.
+    // The output channels are split into ranges of whole channel groups which are processed by the shared worker_pool.
+    // Each range reads and writes only its own channels and channel state, so the tasks never touch the same memory.
+    // If there are too few channels or samples to benefit, the regular performer is called instead.
+
+    template<class min_class_type>
+    void perform_parallel(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+        constexpr auto  requested           = static_cast<long>(min_class_type::parallel_channels) > 0 ? static_cast<long>(min_class_type::parallel_channels) : 1L;
+        constexpr auto  group_width         = static_cast<long>(simd::k_width);
+        constexpr auto  channels_per_task   = (requested + group_width - 1) / group_width * group_width;
+        const auto      task_count          = (numouts + channels_per_task - 1) / channels_per_task;
+
+        if (task_count < 2 || sampleframes < k_parallel_min_frames) {
+            performer<min_class_type>::perform(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, 0, nullptr);
+            return;
+        }
+
+        parallel_perform_context<min_class_type> context { self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, channels_per_task };
+        worker_pool::shared().run(perform_parallel_task<min_class_type>, &context, static_cast<size_t>(task_count));
+    }
+
+
+    // Select perform_parallel() if the Min class declares MIN_PARALLEL_CHANNELS.
+    // The shared worker_pool is started here, when the dsp chain is compiled, rather than on the audio thread.
+
+    template<class min_class_type>
+    struct is_parallel_channels {
+        static const bool value = has_parallel_channels<min_class_type>::value && has_channel_state<min_class_type>::value
+                                  && is_base_of<mc_operator_base, min_class_type>::value;
+    };
+
+    template<class min_class_type>
+    typename enable_if<is_parallel_channels<min_class_type>::value, max::t_perfroutine64>::type
+    min_dsp64_perform_parallel(minwrap<min_class_type>* self) {
+        worker_pool::shared();
+        return min_dsp64_perform_events<min_class_type, perform_parallel<min_class_type>>(self);
+    }
+
+    template<class min_class_type>
+    typename enable_if<!is_parallel_channels<min_class_type>::value, max::t_perfroutine64>::type
+    min_dsp64_perform_parallel(minwrap<min_class_type>* self) {
+        static_assert(!has_parallel_channels<min_class_type>::value, "MIN_PARALLEL_CHANNELS requires an mc_operator<> class that declares a channel_state");
+        return min_dsp64_perform_events<min_class_type, performer<min_class_type>::perform>(self);
+    }
+
+
+    // The min_dsp64_perform function selects the perform routine for the Min class.
+    // The sample_operator<> version, which may add oversampling, is implemented in c74_min_operator_sample.h
+
+    template<class min_class_type, enable_if_vector_operator<min_class_type> = 0>
+    max::t_perfroutine64 min_dsp64_perform(minwrap<min_class_type>* self) {
+        return min_dsp64_perform_parallel(self);
+    }
+
+
+#ifdef C74_MIN_WITH_DSP_PROFILING
+
+    // The perform routine used in place of the selected perform routine when profiling is compiled in.
+    // It times the selected perform routine and records the result with the object's dsp_profiler.
+
+    template<class min_class_type>
+    void perform_profiled(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long flags, void* userparam) {
+        auto&       profiler    = self->m_dsp_profiler;
+        const auto  start       = dsp_profiler::now();
+
+        profiler.routine()(self->maxobj(), dsp64, in_chans, numins, out_chans, numouts, sampleframes, flags, userparam);
+        profiler.record(dsp_profiler::now() - start, sampleframes);
+    }
+
+
+    // Wrap the selected perform routine with perform_profiled().
+    // The samplerate is read before the perform routine is selected, which may change it when oversampling.
+
+    template<class min_class_type>
+    max::t_perfroutine64 min_dsp64_perform_profiled(minwrap<min_class_type>* self) {
+        const auto samplerate   = self->m_min_object.samplerate();
+        const auto perform      = min_dsp64_perform(self);
+
+        self->m_dsp_profiler.dspsetup(reinterpret_cast<dsp_profiler::perform_routine>(perform), samplerate);
+        return reinterpret_cast<max::t_perfroutine64>(perform_profiled<min_class_type>);
+    }
+
+
+    // Post the statistics gathered by the dsp_profiler of an object to the Max console.
+    // Called on the main thread when the object receives the "dspstats" message.
+    // The statistics are cleared if the message is followed by "reset".
+
+    template<class min_class_type>
+    void min_dspstats(minwrap<min_class_type>* self, max::t_symbol*, const long argc, max::t_atom* argv) {
+        auto& profiler = self->m_dsp_profiler;
+
+        if (argc > 0 && symbol(max::atom_getsym(argv)) == "reset") {
+            profiler.reset();
+            return;
+        }
+
+        const auto stats = profiler.statistics();
+
+        self->m_min_object.cout << "dspstats: " << stats.count << " vectors"
+            << ", mean " << stats.mean << " us"
+            << ", p99 " << stats.p99 << " us"
+            << ", max " << stats.max << " us"
+            << ", budget " << stats.budget << " us"
+            << ", overruns " << stats.overruns << endl;
+    }
+
+#endif
+
+
     // The min_dsp64_add_perform function handles adding the perform method to the signal chain (see performer class above)
 
     template<class min_class_type>
     void min_dsp64_add_perform(minwrap<min_class_type>* self, max::t_object* dsp64) {
+#ifdef C74_MIN_WITH_DSP_PROFILING
+        const auto perform = min_dsp64_perform_profiled(self);
+#else
+        const auto perform = min_dsp64_perform(self);
+#endif
+
         // find the perform method and add it
         using namespace c74::max;
         object_method_direct(void, (void*, max::t_object*, const max::t_perfroutine64, const long, const void*), dsp64, symbol("dsp_add64"),
-            self->maxobj(), reinterpret_cast<max::t_perfroutine64>(performer<min_class_type>::perform), 0, NULL);
+            self->maxobj(), perform, 0, NULL);
     }
 
 
-    // A specialization of min_dsp64_sel for classes that have a custom "dspsetup" message.
-
+    // A specialization of min_dsp64_dspsetup for classes that have a custom "dspsetup" message.
 
     template<class min_class_type>
     typename enable_if<has_dspsetup<min_class_type>::value
     || has_m_dspsetup<min_class_type>::value>::type
-    min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags) {
-        self->m_min_object.samplerate(samplerate);
-        self->m_min_object.vector_size(maxvectorsize);
-        min_dsp64_io(self, count);
-        min_dsp64_attrmap(self, count);
-
+    min_dsp64_dspsetup(minwrap<min_class_type>* self, const double samplerate, const long maxvectorsize) {
         atoms args;
         args.push_back(atom(samplerate));
         args.push_back(atom(max::t_atom_long(maxvectorsize)));
         self->m_min_object.dspsetup(args);
-
-        min_dsp64_add_perform(self, dsp64);
     }
 
 
-    // A (non)specialization of min_dsp64_sel for classes that do _not_ have a custom "dspsetup" message
+    // A (non)specialization of min_dsp64_dspsetup for classes that do _not_ have a custom "dspsetup" message
     // (which is most audio classes).
 
     template<class min_class_type>
     typename enable_if<!has_dspsetup<min_class_type>::value
     && !has_m_dspsetup<min_class_type>::value>::type
-    min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags) {
+    min_dsp64_dspsetup(minwrap<min_class_type>* self, const double samplerate, const long maxvectorsize)
+    {}
+
+
+    // Update the Min class for a newly compiled dsp chain, up to the point of selecting the perform routine.
+    // This is shared by min_dsp64_sel() and the render_harness<> in c74_min_render.h, which has no dsp64 object.
+    // The dspsetup message of the class receives the samplerate and vector size at which its call operator runs,
+    // which differ from those of the signal chain if it is oversampled.
+    // The storage of smoothed attribute followers is allocated for the same vector size beforehand,
+    // or for the largest factor of an oversampler.
+
+    template<class min_class_type>
+    void min_dsp64_prepare(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize) {
         self->m_min_object.samplerate(samplerate);
         self->m_min_object.vector_size(maxvectorsize);
         min_dsp64_io(self, count);
         min_dsp64_attrmap(self, count);
+        min_dsp64_channels(self, dsp64);
+
+        for (auto a_smoothed : self->m_min_object.smoothed_attributes())
+            a_smoothed->dspsetup(self->m_min_object.vector_size());
+
+        min_dsp64_oversampling(self);
+        min_dsp64_dspsetup(self, self->m_min_object.samplerate(), self->m_min_object.vector_size());
+    }
+
+
+    // Prepare the Min class for the dsp chain and add its perform routine.
+
+    template<class min_class_type>
+    void min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags) {
+        min_dsp64_prepare(self, dsp64, count, samplerate, maxvectorsize);
         min_dsp64_add_perform(self, dsp64);
     }
 
@@ -392,6 +942,9 @@ namespace c74::min {
     template<class min_class_type, enable_if_audio_class<min_class_type> = 0>
     void wrap_as_max_external_audio(max::t_class* c) {
         max::class_addmethod(c, reinterpret_cast<max::method>(min_dsp64<min_class_type>), "dsp64", max::A_CANT, 0);
+#ifdef C74_MIN_WITH_DSP_PROFILING
+        max::class_addmethod(c, reinterpret_cast<max::method>(min_dspstats<min_class_type>), "dspstats", max::A_GIMME, 0);
+#endif
         if (is_base_of<ui_operator_base, min_class_type>::value)
             max::class_dspinitjbox(c);
         else
@@ -0,0 +1,388 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    // The half-band lowpass filter used for each 2x stage of the oversampler.
+    //
+    // A half-band filter with 4K-1 taps has a center tap of 0.5 and every other tap is zero.
+    // Split into two polyphase branches, one branch is a 2K-tap FIR and the other is a pure delay.
+    // Only the coefficients of the FIR branch are stored here, in reverse order, so that each output
+    // is the dot product of the coefficients with a contiguous run of the input history.
+
+    static constexpr long k_halfband_order = 12;                            // K
+    static constexpr long k_halfband_taps = 2 * k_halfband_order;           // taps in the FIR branch
+    static constexpr long k_halfband_history = k_halfband_taps - 1;         // samples of history needed by the FIR branch
+
+    inline const std::array<sample, k_halfband_taps>& halfband_coefficients() {
+        static const auto coefficients = []() {
+            // Kaiser-windowed sinc, about 65 dB of attenuation above 0.6 of the Nyquist frequency of the lower rate
+            const auto pi       = 3.14159265358979323846;
+            const auto beta     = 10.0;
+            const auto center   = 2.0 * k_halfband_order - 1.0;
+            const auto bessel_i0 = [](const double x) {
+                auto sum = 1.0;
+                auto term = 1.0;
+                for (auto k = 1; k < 32; ++k) {
+                    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                    sum  += term;
+                }
+                return sum;
+            };
+
+            std::array<sample, k_halfband_taps> h;
+            auto                                sum = 0.0;
+
+            for (auto j = 0; j < k_halfband_taps; ++j) {
+                const auto m        = 2.0 * j - center;    // odd offset from the center tap
+                const auto r        = m / center;
+                const auto window   = bessel_i0(beta * std::sqrt(1.0 - r * r)) / bessel_i0(beta);
+
+                h[k_halfband_taps - 1 - j]  = std::sin(pi * m / 2.0) / (pi * m) * window;
+                sum                         += h[k_halfband_taps - 1 - j];
+            }
+            for (auto& coefficient : h)
+                coefficient *= 0.5 / sum;    // unity gain at dc once the 0.5 center tap is added
+            return h;
+        }();
+        return coefficients;
+    }
+
+
+    // Return the dot product of the half-band FIR branch with k_halfband_taps samples of input.
+
+    inline sample halfband_dot(const sample* input) {
+        const auto& h   = halfband_coefficients();
+        sample      sum = 0.0;
+
+        for (auto j = 0; j < k_halfband_taps; ++j)
+            sum += h[j] * input[j];
+        return sum;
+    }
+
+
+    /// A single 2x upsampling stage of the oversampler.
+    /// Each input sample produces two output samples.
+
+    class halfband_upsampler {
+    public:
+        /// Allocate memory for processing.
+        /// @param	max_frame_count		The largest number of input samples that will be processed at once.
+
+        void resize(const long max_frame_count) {
+            m_buffer.assign(k_halfband_history + max_frame_count, 0.0);
+        }
+
+
+        /// Clear the filter history.
+
+        void clear() {
+            std::fill(m_buffer.begin(), m_buffer.end(), 0.0);
+        }
+
+
+        /// Upsample a vector.
+        /// @param	input			The samples to upsample.
+        /// @param	output			Storage for 2 * frame_count samples.
+        /// @param	frame_count		The number of input samples.
+
+        void process(const sample* input, sample* output, const long frame_count) {
+            auto buffer = m_buffer.data();
+
+            std::copy(input, input + frame_count, buffer + k_halfband_history);
+            for (auto i = 0; i < frame_count; ++i) {
+                output[2 * i]       = 2.0 * halfband_dot(buffer + i);
+                output[2 * i + 1]   = buffer[i + k_halfband_order];    // the delay branch, 2 * 0.5 * x[i - (K-1)]
+            }
+            std::copy(buffer + frame_count, buffer + frame_count + k_halfband_history, buffer);
+        }
+
+    private:
+        sample_vector m_buffer;
+    };
+
+
+    /// A single 2x downsampling stage of the oversampler.
+    /// Each pair of input samples produces one output sample.
+
+    class halfband_downsampler {
+    public:
+        /// Allocate memory for processing.
+        /// @param	max_frame_count		The largest number of output samples that will be processed at once.
+
+        void resize(const long max_frame_count) {
+            m_even.assign(k_halfband_history + max_frame_count, 0.0);
+            m_odd.assign(k_halfband_order + max_frame_count, 0.0);
+        }
+
+
+        /// Clear the filter history.
+
+        void clear() {
+            std::fill(m_even.begin(), m_even.end(), 0.0);
+            std::fill(m_odd.begin(), m_odd.end(), 0.0);
+        }
+
+
+        /// Downsample a vector.
+        /// @param	input			The 2 * frame_count samples to downsample.
+        /// @param	output			Storage for frame_count samples.
+        /// @param	frame_count		The number of output samples.
+
+        void process(const sample* input, sample* output, const long frame_count) {
+            auto even   = m_even.data();
+            auto odd    = m_odd.data();
+
+            for (auto i = 0; i < frame_count; ++i) {
+                even[k_halfband_history + i]    = input[2 * i];
+                odd[k_halfband_order + i]       = input[2 * i + 1];
+            }
+            for (auto i = 0; i < frame_count; ++i)
+                output[i] = halfband_dot(even + i) + 0.5 * odd[i];
+
+            std::copy(even + frame_count, even + frame_count + k_halfband_history, even);
+            std::copy(odd + frame_count, odd + frame_count + k_halfband_order, odd);
+        }
+
+    private:
+        sample_vector m_even;
+        sample_vector m_odd;
+    };
+
+
+    /// Run the call operator of a sample_operator<> at a multiple of the samplerate to reduce aliasing.
+    ///
+    /// Nonlinear processes such as saturators and waveshapers generate harmonics above the Nyquist frequency
+    /// which fold back into the audible range.
+    /// When a sample_operator<> class declares an oversampler member, the performer upsamples the audio inputs,
+    /// calls the call operator at the higher rate, and decimates the audio outputs back to the samplerate of the signal chain.
+    /// Each factor of 2 is a polyphase half-band FIR stage, so 2x, 4x or 8x oversampling is available.
+    /// @code
+    /// attribute<int>  m_oversampling  { this, "oversampling", 1, range { 1, 8 } };
+    /// oversampler     m_oversampler   { this, m_oversampling };
+    /// @endcode
+    ///
+    /// The factor is read from the attribute at the start of each vector and rounded down to a power of two.
+    /// Memory for all factors is allocated when the dsp chain is compiled, so the factor can change while audio is running.
+    /// While oversampling, the samplerate() and vector_size() of the owning object report the oversampled rate and vector size,
+    /// and these are also the arguments of its dspsetup message.
+    /// When the factor changes while audio is running, samplerate() and vector_size() follow it from the next vector,
+    /// but the dspsetup message is not sent again until the dsp chain is compiled again, because it may allocate memory.
+    /// Calculate anything that depends on the rate from samplerate() when it changes rather than only in dspsetup.
+    /// The storage of smoothed members is allocated for the largest factor.
+    /// The filters add a latency of about 23 samples at 2x, rising to about 40 samples at 8x.
+
+    class oversampler {
+    public:
+        /// The largest supported oversampling factor.
+
+        static constexpr long k_max_factor = 8;
+
+
+        /// Create an oversampler for an audio object.
+        /// @param	an_owner		The owning sample_operator<> object. Typically you will pass `this`.
+        /// @param	an_attribute	The numeric attribute with the oversampling factor.
+
+        template<class owner_type, class attribute_type>
+        oversampler(owner_type* an_owner, attribute_type& an_attribute)
+        : m_requested_factor { [&an_attribute]() { return static_cast<long>(an_attribute.get()); } } {
+            an_owner->oversampling(this);
+        }
+
+        oversampler(const oversampler& other) = delete;
+        oversampler& operator=(const oversampler& other) = delete;
+
+
+        /// Return the current oversampling factor.
+        /// @return	The factor, 1 if the oversampler is not active.
+
+        long factor() const {
+            return 1L << m_stage_count;
+        }
+
+
+        /// Called by the performer when the dsp chain is compiled.
+        /// Allocates memory for the filters at the largest oversampling factor.
+        /// @param	input_count		The number of audio inputs.
+        /// @param	output_count	The number of audio outputs.
+        /// @param	samplerate		The samplerate of the signal chain.
+        /// @param	max_frame_count	The vector size of the signal chain.
+
+        void dspsetup(const size_t input_count, const size_t output_count, const double samplerate, const long max_frame_count) {
+            halfband_coefficients();    // calculate the filter before it is needed on the audio thread
+
+            m_samplerate        = samplerate;
+            m_max_frame_count   = max_frame_count;
+            m_inputs.resize(input_count);
+            m_outputs.resize(output_count);
+            m_upsamplers.resize(input_count);
+            m_downsamplers.resize(output_count);
+
+            for (auto& channel : m_upsamplers) {
+                for (auto stage = 0; stage < k_stage_count; ++stage) {
+                    channel.stages[stage].resize(max_frame_count << stage);
+                    channel.buffers[stage].assign(max_frame_count << (stage + 1), 0.0);
+                }
+            }
+            for (auto& channel : m_downsamplers) {
+                for (auto stage = 0; stage < k_stage_count; ++stage) {
+                    channel.stages[stage].resize(max_frame_count << stage);
+                    channel.buffers[stage].assign(max_frame_count << (stage + 1), 0.0);
+                }
+            }
+            m_stage_count = 0;
+            update();
+        }
+
+
+        /// Called by the performer at the start of each vector to read the factor from the attribute.
+        /// When the factor changes the filter history is cleared.
+        /// @return	True if the factor has changed.
+
+        bool update() {
+            const auto requested    = m_requested_factor();
+            const auto stage_count  = requested >= 8 ? 3 : requested >= 4 ? 2 : requested >= 2 ? 1 : 0;
+
+            if (stage_count == m_stage_count)
+                return false;
+
+            m_stage_count = stage_count;
+            for (auto& channel : m_upsamplers) {
+                for (auto& stage : channel.stages)
+                    stage.clear();
+            }
+            for (auto& channel : m_downsamplers) {
+                for (auto& stage : channel.stages)
+                    stage.clear();
+            }
+            return true;
+        }
+
+
+        /// Return the largest number of samples for which the call operator is run in one vector.
+        /// @return	The vector size of the signal chain multiplied by the factor.
+
+        long vector_size() const {
+            return m_max_frame_count * factor();
+        }
+
+
+        /// Return the largest number of samples for which the call operator is run in one vector at any factor.
+        /// @return	The vector size of the signal chain multiplied by the largest factor.
+
+        long max_vector_size() const {
+            return m_max_frame_count * k_max_factor;
+        }
+
+
+        /// Return the vector size of the signal chain, at which the call operator runs while the oversampler is not active().
+        /// @return	The vector size of the signal chain.
+
+        long base_vector_size() const {
+            return m_max_frame_count;
+        }
+
+
+        /// Return the samplerate at which the call operator is run.
+        /// @return	The oversampled samplerate in hz.
+
+        double samplerate() const {
+            return m_samplerate * factor();
+        }
+
+
+        /// Return the samplerate of the signal chain, at which the call operator runs while the oversampler is not active().
+        /// @return	The samplerate in hz.
+
+        double base_samplerate() const {
+            return m_samplerate;
+        }
+
+
+        /// Can a vector be processed by the oversampler?
+        /// @param	input_count		The number of audio inputs.
+        /// @param	output_count	The number of audio outputs.
+        /// @param	frame_count		The number of samples in the vector.
+        /// @return					True if the oversampler is active and memory has been allocated for the vector.
+
+        bool active(const long input_count, const long output_count, const long frame_count) const {
+            return m_stage_count > 0
+                && static_cast<size_t>(input_count) <= m_inputs.size()
+                && static_cast<size_t>(output_count) <= m_outputs.size()
+                && frame_count <= m_max_frame_count;
+        }
+
+
+        /// Upsample all audio inputs.
+        /// @param	in_chans		The audio inputs at the samplerate of the signal chain.
+        /// @param	input_count		The number of audio inputs.
+        /// @param	frame_count		The number of samples in the vector.
+        /// @return					The audio inputs at the oversampled rate.
+
+        double** upsample(const double** in_chans, const long input_count, const long frame_count) {
+            for (auto channel = 0; channel < input_count; ++channel) {
+                auto&           up      = m_upsamplers[channel];
+                const sample*   input   = in_chans[channel];
+
+                for (auto stage = 0; stage < m_stage_count; ++stage) {
+                    up.stages[stage].process(input, up.buffers[stage].data(), frame_count << stage);
+                    input = up.buffers[stage].data();
+                }
+                m_inputs[channel] = up.buffers[m_stage_count - 1].data();
+            }
+            return m_inputs.data();
+        }
+
+
+        /// Get the storage for the audio outputs at the oversampled rate.
+        /// @param	output_count	The number of audio outputs.
+        /// @return					Storage for the audio outputs.
+
+        double** outputs(const long output_count) {
+            for (auto channel = 0; channel < output_count; ++channel)
+                m_outputs[channel] = m_downsamplers[channel].buffers[m_stage_count - 1].data();
+            return m_outputs.data();
+        }
+
+
+        /// Downsample all audio outputs.
+        /// @param	out_chans		Storage for the audio outputs at the samplerate of the signal chain.
+        /// @param	output_count	The number of audio outputs.
+        /// @param	frame_count		The number of samples in the vector.
+
+        void downsample(double** out_chans, const long output_count, const long frame_count) {
+            for (auto channel = 0; channel < output_count; ++channel) {
+                auto& down = m_downsamplers[channel];
+
+                for (auto stage = m_stage_count - 1; stage >= 0; --stage) {
+                    auto output = stage > 0 ? down.buffers[stage - 1].data() : out_chans[channel];
+                    down.stages[stage].process(down.buffers[stage].data(), output, frame_count << stage);
+                }
+            }
+        }
+
+    private:
+        static constexpr int k_stage_count = 3;    // log2 of k_max_factor
+
+        template<class stage_type>
+        struct channel_stages {
+            std::array<stage_type, k_stage_count>       stages;
+            std::array<sample_vector, k_stage_count>    buffers;    // the signal at 2x, 4x and 8x
+        };
+
+        std::function<long()>                           m_requested_factor;
+        int                                             m_stage_count { 0 };
+        double                                          m_samplerate { 0.0 };
+        long                                            m_max_frame_count { 0 };
+        vector<channel_stages<halfband_upsampler>>      m_upsamplers;
+        vector<channel_stages<halfband_downsampler>>    m_downsamplers;
+        vector<double*>                                 m_inputs;
+        vector<double*>                                 m_outputs;
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,682 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_min_api.h"
+#include <limits>
+
+
+namespace c74::min {
+
+
+    /// A source of audio for the render_harness<>, e.g. a file or a generator.
+
+    class render_source {
+    public:
+        virtual ~render_source() {}
+
+
+        /// Return the number of channels provided by the source.
+        /// @return	The number of channels.
+
+        virtual long channel_count() const = 0;
+
+
+        /// Read the next samples of each channel.
+        /// @param	channels		Storage for channel_count() channels of samples.
+        /// @param	frame_count		The number of samples to read in each channel.
+        /// @return					The number of samples read, which is less than requested only at the end of the source.
+
+        virtual long read(double* const* channels, long frame_count) = 0;
+
+
+        /// Determine whether the source has an end.
+        /// @return	True if read() will eventually return fewer samples than requested. Otherwise false.
+
+        virtual bool finite() const {
+            return true;
+        }
+    };
+
+
+    /// A destination for audio rendered by the render_harness<>, e.g. a file or memory.
+
+    class render_sink {
+    public:
+        virtual ~render_sink() {}
+
+
+        /// Write the next samples of each channel.
+        /// @param	channels		The samples of each channel.
+        /// @param	channel_count	The number of channels.
+        /// @param	frame_count		The number of samples in each channel.
+
+        virtual void write(const double* const* channels, long channel_count, long frame_count) = 0;
+    };
+
+
+    /// A source that calculates each sample with a function, e.g. a sine wave or noise.
+    /// @code
+    /// signal_generator sine { 1, [](long channel, long long frame) { return std::sin(0.01 * frame); } };
+    /// @endcode
+
+    class signal_generator : public render_source {
+    public:
+        /// The signature of the function that calculates a sample.
+
+        using function = std::function<sample(long channel, long long frame)>;
+
+
+        /// Create a generator.
+        /// @param	channel_count	The number of channels.
+        /// @param	a_function		The function that calculates the sample for a channel and the index of the sample.
+        /// @param	frame_count		The length of the signal in samples, or -1 for a signal without end.
+
+        signal_generator(const long channel_count, const function& a_function, const long long frame_count = -1)
+        : m_channel_count { channel_count }
+        , m_function { a_function }
+        , m_frame_count { frame_count }
+        {}
+
+
+        long channel_count() const override {
+            return m_channel_count;
+        }
+
+
+        long read(double* const* channels, const long frame_count) override {
+            const auto count = m_frame_count < 0 ? frame_count : static_cast<long>(std::min<long long>(frame_count, m_frame_count - m_position));
+
+            for (auto channel = 0; channel < m_channel_count; ++channel) {
+                for (auto i = 0; i < count; ++i)
+                    channels[channel][i] = m_function(channel, m_position + i);
+            }
+            m_position += count;
+            return count;
+        }
+
+
+        bool finite() const override {
+            return m_frame_count >= 0;
+        }
+
+    private:
+        long        m_channel_count;
+        function    m_function;
+        long long   m_frame_count;
+        long long   m_position { 0 };
+    };
+
+
+    /// A sink that keeps the rendered audio in memory, e.g. to compare it with a reference in a regression test.
+
+    class render_capture : public render_sink {
+    public:
+        void write(const double* const* channels, const long channel_count, const long frame_count) override {
+            m_channels.resize(std::max(m_channels.size(), static_cast<size_t>(channel_count)));
+            for (auto channel = 0; channel < channel_count; ++channel)
+                m_channels[channel].insert(m_channels[channel].end(), channels[channel], channels[channel] + frame_count);
+        }
+
+
+        /// Get the samples of one channel.
+        /// @param	channel	The index of the channel.
+        /// @return			All samples written to the channel.
+
+        const sample_vector& samples(const size_t channel) const {
+            return m_channels.at(channel);
+        }
+
+
+        /// Return the number of channels written.
+        /// @return	The number of channels.
+
+        size_t channel_count() const {
+            return m_channels.size();
+        }
+
+    private:
+        vector<sample_vector> m_channels;
+    };
+
+
+    /// A source reading a WAV file.
+    /// Integer samples of 8, 16, 24 and 32 bits and floating-point samples of 32 and 64 bits are supported.
+    /// The whole file is read when the reader is created.
+
+    class wav_file_reader : public render_source {
+    public:
+        /// Read a WAV file.
+        /// Throws std::runtime_error if the file can't be read or is not a supported WAV file.
+        /// @param	path	The path of the file.
+
+        explicit wav_file_reader(const string& path) {
+            std::ifstream file { path, std::ios::binary };
+
+            if (!file.is_open())
+                throw std::runtime_error("unable to open " + path);
+
+            const auto data = string { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+            if (data.size() < 12 || data.compare(0, 4, "RIFF") != 0 || data.compare(8, 4, "WAVE") != 0)
+                throw std::runtime_error(path + " is not a WAV file");
+
+            const char* format_chunk    = nullptr;
+            size_t      format_size     = 0;
+
+            for (size_t position = 12; position + 8 <= data.size();) {
+                const auto id   = data.substr(position, 4);
+                const auto size = static_cast<size_t>(little_endian(&data[position + 4], 4));
+                const auto body = &data[position + 8];
+
+                if (id == "fmt " && size >= 16 && size <= data.size() - position - 8) {
+                    format_chunk    = body;
+                    format_size     = size;
+                }
+                else if (id == "data" && format_chunk) {
+                    decode(format_chunk, format_size, body, std::min(size, data.size() - position - 8));
+                    return;
+                }
+                position += 8 + size + (size & 1);
+            }
+            throw std::runtime_error(path + " has no audio data");
+        }
+
+
+        long channel_count() const override {
+            return static_cast<long>(m_channels.size());
+        }
+
+
+        long read(double* const* channels, const long frame_count) override {
+            const auto count = static_cast<long>(std::min<size_t>(frame_count, this->frame_count() - m_position));
+
+            for (size_t channel = 0; channel < m_channels.size(); ++channel)
+                std::copy_n(m_channels[channel].begin() + m_position, count, channels[channel]);
+            m_position += count;
+            return count;
+        }
+
+
+        /// Return the samplerate of the file.
+        /// @return	The samplerate in hz.
+
+        double samplerate() const {
+            return m_samplerate;
+        }
+
+
+        /// Return the length of the file.
+        /// @return	The number of samples in each channel.
+
+        size_t frame_count() const {
+            return m_channels.empty() ? 0 : m_channels[0].size();
+        }
+
+    private:
+        vector<sample_vector>   m_channels;
+        double                  m_samplerate { 0.0 };
+        size_t                  m_position { 0 };
+
+
+        static uint64_t little_endian(const char* bytes, const int byte_count) {
+            uint64_t value = 0;
+            for (auto i = 0; i < byte_count; ++i)
+                value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+            return value;
+        }
+
+
+        void decode(const char* format_chunk, const size_t format_size, const char* data, const size_t size) {
+            auto       format           = little_endian(format_chunk, 2);
+            const auto channel_count    = static_cast<size_t>(little_endian(format_chunk + 2, 2));
+            const auto bits             = static_cast<int>(little_endian(format_chunk + 14, 2));
+            const auto bytes            = bits / 8;
+
+            if (format == 0xFFFE) {    // WAVE_FORMAT_EXTENSIBLE, the format is the start of the sub-format GUID
+                if (format_size < 26)
+                    throw std::runtime_error("incomplete WAV format chunk");
+                format = little_endian(format_chunk + 24, 2);
+            }
+
+            const auto is_float = format == 3;
+
+            if (channel_count == 0 || !(format == 1 || is_float) || bits == 0 || bits % 8 != 0 || (is_float && bits != 32 && bits != 64) || (!is_float && bits > 32))
+                throw std::runtime_error("unsupported WAV format");
+
+            const auto frame_count  = size / (channel_count * bytes);
+            const auto scale        = 1.0 / static_cast<double>(uint64_t(1) << (bits - 1));
+
+            m_samplerate = static_cast<double>(little_endian(format_chunk + 4, 4));
+            m_channels.assign(channel_count, sample_vector(frame_count));
+
+            for (size_t frame = 0; frame < frame_count; ++frame) {
+                for (size_t channel = 0; channel < channel_count; ++channel) {
+                    const auto bytes_in = data + (frame * channel_count + channel) * bytes;
+                    const auto word     = little_endian(bytes_in, bytes);
+                    auto&      output   = m_channels[channel][frame];
+
+                    if (is_float && bits == 32) {
+                        float value;
+                        const auto word32 = static_cast<uint32_t>(word);
+                        std::memcpy(&value, &word32, sizeof value);
+                        output = value;
+                    }
+                    else if (is_float)
+                        std::memcpy(&output, &word, sizeof output);
+                    else if (bits == 8)
+                        output = (static_cast<double>(word) - 128.0) / 128.0;    // 8-bit samples are unsigned
+                    else {
+                        const auto shift = 64 - bits;
+                        output = static_cast<double>(static_cast<int64_t>(word << shift) >> shift) * scale;
+                    }
+                }
+            }
+        }
+    };
+
+
+    /// A sink writing a WAV file with 32-bit floating-point samples.
+    /// The header is completed when the writer is destroyed.
+    /// The sizes in the header limit the audio data to 4 GB, beyond which write() throws std::runtime_error
+    /// rather than producing a file with a wrong header.
+
+    class wav_file_writer : public render_sink {
+    public:
+        /// Create a WAV file.
+        /// Throws std::runtime_error if the file can't be created.
+        /// @param	path			The path of the file.
+        /// @param	a_samplerate	The samplerate to record in the header.
+
+        wav_file_writer(const string& path, const double a_samplerate)
+        : m_file { path, std::ios::binary }
+        , m_samplerate { a_samplerate } {
+            if (!m_file.is_open())
+                throw std::runtime_error("unable to create " + path);
+            write_header();
+        }
+
+        wav_file_writer(const wav_file_writer& other) = delete;
+        wav_file_writer& operator=(const wav_file_writer& other) = delete;
+
+
+        ~wav_file_writer() {
+            m_file.seekp(0);
+            write_header();
+        }
+
+
+        void write(const double* const* channels, const long channel_count, const long frame_count) override {
+            if (m_channel_count == 0)
+                m_channel_count = channel_count;
+
+            if (data_size(m_frame_count + static_cast<uint64_t>(std::max(frame_count, 0L))) > k_max_data_size)
+                throw std::runtime_error("WAV files are limited to 4 GB of audio");
+
+            for (auto i = 0; i < frame_count; ++i) {
+                for (auto channel = 0; channel < m_channel_count; ++channel) {
+                    const auto value = static_cast<float>(channel < channel_count ? channels[channel][i] : 0.0);
+                    uint32_t   word;
+
+                    std::memcpy(&word, &value, sizeof word);
+                    write_little_endian(word, 4);
+                }
+            }
+            m_frame_count += frame_count;
+        }
+
+    private:
+        static constexpr uint64_t k_max_data_size = 0xFFFFFFFF - 36;    // the RIFF size counts the header after it too
+
+        std::ofstream   m_file;
+        double          m_samplerate;
+        long            m_channel_count { 0 };
+        uint64_t        m_frame_count { 0 };
+
+
+        uint64_t data_size(const uint64_t frame_count) const {
+            return frame_count * static_cast<uint64_t>(std::max(m_channel_count, 1L)) * 4;
+        }
+
+
+        void write_little_endian(const uint64_t value, const int byte_count) {
+            char bytes[8];
+            for (auto i = 0; i < byte_count; ++i)
+                bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+            m_file.write(bytes, byte_count);
+        }
+
+
+        void write_header() {
+            const auto channel_count    = static_cast<uint64_t>(std::max(m_channel_count, 1L));
+            const auto size             = data_size(m_frame_count);
+
+            m_file.write("RIFF", 4);
+            write_little_endian(36 + size, 4);
+            m_file.write("WAVEfmt ", 8);
+            write_little_endian(16, 4);
+            write_little_endian(3, 2);                                  // IEEE floating-point
+            write_little_endian(channel_count, 2);
+            write_little_endian(static_cast<uint64_t>(m_samplerate), 4);
+            write_little_endian(static_cast<uint64_t>(m_samplerate) * channel_count * 4, 4);
+            write_little_endian(channel_count * 4, 2);
+            write_little_endian(32, 2);
+            m_file.write("data", 4);
+            write_little_endian(size, 4);
+        }
+    };
+
+
+    /// A source reading a file of raw interleaved 32-bit floating-point samples in the byte order of the machine.
+
+    class raw_file_reader : public render_source {
+    public:
+        /// Open a raw file.
+        /// Throws std::runtime_error if the file can't be opened.
+        /// @param	path			The path of the file.
+        /// @param	channel_count	The number of interleaved channels.
+
+        raw_file_reader(const string& path, const long channel_count)
+        : m_file { path, std::ios::binary }
+        , m_channel_count { std::max(channel_count, 1L) } {
+            if (!m_file.is_open())
+                throw std::runtime_error("unable to open " + path);
+        }
+
+
+        long channel_count() const override {
+            return m_channel_count;
+        }
+
+
+        long read(double* const* channels, const long frame_count) override {
+            m_interleaved.resize(static_cast<size_t>(frame_count * m_channel_count));
+            m_file.read(reinterpret_cast<char*>(m_interleaved.data()), static_cast<std::streamsize>(m_interleaved.size() * sizeof(float)));
+
+            const auto count = static_cast<long>(m_file.gcount() / static_cast<std::streamsize>(sizeof(float) * m_channel_count));
+
+            for (auto i = 0; i < count; ++i) {
+                for (auto channel = 0; channel < m_channel_count; ++channel)
+                    channels[channel][i] = m_interleaved[i * m_channel_count + channel];
+            }
+            return count;
+        }
+
+    private:
+        std::ifstream   m_file;
+        long            m_channel_count;
+        vector<float>   m_interleaved;
+    };
+
+
+    /// A sink writing a file of raw interleaved 32-bit floating-point samples in the byte order of the machine.
+
+    class raw_file_writer : public render_sink {
+    public:
+        /// Create a raw file.
+        /// Throws std::runtime_error if the file can't be created.
+        /// @param	path	The path of the file.
+
+        explicit raw_file_writer(const string& path)
+        : m_file { path, std::ios::binary } {
+            if (!m_file.is_open())
+                throw std::runtime_error("unable to create " + path);
+        }
+
+
+        void write(const double* const* channels, const long channel_count, const long frame_count) override {
+            m_interleaved.resize(static_cast<size_t>(frame_count * channel_count));
+            for (auto i = 0; i < frame_count; ++i) {
+                for (auto channel = 0; channel < channel_count; ++channel)
+                    m_interleaved[i * channel_count + channel] = static_cast<float>(channels[channel][i]);
+            }
+            m_file.write(reinterpret_cast<const char*>(m_interleaved.data()), static_cast<std::streamsize>(m_interleaved.size() * sizeof(float)));
+        }
+
+    private:
+        std::ofstream   m_file;
+        vector<float>   m_interleaved;
+    };
+
+
+    /// The throughput of a call to render_harness<>::render().
+
+    struct render_statistics {
+        long long   frame_count { 0 };    ///< The number of samples rendered in each channel.
+        double      duration { 0.0 };     ///< The duration of the rendered audio in seconds.
+        double      seconds { 0.0 };      ///< The time spent in the perform routine in seconds.
+
+
+        /// Return the number of samples rendered in each channel per second of processing.
+        /// @return	The throughput in samples per second.
+
+        double samples_per_second() const {
+            return seconds > 0.0 ? frame_count / seconds : 0.0;
+        }
+
+
+        /// Return how many times faster than real-time the audio was rendered.
+        /// @return	The ratio of the duration of the audio to the time spent processing it.
+
+        double realtime_factor() const {
+            return seconds > 0.0 ? duration / seconds : 0.0;
+        }
+    };
+
+
+    // The number of output channels of an audio object: one for each signal outlet,
+    // or, for an mc_operator<>, as many as the channels in the first inlet.
+
+    template<class min_class_type, typename enable_if<!is_base_of<mc_operator_base, min_class_type>::value, int>::type = 0>
+    long render_output_count(min_class_type& object) {
+        long count = 0;
+        for (const auto& an_outlet : object.outlets()) {
+            if (an_outlet->type() == "signal" || an_outlet->type() == "multichannelsignal")
+                ++count;
+        }
+        return count;
+    }
+
+    template<class min_class_type, enable_if_mc_operator<min_class_type> = 0>
+    long render_output_count(min_class_type& object) {
+        return object.channel_count();
+    }
+
+
+    // Set the number of channels of an mc_operator<>, which Max would otherwise report when compiling the dsp chain.
+
+    template<class min_class_type, typename enable_if<!is_base_of<mc_operator_base, min_class_type>::value, int>::type = 0>
+    void render_input_count(min_class_type& object, const long channel_count)
+    {}
+
+    template<class min_class_type, enable_if_mc_operator<min_class_type> = 0>
+    void render_input_count(min_class_type& object, const long channel_count) {
+        object.channel_count(std::max(channel_count, 1L));
+    }
+
+
+    /// Render audio through a Min audio object outside of Max, as fast as the object can process it.
+    ///
+    /// The harness creates an instance of your class using the mock kernel, like the test_wrapper<>.
+    /// It then compiles the dsp chain as Max would at the samplerate and vector size given,
+    /// and calls the selected perform routine with one vector after another from a render_source,
+    /// writing the output to a render_sink.
+    /// The time spent in the perform routine is measured and returned.
+    /// @code
+    /// render_harness<lores>   harness { 48000.0, 64 };
+    /// wav_file_reader         input { "drums.wav" };
+    /// wav_file_writer         output { "drums-filtered.wav", 48000.0 };
+    ///
+    /// harness.object().frequency = 1000.0;
+    /// auto stats = harness.render(input, output);
+    /// std::cout << stats.realtime_factor() << " x real-time" << std::endl;
+    /// @endcode
+    ///
+    /// If the class declares audio_flags::inplace each output shares memory with the input of the same index,
+    /// as MSP may do, so that rendering also checks that the object is safe to process in-place.
+    ///
+    /// Every input provided by the source is treated as having a signal connection.
+    /// The inlets beyond the channels of the source are treated as unconnected.
+    /// They receive silence, or the value given to scalar().
+    /// For mc_operator<> classes the channels of the source are the channels of the first inlet.
+    /// @tparam	min_class_type	The name of your class, which extends min::object<> and one of the audio operators.
+
+    template<class min_class_type>
+    class render_harness {
+    public:
+        /// Create an instance of your object.
+        /// @param	a_samplerate	The samplerate of the dsp chain.
+        /// @param	a_vector_size	The number of samples processed by each call to the perform routine.
+        /// @param	args			Arguments for the object, as typed in an object box.
+
+        explicit render_harness(const double a_samplerate = 48000.0, const long a_vector_size = 64, const atoms& args = {})
+        : m_samplerate { a_samplerate }
+        , m_vector_size { std::max(a_vector_size, 1L) } {
+            m_minwrap_obj = wrapper_new<min_class_type>(symbol("dummy"), static_cast<long>(args.size()), args.data());
+            if (!m_minwrap_obj)
+                throw std::runtime_error("unable to create the object");
+        }
+
+        render_harness(const render_harness& other) = delete;
+        render_harness& operator=(const render_harness& other) = delete;
+
+
+        /// Destroy the instance.
+
+        ~render_harness() {
+            max::object_free(m_minwrap_obj);
+        }
+
+
+        /// Access the instance of your Min object, e.g. to set attributes before rendering.
+        /// @return	A reference to your object.
+
+        min_class_type& object() {
+            return m_minwrap_obj->m_min_object;
+        }
+
+
+        /// Render the audio of a source through the object.
+        /// The dsp chain is compiled before the first vector if it has not been compiled for this number of input channels.
+        /// @param	input			The source of the input to the object.
+        /// @param	output			The sink for the output of the object.
+        /// @param	frame_count		The number of samples to render, or -1 to render until the end of the source.
+        ///							A source without end, such as a signal_generator without a length, requires a frame count.
+        /// @return					The throughput.
+
+        render_statistics render(render_source& input, render_sink& output, const long long frame_count = -1) {
+            if (frame_count < 0 && !input.finite())
+                throw std::runtime_error("a frame count is required to render a source without end");
+
+            compile(input.channel_count());
+
+            render_statistics stats;
+            long long         remaining = frame_count < 0 ? std::numeric_limits<long long>::max() : frame_count;
+
+            while (remaining > 0) {
+                const auto requested    = static_cast<long>(std::min<long long>(m_vector_size, remaining));
+                const auto count        = input.read(m_input_pointers.data(), requested);
+
+                // the perform routine always processes a whole vector, so the remainder of the input is silent
+                for (auto channel = 0; channel < input.channel_count(); ++channel)
+                    std::fill(m_input_pointers[channel] + count, m_input_pointers[channel] + m_vector_size, 0.0);
+
+                const auto start = std::chrono::steady_clock::now();
+                m_perform(m_minwrap_obj->maxobj(), nullptr, m_input_pointers.data(), static_cast<long>(m_input_pointers.size()),
+                    m_output_pointers.data(), static_cast<long>(m_output_pointers.size()), m_vector_size, 0, nullptr);
+                stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                output.write(m_output_pointers.data(), static_cast<long>(m_output_pointers.size()), count);
+                stats.frame_count   += count;
+                remaining           -= count;
+
+                if (count < requested)
+                    break;
+            }
+            stats.duration = stats.frame_count / m_samplerate;
+            return stats;
+        }
+
+
+        /// Render the output of the object without any input, e.g. for an oscillator or synthesizer.
+        /// @param	output			The sink for the output of the object.
+        /// @param	frame_count		The number of samples to render.
+        /// @return					The throughput.
+
+        render_statistics render(render_sink& output, const long long frame_count) {
+            signal_generator silence { 0, [](long, long long) { return 0.0; } };
+            return render(silence, output, frame_count);
+        }
+
+
+        /// Set the value of an inlet that has no signal connection, as if a float had been sent to it.
+        /// As in MSP, the value is passed to the perform routine as a constant vector in place of silence.
+        /// @param	inlet	The index of the inlet.
+        /// @param	value	The new value.
+
+        void scalar(const size_t inlet, const sample value) {
+            if (m_scalars.size() <= inlet)
+                m_scalars.resize(inlet + 1, 0.0);
+            m_scalars[inlet] = value;
+
+            if (static_cast<long>(inlet) >= m_compiled_input_count && inlet < m_inputs.size())
+                std::fill(m_inputs[inlet].begin(), m_inputs[inlet].end(), value);
+        }
+
+    private:
+        minwrap<min_class_type>*    m_minwrap_obj { nullptr };
+        double                      m_samplerate;
+        long                        m_vector_size;
+        long                        m_compiled_input_count { -1 };
+        max::t_perfroutine64        m_perform { nullptr };
+        vector<sample>              m_scalars;
+        vector<sample_vector>       m_inputs;
+        vector<sample_vector>       m_outputs;
+        vector<double*>             m_input_pointers;
+        vector<double*>             m_output_pointers;
+
+
+        // Compile the dsp chain as Max would, but keep the selected perform routine rather than adding it to a dsp64 object.
+
+        void compile(const long input_count) {
+            if (input_count == m_compiled_input_count)
+                return;
+
+            auto&       object          = m_minwrap_obj->m_min_object;
+            const auto  inlet_count     = static_cast<long>(object.inlets().size());
+            vector<short> connections(object.inlets().size() + object.outlets().size(), 1);
+
+            for (auto i = input_count; i < inlet_count; ++i)
+                connections[i] = 0;
+
+            render_input_count(object, input_count);
+            min_dsp64_prepare(m_minwrap_obj, nullptr, connections.data(), m_samplerate, m_vector_size);
+            m_perform = min_dsp64_perform(m_minwrap_obj);
+
+            const auto channel_count = is_base_of<mc_operator_base, min_class_type>::value ? input_count : std::max(input_count, inlet_count);
+
+            m_inputs.assign(channel_count, sample_vector(m_vector_size, 0.0));
+            for (auto channel = static_cast<size_t>(input_count); channel < std::min(m_inputs.size(), m_scalars.size()); ++channel)
+                std::fill(m_inputs[channel].begin(), m_inputs[channel].end(), m_scalars[channel]);
+            m_outputs.assign(render_output_count(object), sample_vector(m_vector_size, 0.0));
+            m_input_pointers.clear();
+            m_output_pointers.clear();
+            for (auto& channel : m_inputs)
+                m_input_pointers.push_back(channel.data());
+            for (auto& channel : m_outputs)
+                m_output_pointers.push_back(channel.data());
+
+            // as in MSP, only connected inputs are shared, never the silence given to an unconnected inlet
+            if (m_minwrap_obj->inplace()) {
+                for (size_t channel = 0; channel < std::min(static_cast<size_t>(input_count), m_output_pointers.size()); ++channel)
+                    m_output_pointers[channel] = m_input_pointers[channel];
+            }
+
+            m_compiled_input_count = input_count;
+        }
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,285 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Convert a stream of samples from one samplerate to another with a windowed-sinc filter,
+    /// e.g. to play a buffer~ recorded at a different samplerate than that of the signal chain.
+    ///
+    /// The ratio is the number of input samples consumed for each output sample and may change for every vector.
+    /// Each output sample is the inner product of the input around its position with a Kaiser-windowed sinc filter.
+    /// The filters for 256 positions between two input samples are precomputed in a table,
+    /// and the filter for any position is interpolated between the two nearest.
+    /// When the ratio is above 1 the cutoff of the filter is lowered to prevent aliasing,
+    /// which requires a longer filter with its own table.
+    /// Tables are computed by dspsetup() for all ratios up to the maximum and are shared by all resamplers with the same quality.
+    ///
+    /// Processing is pull-based: ask how many input samples are needed for the output you want, then provide them.
+    /// @code
+    /// auto needed = m_resampler.input_required(frame_count);
+    /// // ... read `needed` samples from the source into `input` ...
+    /// m_resampler.process(input, needed, output, frame_count);
+    /// @endcode
+    /// The first output sample is aligned with the first input sample.
+    /// To do so the resampler looks ahead by latency() input samples.
+
+    class resampler {
+    public:
+        /// The number of positions between two input samples for which the filter is tabulated.
+
+        static constexpr size_t k_phase_count = 256;
+
+
+        /// Create a resampler.
+        /// @param	a_quality	The number of zero crossings of the sinc function on either side of the center of the filter,
+        ///						i.e. half the length of the filter in input samples when not lowering the cutoff.
+        ///						Higher values give a steeper cutoff at a higher cost. 8 to 32 is typical.
+
+        explicit resampler(const size_t a_quality = 16)
+        : m_quality { std::max<size_t>(a_quality, 2) }
+        {}
+
+
+        /// Allocate memory and prepare the filters.
+        /// Call this from the dspsetup message of your class.
+        /// @param	max_ratio			The highest ratio of input to output samples that will be used.
+        /// @param	max_frame_count		The largest number of output samples that will be requested at once.
+
+        void dspsetup(const double max_ratio, const long max_frame_count) {
+            m_max_ratio = std::max(max_ratio, 1.0);
+            m_tables.clear();
+            for (auto level = 0; level <= level_for_ratio(m_max_ratio); ++level)
+                m_tables.push_back(cached_table(m_quality, level));
+
+            const auto longest  = m_tables.back()->tap_count;
+            const auto input    = static_cast<size_t>(std::ceil(std::max(max_frame_count, 1L) * m_max_ratio)) + 2;
+
+            m_history.assign(2 * longest + input, 0.0);
+            ratio(m_ratio);
+            reset();
+        }
+
+
+        /// Discard the history of the input, as at the start of a new stream.
+
+        void reset() {
+            std::fill(m_history.begin(), m_history.end(), 0.0);
+
+            // zeros before the first input sample so that the longest filter can be centered on it
+            m_fill      = longest_half_length() - 1;
+            m_position  = static_cast<double>(m_fill);
+        }
+
+
+        /// Set the ratio of input to output samples, e.g. 44100.0 / 48000.0 to convert a file at 44.1 kHz for a 48 kHz signal chain.
+        /// @param	a_ratio		The ratio, limited to the range from 1/1024 to the max_ratio given to dspsetup().
+
+        void ratio(const double a_ratio) {
+            m_ratio = clamp(a_ratio, 1.0 / 1024.0, m_max_ratio);
+            m_table = m_tables.empty() ? nullptr : m_tables[level_for_ratio(m_ratio)];
+        }
+
+
+        /// Return the ratio of input to output samples.
+        /// @return	The ratio.
+
+        double ratio() const {
+            return m_ratio;
+        }
+
+
+        /// Return the number of input samples beyond the current position that are needed for an output sample.
+        /// @return	The lookahead in input samples.
+
+        long latency() const {
+            return m_table ? static_cast<long>(m_table->half_length) : 0;
+        }
+
+
+        /// Determine how many input samples must be provided to produce a number of output samples at the current ratio.
+        /// @param	output_count	The number of output samples, no more than the max_frame_count given to dspsetup().
+        /// @return					The number of input samples to pass to process().
+
+        long input_required(const long output_count) const {
+            if (!m_table || output_count <= 0)
+                return 0;
+
+            auto position = m_position;
+            for (auto i = 1; i < output_count; ++i)
+                position += m_ratio;
+
+            const auto needed = static_cast<long>(position) + static_cast<long>(m_table->half_length) + 1 - static_cast<long>(m_fill);
+            return std::max(needed, 0L);
+        }
+
+
+        /// Convert a vector of samples.
+        /// @param	input			The input samples, usually as many as input_required() returned.
+        /// @param	input_count		The number of input samples.
+        /// @param	output			Storage for the output samples.
+        /// @param	output_count	The number of output samples requested.
+        /// @return					The number of output samples produced.
+        ///							This is less than requested only if fewer input samples were provided than required.
+
+        long process(const sample* input, const long input_count, sample* output, const long output_count) {
+            if (!m_table)
+                return 0;
+
+            const auto  count   = std::min(static_cast<size_t>(std::max(input_count, 0L)), m_history.size() - m_fill);
+            const auto& table   = *m_table;
+            const auto  half    = table.half_length;
+            const auto  history = m_history.data();
+            long        i       = 0;
+
+            std::copy(input, input + count, m_history.begin() + m_fill);
+            m_fill += count;
+
+            for (; i < output_count; ++i) {
+                const auto whole = static_cast<size_t>(m_position);
+                if (whole + half >= m_fill)
+                    break;
+
+                const auto phase    = (m_position - whole) * k_phase_count;
+                const auto row      = static_cast<size_t>(phase);
+
+                output[i] = table.filter(history + whole + 1 - half, row, phase - row);
+                m_position += m_ratio;
+            }
+
+            // keep the input from the start of the longest filter for the next output sample onwards, in case the ratio changes
+            const auto next     = static_cast<size_t>(m_position) + 1;
+            const auto consumed = std::min(m_fill, next - std::min(next, longest_half_length()));
+            std::copy(m_history.begin() + consumed, m_history.begin() + m_fill, m_history.begin());
+            m_fill      -= consumed;
+            m_position  -= consumed;
+            return i;
+        }
+
+    private:
+        friend class buffer_reader;    // shares the tables for sinc interpolation
+
+        // The coefficients of a filter at each of k_phase_count + 1 positions between two input samples.
+        // The difference to the next position is stored alongside so that interpolating between positions is a second inner product.
+
+        struct table {
+            size_t          half_length;    // in input samples, a multiple of half the lanes width
+            size_t          tap_count;      // 2 * half_length
+            sample_vector   coefficients;   // (k_phase_count + 1) * tap_count
+            sample_vector   differences;    // k_phase_count * tap_count
+
+            table(const size_t quality, const double cutoff) {
+                constexpr auto  pi      = 3.14159265358979323846;
+                const auto      width   = simd::k_width / 2;
+                const auto      beta    = 8.6;    // Kaiser window for about 80 dB stopband attenuation
+
+                half_length = (static_cast<size_t>(std::ceil(quality / cutoff)) + width - 1) / width * width;
+                tap_count   = 2 * half_length;
+                coefficients.resize((k_phase_count + 1) * tap_count);
+                differences.resize(k_phase_count * tap_count);
+
+                for (size_t phase = 0; phase <= k_phase_count; ++phase) {
+                    for (size_t tap = 0; tap < tap_count; ++tap) {
+                        // the distance from the position of the output sample to the input sample under this tap
+                        const auto distance     = static_cast<double>(tap) + 1.0 - half_length - static_cast<double>(phase) / k_phase_count;
+                        const auto x            = cutoff * distance;
+                        const auto sinc         = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+                        const auto edge         = distance / half_length;
+                        const auto window       = std::abs(edge) >= 1.0 ? 0.0 : bessel_i0(beta * std::sqrt(1.0 - edge * edge)) / bessel_i0(beta);
+
+                        coefficients[phase * tap_count + tap] = cutoff * sinc * window;
+                    }
+                }
+                for (size_t i = 0; i < differences.size(); ++i)
+                    differences[i] = coefficients[i + tap_count] - coefficients[i];
+            }
+
+
+            // Filter the input around a position between two input samples.
+            // The input points to the sample under the first tap.
+
+            sample filter(const sample* input, const size_t phase, const double fraction) const {
+                constexpr auto  width   = simd::k_width;
+                const auto      c       = coefficients.data() + phase * tap_count;
+                const auto      d       = differences.data() + phase * tap_count;
+                lanes<width>    sum_c;
+                lanes<width>    sum_d;
+
+                for (size_t tap = 0; tap < tap_count; tap += width) {
+                    const auto x = lanes<width>::load(input + tap);
+                    sum_c += x * lanes<width>::load(c + tap);
+                    sum_d += x * lanes<width>::load(d + tap);
+                }
+
+                sample result = 0.0;
+                for (auto lane = 0; lane < width; ++lane)
+                    result += sum_c[lane] + sum_d[lane] * fraction;
+                return result;
+            }
+
+
+            // The modified Bessel function of the first kind and order zero, for the Kaiser window.
+
+            static double bessel_i0(const double x) {
+                double sum  = 1.0;
+                double term = 1.0;
+
+                for (auto k = 1; k < 50 && term > 1e-12 * sum; ++k) {
+                    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                    sum  += term;
+                }
+                return sum;
+            }
+        };
+
+
+        // The cutoff relative to the output Nyquist frequency, slightly below it so that the transition band fits.
+
+        static constexpr double k_cutoff = 0.95;
+
+
+        // Ratios above 1 are rounded up to the next quarter octave, each of which has a table with a lower cutoff.
+
+        static int level_for_ratio(const double a_ratio) {
+            return a_ratio <= 1.0 ? 0 : static_cast<int>(std::ceil(4.0 * std::log2(a_ratio) - 1e-9));
+        }
+
+
+        // The half length of the filter for the lowest cutoff, which determines how much input must be kept.
+
+        size_t longest_half_length() const {
+            return m_tables.empty() ? 1 : m_tables.back()->half_length;
+        }
+
+
+        // Get the table for a quality and level, computing it on first use.
+        // Tables are never freed, so that resamplers may share them without counting references on the audio thread.
+
+        static const table* cached_table(const size_t quality, const int level) {
+            static std::mutex                                       s_mutex;
+            static std::unordered_map<size_t, std::unique_ptr<table>> s_tables;
+
+            std::lock_guard<std::mutex> lock { s_mutex };
+
+            auto& found = s_tables[(quality << 8) | static_cast<size_t>(level)];
+            if (!found)
+                found = std::make_unique<table>(quality, k_cutoff / std::pow(2.0, level / 4.0));
+            return found.get();
+        }
+
+
+        size_t                  m_quality;
+        double                  m_max_ratio { 1.0 };
+        double                  m_ratio { 1.0 };
+        vector<const table*>    m_tables;
+        const table*            m_table { nullptr };
+        sample_vector           m_history;
+        size_t                  m_fill { 0 };           // the number of samples in the history
+        double                  m_position { 0.0 };     // the position of the next output sample in the history
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,584 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A fixed-width pack of samples that is processed in lock-step.
+    ///
+    /// The lanes<> type behaves like a single sample for the purposes of arithmetic.
+    /// This permits an audio operator to be written once, as a template on the sample type,
+    /// and then be called either with a single `sample` or with a `lanes<N>` of consecutive samples.
+    /// The operators are implemented as short fixed-length loops over aligned storage
+    /// which the compiler will turn into SIMD instructions for the target architecture.
+    ///
+    /// @tparam	width	The number of samples in the pack. Must be a power of two no larger than 16.
+    /// @see			sample_operator
+
+    template<size_t width>
+    struct alignas(width * sizeof(sample)) lanes {
+        static_assert(width > 0 && (width & (width - 1)) == 0 && width <= 16, "lanes width must be a power of two no larger than 16");
+
+
+        /// Create a pack with all lanes set to zero.
+
+        lanes() {
+            for (size_t i = 0; i < width; ++i)
+                m_values[i] = 0.0;
+        }
+
+
+        /// Create a pack with all lanes set to the same value.
+        /// Not marked explicit so that scalar constants can be freely mixed with lanes in expressions.
+        /// @param	value	The value to which all lanes are set.
+
+        lanes(const sample value) {
+            for (size_t i = 0; i < width; ++i)
+                m_values[i] = value;
+        }
+
+
+        /// Return the number of lanes in the pack.
+        /// @return	The number of lanes.
+
+        static constexpr size_t size() {
+            return width;
+        }
+
+
+        /// Fill a pack from consecutive samples in memory.
+        /// No alignment of the source memory is required.
+        /// @param	source	A pointer to the first of `width` samples.
+        /// @return			The filled pack.
+
+        static lanes load(const sample* source) {
+            lanes result;
+            for (size_t i = 0; i < width; ++i)
+                result.m_values[i] = source[i];
+            return result;
+        }
+
+
+        /// Write the pack to consecutive samples in memory.
+        /// No alignment of the destination memory is required.
+        /// @param	destination		A pointer to the first of `width` samples.
+
+        void store(sample* destination) const {
+            for (size_t i = 0; i < width; ++i)
+                destination[i] = m_values[i];
+        }
+
+
+        /// Read or write a single lane.
+        /// @param	index	The lane to access.
+        /// @return			A reference to the sample in that lane.
+
+        sample& operator[](const size_t index) {
+            return m_values[index];
+        }
+
+        const sample& operator[](const size_t index) const {
+            return m_values[index];
+        }
+
+
+        lanes& operator+=(const lanes& other) {
+            for (size_t i = 0; i < width; ++i)
+                m_values[i] += other.m_values[i];
+            return *this;
+        }
+
+        lanes& operator-=(const lanes& other) {
+            for (size_t i = 0; i < width; ++i)
+                m_values[i] -= other.m_values[i];
+            return *this;
+        }
+
+        lanes& operator*=(const lanes& other) {
+            for (size_t i = 0; i < width; ++i)
+                m_values[i] *= other.m_values[i];
+            return *this;
+        }
+
+        lanes& operator/=(const lanes& other) {
+            for (size_t i = 0; i < width; ++i)
+                m_values[i] /= other.m_values[i];
+            return *this;
+        }
+
+        friend lanes operator+(lanes lhs, const lanes& rhs) {
+            return lhs += rhs;
+        }
+
+        friend lanes operator-(lanes lhs, const lanes& rhs) {
+            return lhs -= rhs;
+        }
+
+        friend lanes operator*(lanes lhs, const lanes& rhs) {
+            return lhs *= rhs;
+        }
+
+        friend lanes operator/(lanes lhs, const lanes& rhs) {
+            return lhs /= rhs;
+        }
+
+        friend lanes operator-(const lanes& value) {
+            lanes result;
+            for (size_t i = 0; i < width; ++i)
+                result.m_values[i] = -value.m_values[i];
+            return result;
+        }
+
+    private:
+        sample m_values[width];
+    };
+
+
+    /// A container of N packs of samples, one for each audio output of a batched sample_operator<>.
+    /// This is the batched counterpart of samples<N>.
+    /// @tparam	count	The number of packs (e.g. the number of outputs).
+    /// @tparam	width	The number of lanes in each pack.
+
+    template<size_t count, size_t width>
+    using lane_samples = std::array<lanes<width>, count>;
+
+
+    /// Apply a function to each lane of a pack.
+    /// This is the escape hatch for math that has no lane-wise operator, e.g. `std::tanh`.
+    /// @param	value		The input pack.
+    /// @param	function	A callable taking and returning a sample.
+    /// @return				A pack with the function applied to each lane.
+
+    template<size_t width, class function_type>
+    lanes<width> apply(const lanes<width>& value, function_type function) {
+        lanes<width> result;
+        for (size_t i = 0; i < width; ++i)
+            result[i] = function(value[i]);
+        return result;
+    }
+
+
+    /// Return the lane-wise minimum of two packs.
+
+    template<size_t width>
+    lanes<width> minimum(const lanes<width>& a, const lanes<width>& b) {
+        lanes<width> result;
+        for (size_t i = 0; i < width; ++i)
+            result[i] = a[i] < b[i] ? a[i] : b[i];
+        return result;
+    }
+
+
+    /// Return the lane-wise maximum of two packs.
+
+    template<size_t width>
+    lanes<width> maximum(const lanes<width>& a, const lanes<width>& b) {
+        lanes<width> result;
+        for (size_t i = 0; i < width; ++i)
+            result[i] = a[i] > b[i] ? a[i] : b[i];
+        return result;
+    }
+
+
+    /// Return the lane-wise absolute value of a pack.
+
+    template<size_t width>
+    lanes<width> abs(const lanes<width>& value) {
+        lanes<width> result;
+        for (size_t i = 0; i < width; ++i)
+            result[i] = value[i] < 0.0 ? -value[i] : value[i];
+        return result;
+    }
+
+
+    /// Limit each lane of a pack to within a specified range.
+    /// The lanes counterpart of clamp() from c74_min_limit.h.
+
+    template<size_t width>
+    lanes<width> clamp(const lanes<width>& value, const sample low_bound, const sample high_bound) {
+        lanes<width> result;
+        for (size_t i = 0; i < width; ++i)
+            result[i] = value[i] < low_bound ? low_bound : (value[i] > high_bound ? high_bound : value[i]);
+        return result;
+    }
+
+
+
+    /// Kernels for common operations on vectors of samples.
+    /// Each kernel processes the bulk of the vector using lanes<> packs and finishes any remaining tail one sample at a time.
+    /// No alignment is required: the pack loads and stores compile to unaligned vector instructions,
+    /// which are as fast as aligned ones on current processors when the memory is aligned, as MSP's vectors are.
+    /// Source and destination may be the same memory, but must not otherwise overlap.
+
+    namespace simd {
+
+        /// The number of lanes used by the kernels in this namespace.
+
+        static constexpr size_t k_width = 4;
+
+
+        // Return the number of frames that can be processed as whole packs.
+
+        inline long bulk_count(const long frame_count) {
+            return frame_count - (frame_count % static_cast<long>(k_width));
+        }
+
+
+        /// Set a vector of samples to zero.
+        /// @param	destination		The samples to clear.
+        /// @param	frame_count		The number of samples.
+
+        inline void clear(sample* destination, const long frame_count) {
+            std::memset(destination, 0, sizeof(sample) * frame_count);
+        }
+
+
+        /// Copy a vector of samples.
+        /// @param	destination		The samples to write.
+        /// @param	source			The samples to read.
+        /// @param	frame_count		The number of samples.
+
+        inline void copy(sample* destination, const sample* source, const long frame_count) {
+            if (destination != source)
+                std::memcpy(destination, source, sizeof(sample) * frame_count);
+        }
+
+
+        /// Add a vector of samples to another: destination += source.
+        /// @param	destination		The samples to accumulate into.
+        /// @param	source			The samples to add.
+        /// @param	frame_count		The number of samples.
+
+        inline void add(sample* destination, const sample* source, const long frame_count) {
+            const auto bulk = bulk_count(frame_count);
+
+            for (long i = 0; i < bulk; i += k_width)
+                (lanes<k_width>::load(destination + i) + lanes<k_width>::load(source + i)).store(destination + i);
+            for (auto i = bulk; i < frame_count; ++i)
+                destination[i] += source[i];
+        }
+
+
+        /// Add a scaled vector of samples to another: destination += source * gain.
+        /// @param	destination		The samples to accumulate into.
+        /// @param	source			The samples to scale and add.
+        /// @param	gain			The linear gain applied to the source.
+        /// @param	frame_count		The number of samples.
+
+        inline void multiply_add(sample* destination, const sample* source, const sample gain, const long frame_count) {
+            const auto          bulk = bulk_count(frame_count);
+            const lanes<k_width> g { gain };
+
+            for (long i = 0; i < bulk; i += k_width)
+                (lanes<k_width>::load(destination + i) + lanes<k_width>::load(source + i) * g).store(destination + i);
+            for (auto i = bulk; i < frame_count; ++i)
+                destination[i] += source[i] * gain;
+        }
+
+
+        /// Scale a vector of samples: destination = source * gain.
+        /// @param	destination		The samples to write.
+        /// @param	source			The samples to scale.
+        /// @param	gain			The linear gain applied to the source.
+        /// @param	frame_count		The number of samples.
+
+        inline void gain(sample* destination, const sample* source, const sample gain, const long frame_count) {
+            const auto          bulk = bulk_count(frame_count);
+            const lanes<k_width> g { gain };
+
+            for (long i = 0; i < bulk; i += k_width)
+                (lanes<k_width>::load(source + i) * g).store(destination + i);
+            for (auto i = bulk; i < frame_count; ++i)
+                destination[i] = source[i] * gain;
+        }
+
+
+        /// Scale a vector of samples by a linear ramp: destination = source * gain.
+        /// The gain of the first sample is start_gain and increases by a constant step for each sample
+        /// such that the following vector can begin with a gain of end_gain without a discontinuity.
+        /// @param	destination		The samples to write.
+        /// @param	source			The samples to scale.
+        /// @param	start_gain		The linear gain applied to the first sample.
+        /// @param	end_gain		The linear gain at which the ramp ends (one sample past the end of the vector).
+        /// @param	frame_count		The number of samples.
+
+        inline void gain_ramp(sample* destination, const sample* source, const sample start_gain, const sample end_gain, const long frame_count) {
+            if (frame_count <= 0)
+                return;
+
+            const auto      bulk = bulk_count(frame_count);
+            const auto      step = (end_gain - start_gain) / frame_count;
+            lanes<k_width>  g;
+
+            for (size_t i = 0; i < k_width; ++i)
+                g[i] = start_gain + step * i;
+
+            const lanes<k_width> g_step { step * k_width };
+
+            for (long i = 0; i < bulk; i += k_width) {
+                (lanes<k_width>::load(source + i) * g).store(destination + i);
+                g += g_step;
+            }
+            for (auto i = bulk; i < frame_count; ++i)
+                destination[i] = source[i] * (start_gain + step * i);
+        }
+
+
+
+        /// Find the largest absolute value in a vector of samples.
+        /// @param	source			The samples to scan.
+        /// @param	frame_count		The number of samples.
+        /// @return					The peak absolute value, or zero for an empty vector.
+
+        inline sample peak(const sample* source, const long frame_count) {
+            const auto      bulk = bulk_count(frame_count);
+            lanes<k_width>  p;
+            sample          result = 0.0;
+
+            for (long i = 0; i < bulk; i += k_width)
+                p = maximum(p, abs(lanes<k_width>::load(source + i)));
+            for (size_t i = 0; i < k_width; ++i)
+                result = p[i] > result ? p[i] : result;
+            for (auto i = bulk; i < frame_count; ++i)
+                result = std::fabs(source[i]) > result ? std::fabs(source[i]) : result;
+            return result;
+        }
+
+
+        /// Determine whether a vector of samples is silent, i.e. contains only zeros.
+        /// A vector containing a NaN is not silent.
+        /// @param	source			The samples to scan.
+        /// @param	frame_count		The number of samples.
+        /// @return					True if every sample is zero.
+
+        inline bool silent(const sample* source, const long frame_count) {
+            const auto      bulk = bulk_count(frame_count);
+            lanes<k_width>  sum;
+            sample          result = 0.0;
+
+            // a sum of absolute values can't cancel out, and it is NaN if any sample is NaN
+            for (long i = 0; i < bulk; i += k_width)
+                sum += abs(lanes<k_width>::load(source + i));
+            for (size_t i = 0; i < k_width; ++i)
+                result += sum[i];
+            for (auto i = bulk; i < frame_count; ++i)
+                result += std::fabs(source[i]);
+            return result == 0.0;
+        }
+
+
+
+        // Transposing between interleaved floats, as stored by a buffer~, and one vector of samples for each channel.
+        // Blocks of four frames are transposed with shuffles of four floats where the processor is known to have them.
+        // The remaining frames, and all frames on other processors, are copied by loops with a fixed channel count,
+        // which the compiler vectorizes where it can.
+
+#if defined(__x86_64__) || defined(_M_X64)
+        using float_pack = __m128;
+
+
+        inline float_pack load_samples(const sample* source) {
+            return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(source)), _mm_cvtpd_ps(_mm_loadu_pd(source + 2)));
+        }
+
+
+        inline void store_samples(sample* destination, const float_pack value) {
+            _mm_storeu_pd(destination, _mm_cvtps_pd(value));
+            _mm_storeu_pd(destination + 2, _mm_cvtps_pd(_mm_movehl_ps(value, value)));
+        }
+
+
+        // The number of frames in whole blocks of four, which the shuffles transpose whatever the width of the lanes.
+
+        inline long block_count(const long frame_count) {
+            return frame_count - (frame_count % 4);
+        }
+
+
+        // Deinterleave whole blocks of four frames and return the number of frames done.
+
+        template<size_t channel_count>
+        long deinterleave_blocks(sample* const* destination, const float* source, const long frame_count) {
+            static_assert(channel_count % 4 == 0, "blocks of other channel counts are specialized below");
+
+            const auto bulk = block_count(frame_count);
+
+            for (auto i = 0; i < bulk; i += 4) {
+                for (size_t channel = 0; channel < channel_count; channel += 4) {
+                    const auto  frames  = source + i * channel_count + channel;
+                    auto        a       = _mm_loadu_ps(frames);
+                    auto        b       = _mm_loadu_ps(frames + channel_count);
+                    auto        c       = _mm_loadu_ps(frames + channel_count * 2);
+                    auto        d       = _mm_loadu_ps(frames + channel_count * 3);
+
+                    _MM_TRANSPOSE4_PS(a, b, c, d);
+                    store_samples(destination[channel] + i, a);
+                    store_samples(destination[channel + 1] + i, b);
+                    store_samples(destination[channel + 2] + i, c);
+                    store_samples(destination[channel + 3] + i, d);
+                }
+            }
+            return bulk;
+        }
+
+        template<>
+        inline long deinterleave_blocks<1>(sample* const* destination, const float* source, const long frame_count) {
+            const auto bulk = block_count(frame_count);
+
+            for (auto i = 0; i < bulk; i += 4)
+                store_samples(destination[0] + i, _mm_loadu_ps(source + i));
+            return bulk;
+        }
+
+        template<>
+        inline long deinterleave_blocks<2>(sample* const* destination, const float* source, const long frame_count) {
+            const auto bulk = block_count(frame_count);
+
+            for (auto i = 0; i < bulk; i += 4) {
+                const auto a = _mm_loadu_ps(source + i * 2);
+                const auto b = _mm_loadu_ps(source + i * 2 + 4);
+
+                store_samples(destination[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                store_samples(destination[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+            return bulk;
+        }
+
+
+        // Interleave whole blocks of four frames and return the number of frames done.
+
+        template<size_t channel_count>
+        long interleave_blocks(float* destination, const sample* const* source, const long frame_count) {
+            static_assert(channel_count % 4 == 0, "blocks of other channel counts are specialized below");
+
+            const auto bulk = block_count(frame_count);
+
+            for (auto i = 0; i < bulk; i += 4) {
+                for (size_t channel = 0; channel < channel_count; channel += 4) {
+                    const auto  frames  = destination + i * channel_count + channel;
+                    auto        a       = load_samples(source[channel] + i);
+                    auto        b       = load_samples(source[channel + 1] + i);
+                    auto        c       = load_samples(source[channel + 2] + i);
+                    auto        d       = load_samples(source[channel + 3] + i);
+
+                    _MM_TRANSPOSE4_PS(a, b, c, d);
+                    _mm_storeu_ps(frames, a);
+                    _mm_storeu_ps(frames + channel_count, b);
+                    _mm_storeu_ps(frames + channel_count * 2, c);
+                    _mm_storeu_ps(frames + channel_count * 3, d);
+                }
+            }
+            return bulk;
+        }
+
+        template<>
+        inline long interleave_blocks<1>(float* destination, const sample* const* source, const long frame_count) {
+            const auto bulk = block_count(frame_count);
+
+            for (auto i = 0; i < bulk; i += 4)
+                _mm_storeu_ps(destination + i, load_samples(source[0] + i));
+            return bulk;
+        }
+
+        template<>
+        inline long interleave_blocks<2>(float* destination, const sample* const* source, const long frame_count) {
+            const auto bulk = block_count(frame_count);
+
+            for (auto i = 0; i < bulk; i += 4) {
+                const auto left     = load_samples(source[0] + i);
+                const auto right    = load_samples(source[1] + i);
+
+                _mm_storeu_ps(destination + i * 2, _mm_unpacklo_ps(left, right));
+                _mm_storeu_ps(destination + i * 2 + 4, _mm_unpackhi_ps(left, right));
+            }
+            return bulk;
+        }
+#else
+        template<size_t channel_count>
+        long deinterleave_blocks(sample* const*, const float*, const long) {
+            return 0;
+        }
+
+        template<size_t channel_count>
+        long interleave_blocks(float*, const sample* const*, const long) {
+            return 0;
+        }
+#endif
+
+
+        template<size_t channel_count>
+        void deinterleave_fixed(sample* const* destination, const float* source, const long frame_count) {
+            sample* channels[channel_count];
+
+            std::copy(destination, destination + channel_count, channels);
+            for (auto i = deinterleave_blocks<channel_count>(destination, source, frame_count); i < frame_count; ++i) {
+                for (size_t channel = 0; channel < channel_count; ++channel)
+                    channels[channel][i] = source[i * channel_count + channel];
+            }
+        }
+
+
+        template<size_t channel_count>
+        void interleave_fixed(float* destination, const sample* const* source, const long frame_count) {
+            const sample* channels[channel_count];
+
+            std::copy(source, source + channel_count, channels);
+            for (auto i = interleave_blocks<channel_count>(destination, source, frame_count); i < frame_count; ++i) {
+                for (size_t channel = 0; channel < channel_count; ++channel)
+                    destination[i * channel_count + channel] = static_cast<float>(channels[channel][i]);
+            }
+        }
+
+
+        /// Split interleaved frames, such as those of a buffer~, into one vector of samples for each channel.
+        /// 1, 2, 4 and 8 channels are transposed with vector shuffles, other channel counts one sample at a time.
+        /// @param	destination		Storage for each channel: channel_count pointers to at least frame_count samples.
+        /// @param	source			The interleaved samples of frame_count frames.
+        /// @param	channel_count	The number of interleaved channels.
+        /// @param	frame_count		The number of frames.
+        /// @see					interleave()
+
+        inline void deinterleave(sample* const* destination, const float* source, const size_t channel_count, const long frame_count) {
+            switch (channel_count) {
+                case 1:     deinterleave_fixed<1>(destination, source, frame_count); break;
+                case 2:     deinterleave_fixed<2>(destination, source, frame_count); break;
+                case 4:     deinterleave_fixed<4>(destination, source, frame_count); break;
+                case 8:     deinterleave_fixed<8>(destination, source, frame_count); break;
+                default:
+                    for (auto i = 0; i < frame_count; ++i) {
+                        for (size_t channel = 0; channel < channel_count; ++channel)
+                            destination[channel][i] = source[i * channel_count + channel];
+                    }
+            }
+        }
+
+
+        /// Merge one vector of samples for each channel into interleaved frames, such as those of a buffer~.
+        /// 1, 2, 4 and 8 channels are transposed with vector shuffles, other channel counts one sample at a time.
+        /// @param	destination		Storage for the interleaved samples of frame_count frames.
+        /// @param	source			The samples of each channel: channel_count pointers to at least frame_count samples.
+        /// @param	channel_count	The number of interleaved channels.
+        /// @param	frame_count		The number of frames.
+        /// @see					deinterleave()
+
+        inline void interleave(float* destination, const sample* const* source, const size_t channel_count, const long frame_count) {
+            switch (channel_count) {
+                case 1:     interleave_fixed<1>(destination, source, frame_count); break;
+                case 2:     interleave_fixed<2>(destination, source, frame_count); break;
+                case 4:     interleave_fixed<4>(destination, source, frame_count); break;
+                case 8:     interleave_fixed<8>(destination, source, frame_count); break;
+                default:
+                    for (auto i = 0; i < frame_count; ++i) {
+                        for (size_t channel = 0; channel < channel_count; ++channel)
+                            destination[i * channel_count + channel] = static_cast<float>(source[channel][i]);
+                    }
+            }
+        }
+
+    }    // namespace simd
+
+}    // namespace c74::min
@@ -0,0 +1,269 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The values of a smoothed attribute for one vector of audio, as returned by smoothed::next().
+    /// When the ramp has settled the span is constant and no per-sample values are calculated.
+    /// In that case you should use value() rather than indexing the span.
+
+    class smoothed_span {
+    public:
+        smoothed_span(const sample* a_values, const sample a_value, const long a_frame_count)
+        : m_values { a_values }
+        , m_value { a_value }
+        , m_frame_count { a_frame_count }
+        {}
+
+
+        /// Is the value the same for every sample in the vector?
+        /// @return	True if the ramp has settled. Otherwise false.
+
+        bool constant() const {
+            return m_values == nullptr;
+        }
+
+
+        /// The value at the end of the vector.
+        /// If the span is constant this is the value for every sample in the vector.
+        /// @return	The value at the end of the vector.
+
+        sample value() const {
+            return m_value;
+        }
+
+
+        /// Get a pointer to the per-sample values.
+        /// @return	A pointer to the values or nullptr if the span is constant.
+
+        const sample* data() const {
+            return m_values;
+        }
+
+
+        /// Get the value for a specific sample in the vector.
+        /// This works for both constant and ramping spans but will perform a check for each call.
+        /// @param	index	The index of the sample in the vector.
+        /// @return			The value for that sample.
+
+        sample operator[](const size_t index) const {
+            return m_values ? m_values[index] : m_value;
+        }
+
+
+        /// The number of samples in the span.
+        /// @return	The number of samples in the span.
+
+        long frame_count() const {
+            return m_frame_count;
+        }
+
+    private:
+        const sample*   m_values;
+        sample          m_value;
+        long            m_frame_count;
+    };
+
+
+    /// Linear ramping of a numeric attribute to remove zipper noise when the attribute value changes.
+    ///
+    /// The smoothed object follows an attribute of the owning audio class.
+    /// When the attribute is assigned a new value the smoothed output ramps from the current value to the new value
+    /// over the specified ramp time.
+    /// Once the ramp has arrived at the target the output is constant until the attribute changes again.
+    ///
+    /// Any attribute with an arithmetic type may be followed, e.g. attribute<number>, attribute<int> or attribute<float>.
+    ///
+    /// In a vector_operator<> call next() once per vector and use the returned span.
+    /// The storage for the span is allocated for the vector size when the dsp chain is compiled:
+    /// @code
+    /// attribute<number>   m_gain          { this, "gain", 1.0 };
+    /// smoothed            m_gain_smoothed { this, m_gain, 20.0 };
+    ///
+    /// void operator()(audio_bundle input, audio_bundle output) {
+    ///     auto gain = m_gain_smoothed.next(input.frame_count());
+    ///
+    ///     if (gain.constant()) {
+    ///         for (auto i = 0; i < input.frame_count(); ++i)
+    ///             output.samples(0)[i] = input.samples(0)[i] * gain.value();
+    ///     }
+    ///     else {
+    ///         for (auto i = 0; i < input.frame_count(); ++i)
+    ///             output.samples(0)[i] = input.samples(0)[i] * gain.data()[i];
+    ///     }
+    /// }
+    /// @endcode
+    ///
+    /// In a sample_operator<> call the smoothed object once per sample instead.
+
+    class smoothed {
+    public:
+        /// Create a smoothed follower of an attribute.
+        /// @param	an_owner			The owning audio object. Typically you will pass `this`.
+        ///								The owner's samplerate() is used to calculate the length of the ramps.
+        /// @param	an_attribute		The numeric attribute to follow.
+        /// @param	a_ramp_time_in_ms	The time it takes to ramp to a new value.
+
+        template<class owner_type, class attribute_type>
+        smoothed(owner_type* an_owner, attribute_type& an_attribute, const double a_ramp_time_in_ms)
+        : m_samplerate { [an_owner]() { return an_owner->samplerate(); } }
+        , m_source { &an_attribute.get() }
+        , m_read_source { &read_source<typename std::decay<decltype(an_attribute.get())>::type> }
+        , m_ramp_time_in_ms { a_ramp_time_in_ms }
+        , m_current { m_read_source(m_source) }
+        , m_target { m_current }
+        {
+            an_owner->smoothed_attributes().push_back(this);
+        }
+
+        smoothed(const smoothed& other) = delete;
+        smoothed& operator=(const smoothed& other) = delete;
+
+
+        /// Set the time it takes to ramp to a new value.
+        /// A ramp in progress will continue at its previous rate.
+        /// @param	a_ramp_time_in_ms	The new ramp time.
+
+        void ramp_time(const double a_ramp_time_in_ms) {
+            m_ramp_time_in_ms = a_ramp_time_in_ms;
+        }
+
+
+        /// Return the time it takes to ramp to a new value.
+        /// @return	The ramp time in milliseconds.
+
+        double ramp_time() const {
+            return m_ramp_time_in_ms;
+        }
+
+
+        /// Allocate the storage for the values of a vector.
+        /// You will not typically have any need to call this.
+        /// It is called for the vector size of the owner when the dsp chain is compiled.
+        /// @param	max_frame_count		The largest number of samples that will be passed to next().
+
+        void dspsetup(const long max_frame_count) {
+            m_values.assign(static_cast<size_t>(std::max(1L, max_frame_count)), 0.0);
+        }
+
+
+        /// Is the value currently ramping?
+        /// @return	True if a ramp is in progress. Otherwise false.
+
+        bool ramping() const {
+            return m_remaining > 0;
+        }
+
+
+        /// Jump directly to the current attribute value without ramping.
+        /// Typically called when audio processing is (re-)started.
+
+        void reset() {
+            m_target    = m_read_source(m_source);
+            m_current   = m_target;
+            m_remaining = 0;
+        }
+
+
+        /// Calculate the values for the next vector.
+        /// No memory is allocated: if the vector is longer than the storage allocated by dspsetup()
+        /// the value jumps to the attribute value rather than ramping.
+        /// Debug builds assert if there is no storage at all, e.g. because the dsp chain has not been compiled.
+        /// @param	frame_count		The number of samples in the vector.
+        /// @return					A span with the value of each sample.
+        ///							If the ramp has settled the span is constant.
+
+        smoothed_span next(const long frame_count) {
+            update_target();
+
+            assert((m_remaining == 0 || !m_values.empty()) && "smoothed::next() ramps before storage is allocated by dspsetup()");
+
+            if (m_remaining > 0 && m_values.size() < static_cast<size_t>(frame_count)) {
+                m_remaining = 0;
+                m_current   = m_target;
+            }
+
+            if (m_remaining == 0)
+                return { nullptr, m_current, frame_count };
+
+            const auto ramp_count   = std::min<long>(frame_count, m_remaining);
+            const auto start        = m_current;
+            const auto step         = m_step;
+            const auto target       = m_target;
+            auto       values       = m_values.data();
+
+            for (auto i = 0; i < ramp_count; ++i)
+                values[i] = start + step * (i + 1);
+            for (auto i = ramp_count; i < frame_count; ++i)
+                values[i] = target;
+
+            m_remaining -= ramp_count;
+            m_current    = (m_remaining == 0) ? target : values[ramp_count - 1];
+
+            return { values, m_current, frame_count };
+        }
+
+
+        /// Calculate the value for the next sample.
+        /// @return	The value of the sample.
+
+        sample operator()() {
+            update_target();
+
+            if (m_remaining == 0)
+                return m_current;
+
+            --m_remaining;
+            m_current = (m_remaining == 0) ? m_target : m_current + m_step;
+            return m_current;
+        }
+
+    private:
+        using source_reader = sample (*)(const void* source);
+
+        std::function<double()> m_samplerate;
+        const void*             m_source;
+        source_reader           m_read_source;
+        double                  m_ramp_time_in_ms;
+        sample                  m_current;
+        sample                  m_target;
+        sample                  m_step { 0.0 };
+        long                    m_remaining { 0 };
+        sample_vector           m_values;
+
+
+        // Read the native value of the attribute, whatever its arithmetic type.
+
+        template<class T>
+        static sample read_source(const void* source) {
+            static_assert(std::is_arithmetic<T>::value, "smoothed can only follow attributes with an arithmetic type");
+            return static_cast<sample>(*static_cast<const T*>(source));
+        }
+
+
+        // Start a new ramp if the attribute has been assigned a new value.
+
+        void update_target() {
+            const auto target = m_read_source(m_source);
+
+            if (target == m_target)
+                return;
+
+            m_target    = target;
+            m_remaining = static_cast<long>(m_ramp_time_in_ms * 0.001 * m_samplerate() + 0.5);
+
+            if (m_remaining <= 0) {
+                m_remaining = 0;
+                m_current   = m_target;
+            }
+            else
+                m_step = (m_target - m_current) / m_remaining;
+        }
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,742 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The layout of the samples in a raw file for a stream_reference.
+    /// Samples are little-endian, as in a WAV file.
+    /// @ingroup buffers
+
+    struct stream_format {
+        size_t  channel_count { 0 };        ///< The number of interleaved channels, or 0 to read the format from the header of a WAV file.
+        int     bits { 16 };                ///< The size of a sample: 8, 16, 24 or 32 for integers, 32 or 64 for floating-point.
+        bool    floating_point { false };   ///< True for floating-point samples, false for integers. 8-bit integers are unsigned.
+        double  samplerate { 44100.0 };     ///< The sample rate of the file.
+        size_t  offset { 0 };               ///< The number of bytes before the first sample, e.g. to skip a header.
+    };
+
+
+    /// A reference to an audio file that is played from disk rather than loaded into memory,
+    /// e.g. for sample libraries that are too large for buffer~ objects.
+    ///
+    /// The file is memory-mapped when it is opened, which is immediate because nothing is read or decoded up front.
+    /// The background_thread then decodes the frames that follow the play position into a ring of read_ahead() frames,
+    /// which the audio thread reads without locking and without touching the file, so the cost of a read is always the same.
+    /// When the ring runs dry, e.g. because the disk is slow, the audio thread outputs silence and counts an underrun,
+    /// and playback continues where it stopped when the background_thread catches up.
+    /// If underruns() grows while playing, increase the read-ahead. lowest_available() shows how close the ring came to running dry.
+    /// @code
+    /// stream_reference m_stream { this };    // adds an "open" message, e.g. "open piano-c4.wav"
+    ///
+    /// message<> bang { this, "bang", "Play from the start.",
+    ///     MIN_FUNCTION {
+    ///         m_stream.seek(0);
+    ///         return {};
+    ///     }
+    /// };
+    ///
+    /// void operator()(audio_bundle input, audio_bundle output) {
+    ///     m_stream.read(output);
+    /// }
+    /// @endcode
+    /// WAV files with integer samples of 8, 16, 24 or 32 bits or floating-point samples of 32 or 64 bits are supported,
+    /// as are raw files in any of these formats, described with a stream_format.
+    /// @ingroup buffers
+
+    class stream_reference : private background_thread::client {
+    public:
+        /// The number of frames decoded ahead of the play position unless another is given to the constructor.
+
+        static constexpr size_t k_default_read_ahead = 65536;
+
+
+        /// Create a reference to a file to stream.
+        /// @param	an_owner		The owning object for the stream reference. Typically you will pass `this`.
+        ///							May be nullptr to use the stream outside of an object, in which case no messages are created.
+        /// @param	a_function		An optional function called after the "open" message has opened a file, with its name as the argument.
+        /// @param	create_messages	Optionally have min create an "open" message on `an_owner`.
+        /// @param	read_ahead		The number of frames to decode ahead of the play position, rounded up to a power of two.
+        ///							Larger values survive longer stalls of the disk at the cost of memory.
+
+        stream_reference(object_base* an_owner, const function& a_function = nullptr, const bool create_messages = true, const size_t read_ahead = k_default_read_ahead)
+        : m_owner { an_owner }
+        , m_notification_callback { a_function }
+        , m_read_ahead { limit_to_power_of_two(std::max<size_t>(read_ahead, 64)) }
+        {
+            background_thread::shared().add(this);
+
+            if (create_messages && m_owner) {
+                m_open_meth = std::make_unique<message<>>(m_owner, "open", "Choose a file from which to stream.",
+                    MIN_FUNCTION {
+                        if (args.empty())
+                            return {};
+
+                        const auto name = static_cast<string>(args[0]);
+
+                        if (!open(name))
+                            max::object_error(*m_owner, "can't open %s", name.c_str());
+                        else if (m_notification_callback)
+                            m_notification_callback({ args[0] }, -1);
+                        return {};
+                    }
+                );
+            }
+        }
+
+        stream_reference(const stream_reference& source) = delete;
+        stream_reference(stream_reference&& source)      = delete;
+        stream_reference& operator=(const stream_reference& source) = delete;
+        stream_reference& operator=(stream_reference&& source) = delete;
+
+
+        /// Wait for any decoding on the background_thread and close the file.
+        /// The audio thread must no longer be reading.
+
+        ~stream_reference() {
+            background_thread::shared().remove(this);
+
+            delete m_active;
+            delete m_published.load();
+            delete m_released.load();
+        }
+
+
+        /// Open a file in the Max search path, or at an absolute path, and play it from the start.
+        /// Must not be called from the audio thread.
+        /// @param	name	The name of the file.
+        /// @param	format	The layout of the samples of a raw file, or the default to read the header of a WAV file.
+        /// @return			True if the file was opened. Otherwise the previous file continues to play.
+
+        bool open(const string& name, const stream_format& format = {}) {
+            try {
+                const path file { name, format.channel_count ? path::filetype::any : path::filetype::audio };
+                return open_file(static_cast<string>(file), format);
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+
+
+        /// Open a file at a path in the file system, without looking in the Max search path, and play it from the start.
+        /// Must not be called from the audio thread.
+        /// @param	file_path	The path of the file.
+        /// @param	format		The layout of the samples of a raw file, or the default to read the header of a WAV file.
+        /// @return				True if the file was opened. Otherwise the previous file continues to play.
+
+        bool open_file(const string& file_path, const stream_format& format = {}) {
+            auto next = std::make_unique<stream>(file_path);
+
+            if (!next->parse(format))
+                return false;
+            next->ring.assign(m_read_ahead * next->format.channel_count, 0.0f);
+            next->mask = m_read_ahead - 1;
+
+            m_frame_count.store(next->frame_count, std::memory_order_relaxed);
+            m_channel_count.store(next->format.channel_count, std::memory_order_relaxed);
+            m_samplerate.store(next->format.samplerate, std::memory_order_relaxed);
+
+            // wake a few times during the read-ahead, but not so often that an idle stream costs anything
+            const auto read_ahead_ms = 1000.0 * static_cast<double>(m_read_ahead) / std::max(next->format.samplerate, 1.0);
+            next->period = std::chrono::microseconds { static_cast<long long>(1000.0 * clamp(read_ahead_ms / 8.0, 1.0, 20.0)) };
+
+            replace(next.release());
+            return true;
+        }
+
+
+        /// Stop playing and close the file.
+        /// Must not be called from the audio thread.
+
+        void close() {
+            m_frame_count.store(0, std::memory_order_relaxed);
+            m_channel_count.store(0, std::memory_order_relaxed);
+            replace(new stream {});
+        }
+
+
+        /// Move the play position.
+        /// The stream is silent until the background_thread has decoded the frames at the new position.
+        /// May be called from any thread, including the audio thread.
+        /// @param	frame	The frame from which to play, limited to the end of the file.
+
+        void seek(const size_t frame) {
+            m_seek_frame.store(frame, std::memory_order_relaxed);
+            m_seek_requested.fetch_add(1, std::memory_order_release);
+            background_thread::shared().wake();
+        }
+
+
+        /// Determine if a seek has not yet been carried out by the background_thread.
+        /// @return	True if a seek is pending.
+
+        bool seeking() const {
+            return m_seek_requested.load(std::memory_order_acquire) != m_seek_handled.load(std::memory_order_acquire);
+        }
+
+
+        /// Play the file from the start again each time the end is reached.
+        /// @param	a_looping	True to loop.
+
+        void looping(const bool a_looping) {
+            m_looping.store(a_looping, std::memory_order_relaxed);
+        }
+
+
+        /// Determine if the file is played in a loop.
+        /// @return	True if looping.
+
+        bool looping() const {
+            return m_looping.load(std::memory_order_relaxed);
+        }
+
+
+        /// Return the number of frames decoded ahead of the play position.
+        /// @return	The size of the ring in frames.
+
+        size_t read_ahead() const {
+            return m_read_ahead;
+        }
+
+
+        /// Return the length of the file most recently opened.
+        /// @return	The number of frames, or 0 if no file is open.
+
+        size_t frame_count() const {
+            return m_frame_count.load(std::memory_order_relaxed);
+        }
+
+
+        /// Return the number of channels of the file most recently opened.
+        /// @return	The number of channels, or 0 if no file is open.
+
+        size_t channel_count() const {
+            return m_channel_count.load(std::memory_order_relaxed);
+        }
+
+
+        /// Return the sample rate of the file most recently opened.
+        /// @return	The sample rate.
+
+        double samplerate() const {
+            return m_samplerate.load(std::memory_order_relaxed);
+        }
+
+
+        /// Read the next frames of the file.
+        /// Must only be called from the audio thread.
+        /// Output channels beyond those of the file are silent.
+        /// @param	channels		Storage for the samples of each channel.
+        /// @param	channel_count	The number of channels of storage.
+        /// @param	frame_count		The number of frames to read.
+        /// @return					The number of frames read from the file.
+        ///							Any frames after these are silent, either because the ring ran dry or the end of the file was reached.
+
+        long read(sample* const* channels, const long channel_count, const long frame_count) {
+            long count = 0;
+
+            acquire();
+            if (m_active)
+                count = read_frames(*m_active, channels, channel_count, std::max(frame_count, 0L));
+
+            for (auto channel = 0; channel < channel_count; ++channel)
+                std::fill(channels[channel] + count, channels[channel] + std::max(frame_count, count), 0.0);
+            return count;
+        }
+
+
+        /// Read the next frames of the file into all channels of an audio_bundle.
+        /// Must only be called from the audio thread.
+        /// @param	output	The audio to fill.
+        /// @return			The number of frames read from the file.
+
+        long read(audio_bundle output) {
+            return read(output.samples(), output.channel_count(), output.frame_count());
+        }
+
+
+        /// Return the number of frames that are ready to be read.
+        /// Must only be called from the audio thread.
+        /// @return	The number of frames in the ring.
+
+        size_t available() {
+            acquire();
+            if (!m_active)
+                return 0;
+
+            skip_flushed(*m_active);
+            return m_active->write.load(std::memory_order_acquire) - m_active->read.load(std::memory_order_relaxed);
+        }
+
+
+        /// Determine if the whole file has been read and the stream is silent, because it isn't looping or no file is open.
+        /// Must only be called from the audio thread.
+        /// @return	True if the stream has ended.
+
+        bool finished() {
+            acquire();
+            return !m_active || (available() == 0 && m_active->finished.load(std::memory_order_acquire));
+        }
+
+
+        /// Return the number of reads since the last reset_underruns() that could not be filled because the ring ran dry.
+        /// The silence before the first frames arrive after opening a file or seeking is not counted.
+        /// @return	The number of underruns.
+
+        size_t underruns() const {
+            return m_underruns.load(std::memory_order_relaxed);
+        }
+
+
+        /// Return the number of silent frames output because of underruns since the last reset_underruns().
+        /// @return	The number of frames.
+
+        size_t underrun_frames() const {
+            return m_underrun_frames.load(std::memory_order_relaxed);
+        }
+
+
+        /// Return the fewest frames that were ready at the start of a read since the last reset_underruns(),
+        /// not counting reads at the end of the file or before the first frames arrive after opening or seeking.
+        /// A value near zero means that the read-ahead is barely large enough.
+        /// @return	The number of frames, which is read_ahead() if nothing has been read.
+
+        size_t lowest_available() const {
+            return std::min(m_lowest_available.load(std::memory_order_relaxed), m_read_ahead);
+        }
+
+
+        /// Set the underrun counters and lowest_available() back to their initial values.
+
+        void reset_underruns() {
+            m_underruns.store(0, std::memory_order_relaxed);
+            m_underrun_frames.store(0, std::memory_order_relaxed);
+            m_lowest_available.store(std::numeric_limits<size_t>::max(), std::memory_order_relaxed);
+        }
+
+    private:
+        // A read-only view of the contents of a file.
+        // The pages are read from the disk when they are first touched, which happens on the background thread.
+
+        class mapped_file {
+        public:
+            explicit mapped_file(const string& file_path) {
+                if (file_path.empty())
+                    return;
+#ifdef _WIN32
+                m_file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (m_file == INVALID_HANDLE_VALUE)
+                    return;
+
+                LARGE_INTEGER size;
+                if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+                    return;
+
+                m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!m_mapping)
+                    return;
+
+                m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (m_data)
+                    m_size = static_cast<size_t>(size.QuadPart);
+#else
+                const auto descriptor = ::open(file_path.c_str(), O_RDONLY);
+                if (descriptor < 0)
+                    return;
+
+                struct stat status;
+                if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+                    const auto size     = static_cast<size_t>(status.st_size);
+                    const auto address  = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+                    if (address != MAP_FAILED) {
+                        madvise(address, size, MADV_SEQUENTIAL);
+                        m_data = static_cast<const unsigned char*>(address);
+                        m_size = size;
+                    }
+                }
+                ::close(descriptor);    // the mapping keeps the file open
+#endif
+            }
+
+            mapped_file(const mapped_file& other) = delete;
+            mapped_file& operator=(const mapped_file& other) = delete;
+
+            ~mapped_file() {
+#ifdef _WIN32
+                if (m_data)
+                    UnmapViewOfFile(m_data);
+                if (m_mapping)
+                    CloseHandle(m_mapping);
+                if (m_file != INVALID_HANDLE_VALUE)
+                    CloseHandle(m_file);
+#else
+                if (m_data)
+                    munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+            }
+
+            const unsigned char* data() const {
+                return m_data;
+            }
+
+            size_t size() const {
+                return m_size;
+            }
+
+        private:
+            const unsigned char*    m_data { nullptr };
+            size_t                  m_size { 0 };
+#ifdef _WIN32
+            HANDLE                  m_file { INVALID_HANDLE_VALUE };
+            HANDLE                  m_mapping { nullptr };
+#endif
+        };
+
+
+        // An open file and the ring of frames decoded from it.
+        // The ring is filled by the background thread and read by the audio thread.
+        // Positions in the ring count frames from the time the file was opened and are masked to find the frame in the ring.
+
+        struct stream {
+            mapped_file             file;
+            stream_format           format;
+            const unsigned char*    samples { nullptr };    // the first sample in the file
+            size_t                  frame_count { 0 };
+            vector<float>           ring;                   // interleaved frames of format.channel_count samples
+            size_t                  mask { 0 };
+
+            // shared by the audio thread and the background thread
+
+            std::atomic<size_t>     read { 0 };                 // the position of the next frame to be read by the audio thread
+            std::atomic<size_t>     write { 0 };                // the position of the next frame to be decoded
+            std::atomic<size_t>     flush_position { 0 };       // the frames before this position are from before a seek
+            std::atomic<unsigned>   flush_generation { 0 };     // incremented for each seek
+            std::atomic<bool>       finished { true };          // the last frame of the file has been decoded
+
+            // used only by the audio thread
+
+            unsigned                seen_generation { 0 };
+            bool                    primed { false };           // frames have arrived since the file was opened or the last seek
+
+            // used only by the background thread
+
+            size_t                  file_position { 0 };        // the next frame of the file to decode
+            std::chrono::microseconds period { 20000 };         // how long to sleep while the ring is full
+
+
+            explicit stream(const string& file_path = {})
+            : file { file_path }
+            {}
+
+
+            // Find the samples and their format, from the header of a WAV file unless the format is given.
+
+            bool parse(const stream_format& a_format) {
+                const auto data = file.data();
+                const auto size = file.size();
+
+                if (!data)
+                    return false;
+
+                if (a_format.channel_count)
+                    return set_format(a_format, a_format.offset, size - std::min(size, a_format.offset));
+
+                if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0)
+                    return false;
+
+                const unsigned char* format_chunk = nullptr;
+                size_t               format_length = 0;
+
+                for (size_t position = 12; position + 8 <= size;) {
+                    const auto body     = data + position + 8;
+                    const auto length   = static_cast<size_t>(little_endian(data + position + 4, 4));
+
+                    if (std::memcmp(data + position, "fmt ", 4) == 0 && length >= 16 && position + 8 + length <= size) {
+                        format_chunk    = body;
+                        format_length   = length;
+                    }
+                    else if (std::memcmp(data + position, "data", 4) == 0 && format_chunk) {
+                        stream_format wav_format;
+
+                        auto tag                    = little_endian(format_chunk, 2);
+                        wav_format.channel_count    = static_cast<size_t>(little_endian(format_chunk + 2, 2));
+                        wav_format.samplerate       = static_cast<double>(little_endian(format_chunk + 4, 4));
+                        wav_format.bits             = static_cast<int>(little_endian(format_chunk + 14, 2));
+
+                        if (tag == 0xFFFE) {    // WAVE_FORMAT_EXTENSIBLE, the format is the start of the sub-format GUID
+                            if (format_length < 26)
+                                return false;
+                            tag = little_endian(format_chunk + 24, 2);
+                        }
+                        if (tag != 1 && tag != 3)
+                            return false;
+                        wav_format.floating_point = tag == 3;
+
+                        // recorders that are still writing may leave the length too long
+                        return set_format(wav_format, position + 8, std::min(length, size - position - 8));
+                    }
+                    position += 8 + length + (length & 1);
+                }
+                return false;
+            }
+
+            bool set_format(const stream_format& a_format, const size_t offset, const size_t length) {
+                const auto bits = a_format.bits;
+
+                if (a_format.channel_count == 0 || bits % 8 != 0 || (a_format.floating_point ? bits != 32 && bits != 64 : bits < 8 || bits > 32))
+                    return false;
+
+                format          = a_format;
+                samples         = file.data() + offset;
+                frame_count     = length / (format.channel_count * (bits / 8));
+                finished.store(false, std::memory_order_relaxed);
+                return true;
+            }
+
+
+            static uint64_t little_endian(const unsigned char* bytes, const int byte_count) {
+                uint64_t value = 0;
+                for (auto i = 0; i < byte_count; ++i)
+                    value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+                return value;
+            }
+
+
+            // Convert samples of the file to floats in the ring.
+
+            void decode(const size_t first_frame, float* destination, const size_t sample_count) const {
+                const auto bytes    = static_cast<size_t>(format.bits / 8);
+                const auto source   = samples + first_frame * format.channel_count * bytes;
+
+                if (format.floating_point && bytes == 4)
+                    std::memcpy(destination, source, sample_count * bytes);    // little-endian, as are the processors Max runs on
+                else if (format.floating_point) {
+                    for (size_t i = 0; i < sample_count; ++i) {
+                        double value;
+                        std::memcpy(&value, source + i * 8, 8);
+                        destination[i] = static_cast<float>(value);
+                    }
+                }
+                else if (bytes == 1) {
+                    for (size_t i = 0; i < sample_count; ++i)
+                        destination[i] = (static_cast<float>(source[i]) - 128.0f) * (1.0f / 128.0f);
+                }
+                else if (bytes == 2) {
+                    for (size_t i = 0; i < sample_count; ++i) {
+                        int16_t value;
+                        std::memcpy(&value, source + i * 2, 2);
+                        destination[i] = static_cast<float>(value) * (1.0f / 32768.0f);
+                    }
+                }
+                else {
+                    // 24 and 32 bits are shifted to the top of a 32-bit integer to extend the sign
+                    const auto scale = 1.0f / 2147483648.0f;
+                    for (size_t i = 0; i < sample_count; ++i) {
+                        const auto word = static_cast<uint32_t>(little_endian(source + i * bytes, static_cast<int>(bytes))) << (32 - 8 * bytes);
+                        destination[i] = static_cast<float>(static_cast<int32_t>(word)) * scale;
+                    }
+                }
+            }
+        };
+
+
+        // The number of frames decoded at a time, between which the background thread lets other threads open files.
+
+        static constexpr size_t k_chunk_frames = 4096;
+
+        object_base*                m_owner;
+        function                    m_notification_callback;
+        unique_ptr<message<>>       m_open_meth {};
+        const size_t                m_read_ahead;
+        std::atomic<size_t>         m_frame_count { 0 };
+        std::atomic<size_t>         m_channel_count { 0 };
+        std::atomic<double>         m_samplerate { 0.0 };
+        std::atomic<bool>           m_looping { false };
+        std::atomic<size_t>         m_seek_frame { 0 };
+        std::atomic<unsigned>       m_seek_requested { 0 };
+        std::atomic<unsigned>       m_seek_handled { 0 };
+
+        // used only by the audio thread
+
+        stream*                     m_active { nullptr };
+
+        // written by the audio thread, read by any
+
+        std::atomic<size_t>         m_underruns { 0 };
+        std::atomic<size_t>         m_underrun_frames { 0 };
+        std::atomic<size_t>         m_lowest_available { std::numeric_limits<size_t>::max() };
+
+        // shared by the audio thread and the background_thread
+
+        std::atomic<stream*>        m_published { nullptr };       // ready to be used by the audio thread
+        std::atomic<stream*>        m_released { nullptr };        // no longer used by the audio thread, to be freed
+
+        // used by the background_thread and, under the mutex, by the thread that opens files
+
+        std::mutex                  m_mutex;
+        stream*                     m_current { nullptr };         // the stream being filled, which is the newest
+        stream*                     m_decoding { nullptr };        // the stream being decoded into without the mutex
+        stream*                     m_discarded { nullptr };       // replaced while being decoded into, to be freed by the background_thread
+
+
+        // Make a stream the one that is filled and hand it to the audio thread.
+        // A stream that was published earlier but not yet taken by the audio thread is never used and is freed.
+
+        void replace(stream* a_stream) {
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+
+                m_current = a_stream;
+                m_seek_handled.store(m_seek_requested.load(std::memory_order_acquire), std::memory_order_release);
+
+                const auto previous = m_published.exchange(a_stream, std::memory_order_acq_rel);
+                if (previous && previous == m_decoding)
+                    m_discarded = previous;
+                else
+                    delete previous;
+            }
+            background_thread::shared().request();
+        }
+
+
+        // Take the newest stream on the audio thread.
+        // A new stream is only taken once the previous one has been freed, so there is never more than one to free.
+
+        void acquire() {
+            if (m_released.load(std::memory_order_acquire) == nullptr) {
+                if (auto next = m_published.exchange(nullptr, std::memory_order_acq_rel)) {
+                    m_released.store(m_active, std::memory_order_release);
+                    m_active = next;
+                    background_thread::shared().wake();
+                }
+            }
+        }
+
+
+        // After a seek, skip the frames that were decoded before it.
+        // Frames after the flush position may already have been read before the new generation was seen,
+        // so the read position only ever moves forward.
+
+        void skip_flushed(stream& s) {
+            const auto generation = s.flush_generation.load(std::memory_order_acquire);
+
+            if (generation != s.seen_generation) {
+                const auto read = s.read.load(std::memory_order_relaxed);
+
+                s.seen_generation = generation;
+                s.primed = false;
+                s.read.store(std::max(read, s.flush_position.load(std::memory_order_relaxed)), std::memory_order_release);
+            }
+        }
+
+
+        long read_frames(stream& s, sample* const* channels, const long channel_count, const long frame_count) {
+            skip_flushed(s);
+
+            const auto finished     = s.finished.load(std::memory_order_acquire);
+            const auto read         = s.read.load(std::memory_order_relaxed);
+            const auto available    = s.write.load(std::memory_order_acquire) - read;
+            const auto count        = static_cast<long>(std::min(available, static_cast<size_t>(frame_count)));
+            const auto stride       = s.format.channel_count;
+            const auto copied       = std::min(static_cast<size_t>(channel_count), stride);
+
+            for (size_t channel = 0; channel < copied; ++channel) {
+                for (auto i = 0; i < count; ++i)
+                    channels[channel][i] = s.ring[((read + i) & s.mask) * stride + channel];
+            }
+            for (auto channel = static_cast<long>(copied); channel < channel_count; ++channel)
+                std::fill(channels[channel], channels[channel] + count, 0.0);
+
+            s.read.store(read + count, std::memory_order_release);
+
+            // the silence while the ring is first filled is the latency of opening or seeking, not an underrun
+            s.primed |= available > 0;
+
+            if (s.primed && !finished) {
+                if (available < m_lowest_available.load(std::memory_order_relaxed))
+                    m_lowest_available.store(available, std::memory_order_relaxed);
+                if (count < frame_count) {
+                    m_underruns.fetch_add(1, std::memory_order_relaxed);
+                    m_underrun_frames.fetch_add(static_cast<size_t>(frame_count - count), std::memory_order_relaxed);
+                }
+            }
+            return count;
+        }
+
+
+        // Called on the background_thread to free the stream the audio thread has replaced and to decode a chunk.
+        // While there is room in the ring it asks to be called again at once, after any other clients of the thread,
+        // and otherwise after a fraction of the read-ahead, unless no file is open.
+
+        std::chrono::microseconds service() override {
+            std::unique_lock<std::mutex> lock { m_mutex };
+
+            delete m_released.exchange(nullptr, std::memory_order_acquire);
+
+            if (m_current && fill(*m_current, lock))
+                return std::chrono::microseconds { 1 };
+            if (m_current && m_current->frame_count > 0)
+                return m_current->period;
+            return {};
+        }
+
+
+        // Carry out any seek and decode a chunk of the file into the free part of the ring.
+        // The mutex is released while decoding, so that opening another file never waits for the disk.
+        // Return true if anything was decoded.
+
+        bool fill(stream& s, std::unique_lock<std::mutex>& lock) {
+            const auto requested = m_seek_requested.load(std::memory_order_acquire);
+
+            if (requested != m_seek_handled.load(std::memory_order_relaxed)) {
+                // a seek to or beyond the end finishes the stream unless it loops back to the start below
+                s.file_position = std::min(m_seek_frame.load(std::memory_order_relaxed), s.frame_count);
+                s.finished.store(s.frame_count == 0 || (s.file_position == s.frame_count && !m_looping.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+                s.flush_position.store(s.write.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                s.flush_generation.fetch_add(1, std::memory_order_release);
+                m_seek_handled.store(requested, std::memory_order_release);
+            }
+
+            if (s.file_position == s.frame_count && s.frame_count > 0 && m_looping.load(std::memory_order_relaxed)) {
+                s.file_position = 0;
+                s.finished.store(false, std::memory_order_relaxed);
+            }
+
+            const auto write    = s.write.load(std::memory_order_relaxed);
+            const auto space    = m_read_ahead - (write - s.read.load(std::memory_order_acquire));
+            const auto count    = std::min({ space, k_chunk_frames, s.frame_count - s.file_position });
+            const auto channels = s.format.channel_count;
+
+            if (count == 0)
+                return false;
+
+            // the free part of the ring may wrap around its end
+            const auto start    = write & s.mask;
+            const auto first    = std::min(count, m_read_ahead - start);
+
+            m_decoding = &s;
+            lock.unlock();
+
+            s.decode(s.file_position, s.ring.data() + start * channels, first * channels);
+            s.decode(s.file_position + first, s.ring.data(), (count - first) * channels);
+
+            s.file_position += count;
+            s.write.store(write + count, std::memory_order_release);
+            if (s.file_position == s.frame_count && !m_looping.load(std::memory_order_relaxed))
+                s.finished.store(true, std::memory_order_release);
+
+            lock.lock();
+            m_decoding = nullptr;
+            delete m_discarded;
+            m_discarded = nullptr;
+            return true;
+        }
+    };
+
+}    // namespace c74::min
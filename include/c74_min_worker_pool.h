@@ -0,0 +1,235 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A persistent pool of threads for splitting the work of a perform routine across cores.
+    ///
+    /// The calling thread publishes a job of N independent tasks and then works on the tasks itself together with the pool.
+    /// run() returns only once every task has finished, so the results are deterministic.
+    /// If the calling thread flushes denormals, e.g. for a class that declares #MIN_FLUSH_DENORMALS,
+    /// the worker threads flush them too while running the tasks of the job.
+    /// No locks are taken and no memory is allocated when running a job.
+    /// The calling thread never sleeps: it spins while waiting for tasks that have been claimed by another thread.
+    /// Idle worker threads spin, and then yield between checks for a job, for as long as jobs keep arriving,
+    /// i.e. while audio is running.
+    /// Only after no job has been published for k_idle_time do they block on a condition variable.
+    /// Publishing a job then notifies them, without taking a lock.
+    /// If the pool is already in use (e.g. by another audio thread) the tasks are run serially on the calling thread.
+
+    class worker_pool {
+    public:
+        /// The signature of a task: a context pointer and the index of the task in the job.
+
+        using task = void (*)(void* context, size_t index);
+
+
+        /// The largest number of tasks in a single job.
+
+        static constexpr size_t k_max_task_count = (1 << 20) - 1;
+
+
+        /// Create a pool.
+        /// @param	thread_count	The number of worker threads in addition to the calling thread.
+
+        explicit worker_pool(const size_t thread_count) {
+            for (size_t i = 0; i < thread_count; ++i)
+                m_threads.emplace_back([this]() { work(); });
+        }
+
+        worker_pool(const worker_pool& other) = delete;
+        worker_pool& operator=(const worker_pool& other) = delete;
+
+
+        /// Stop and join all worker threads.
+
+        ~worker_pool() {
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_quit = true;
+            }
+            m_wakeup.notify_all();
+            for (auto& thread : m_threads)
+                thread.join();
+        }
+
+
+        /// Get the pool shared by all objects of this external.
+        /// The pool is created on the first call, which should not be made from the audio thread.
+        /// It has one thread less than the number of cores, as the calling thread also works on the tasks.
+        /// The pool is not shared with other externals, which may have been built with a different version of this class.
+        /// @return	The shared pool.
+
+        static worker_pool& shared() {
+            // never freed, as the threads must not be joined while the external is being unloaded
+            static worker_pool* s_pool = new worker_pool { std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1 };
+            return *s_pool;
+        }
+
+
+        /// Return the number of worker threads.
+        /// @return	The number of threads, not counting the calling thread.
+
+        size_t thread_count() const {
+            return m_threads.size();
+        }
+
+
+        /// Run a job and wait for all of its tasks to finish.
+        /// @param	a_task			The function to call for each task.
+        /// @param	a_context		The context passed to each task.
+        /// @param	task_count		The number of tasks.
+
+        void run(const task a_task, void* a_context, const size_t task_count) {
+            if (task_count == 0)
+                return;
+
+            if (m_threads.empty() || task_count > k_max_task_count || m_busy.test_and_set(std::memory_order_acquire)) {
+                for (size_t i = 0; i < task_count; ++i)
+                    a_task(a_context, i);
+                return;
+            }
+
+            // The job is published by writing a new ticket, which encodes the job generation and number of tasks.
+            // Tasks are claimed by incrementing the index in the ticket, but only if the ticket still belongs to the same job,
+            // so threads that are late to notice a job can never claim tasks of another job.
+
+            m_task              = a_task;
+            m_context           = a_context;
+            m_flush_denormals   = denormal_guard::active();
+            m_done.store(0, std::memory_order_relaxed);
+            m_generation = (m_generation + 1) & k_generation_mask;
+            m_ticket.store(make_ticket(m_generation, task_count, 0));
+
+            // a worker that is about to block may miss this, in which case it sleeps for at most k_sleep_time
+            if (m_sleeping.load() > 0)
+                m_wakeup.notify_all();
+
+            claim_tasks(m_generation, task_count, false);
+            while (m_done.load(std::memory_order_acquire) < task_count)
+                pause();
+
+            m_busy.clear(std::memory_order_release);
+        }
+
+    private:
+        static constexpr int        k_index_bits        = 20;      // must hold k_max_task_count
+        static constexpr int        k_count_bits        = 20;
+        static constexpr uint64_t   k_index_mask        = (uint64_t(1) << k_index_bits) - 1;
+        static constexpr uint64_t   k_count_mask        = (uint64_t(1) << k_count_bits) - 1;
+        static constexpr uint64_t   k_generation_mask   = (uint64_t(1) << (64 - k_index_bits - k_count_bits)) - 1;
+        static constexpr int        k_spin_count        = 20000;    // iterations before an idle worker yields between checks
+        static constexpr auto       k_idle_time         = std::chrono::milliseconds(250);  // without a job before an idle worker blocks
+        static constexpr auto       k_sleep_time        = std::chrono::milliseconds(10);   // between checks of a blocked worker
+
+        vector<std::thread>     m_threads;
+        std::atomic<bool>       m_quit { false };
+        std::mutex              m_mutex;
+        std::condition_variable m_wakeup;
+        std::atomic<int>        m_sleeping { 0 };
+        std::atomic_flag        m_busy = ATOMIC_FLAG_INIT;
+        std::atomic<uint64_t>   m_ticket { 0 };
+        std::atomic<size_t>     m_done { 0 };
+        task                    m_task { nullptr };
+        void*                   m_context { nullptr };
+        bool                    m_flush_denormals { false };
+        uint64_t                m_generation { 0 };        // only accessed by the thread that holds m_busy
+
+
+        static uint64_t make_ticket(const uint64_t generation, const uint64_t count, const uint64_t index) {
+            return (generation << (k_index_bits + k_count_bits)) | (count << k_index_bits) | index;
+        }
+
+        static uint64_t ticket_generation(const uint64_t ticket) {
+            return ticket >> (k_index_bits + k_count_bits);
+        }
+
+        static size_t ticket_count(const uint64_t ticket) {
+            return static_cast<size_t>((ticket >> k_index_bits) & k_count_mask);
+        }
+
+        static size_t ticket_index(const uint64_t ticket) {
+            return static_cast<size_t>(ticket & k_index_mask);
+        }
+
+
+        // Hint to the processor that we are spinning.
+
+        static void pause() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+            _mm_pause();
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+
+        // Claim and run tasks of a job until none remain.
+        // A successful claim means the job is not yet finished, so its task and context are safe to read.
+        // A worker thread takes on the denormal mode of the thread that published the job.
+
+        void claim_tasks(const uint64_t generation, const size_t count, const bool worker) {
+            auto ticket = m_ticket.load(std::memory_order_acquire);
+
+            while (ticket_generation(ticket) == generation && ticket_index(ticket) < count) {
+                if (m_ticket.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    if (worker && m_flush_denormals) {
+                        denormal_guard guard;
+                        m_task(m_context, ticket_index(ticket));
+                    }
+                    else
+                        m_task(m_context, ticket_index(ticket));
+                    m_done.fetch_add(1, std::memory_order_release);
+                    ticket = m_ticket.load(std::memory_order_acquire);
+                }
+            }
+        }
+
+
+        // The loop of each worker thread.
+        // The audio thread never takes m_mutex, so a blocked worker also wakes by itself every k_sleep_time
+        // in case it missed the notification of a job published while it was going to sleep.
+
+        void work() {
+            uint64_t    last_generation = 0;
+            int         idle            = 0;
+            auto        last_job        = std::chrono::steady_clock::now();
+
+            while (!m_quit) {
+                const auto ticket       = m_ticket.load(std::memory_order_acquire);
+                const auto generation   = ticket_generation(ticket);
+                const auto count        = ticket_count(ticket);
+
+                if (generation != last_generation && ticket_index(ticket) < count) {
+                    last_generation = generation;
+                    idle            = 0;
+                    claim_tasks(generation, count, true);
+                }
+                else if (idle < k_spin_count) {
+                    if (++idle == k_spin_count)
+                        last_job = std::chrono::steady_clock::now();
+                    pause();
+                }
+                else if (std::chrono::steady_clock::now() - last_job < k_idle_time) {
+                    std::this_thread::yield();
+                }
+                else {
+                    std::unique_lock<std::mutex> lock { m_mutex };
+
+                    ++m_sleeping;
+                    m_wakeup.wait_for(lock, k_sleep_time, [this, last_generation]() {
+                        const auto ticket = m_ticket.load();
+                        return m_quit || (ticket_generation(ticket) != last_generation && ticket_index(ticket) < ticket_count(ticket));
+                    });
+                    --m_sleeping;
+                }
+            }
+        }
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,71 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_attribute_impl.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+// Write the value of the attribute to every sample, counting the parts of each vector that the performer processes.
+
+class audio_events_test_object : public object<audio_events_test_object>, public vector_operator<> {
+public:
+    inlet<>             input   { this, "(signal) Input" };
+    outlet<>            output  { this, "(signal) Output", "signal" };
+    attribute<number>   gain    { this, "gain", 0.0 };
+    audio_event_queue   events  { this };
+    int                 calls   { 0 };
+
+    void operator()(audio_bundle in, audio_bundle out) {
+        ++calls;
+        for (auto i = 0; i < out.frame_count(); ++i)
+            out.samples(0)[i] = gain;
+    }
+};
+
+
+TEST_CASE( "audio events are applied at the scheduled sample", "[audio_events]" ) {
+    render_harness<audio_events_test_object>    harness { 48000.0, 16 };
+    render_capture                              output;
+    auto&                                       my_object = harness.object();
+
+    REQUIRE( my_object.event_queue() == &my_object.events );
+
+    SECTION( "events split the vector in time order" ) {
+        REQUIRE( my_object.events.post(my_object.gain, 2.0, 5) );
+        REQUIRE( my_object.events.post(my_object.gain, 1.0, 3) );
+
+        harness.render(output, 16);
+        REQUIRE( my_object.calls == 3 );
+        REQUIRE( output.samples(0)[2] == 0.0 );
+        REQUIRE( output.samples(0)[3] == 1.0 );
+        REQUIRE( output.samples(0)[4] == 1.0 );
+        REQUIRE( output.samples(0)[5] == 2.0 );
+        REQUIRE( output.samples(0)[15] == 2.0 );
+        REQUIRE( my_object.events.sample_time() == 16 );
+    }
+
+    SECTION( "events scheduled beyond the vector wait for a later vector" ) {
+        REQUIRE( my_object.events.post_at(20, my_object.gain, 3.0) );
+
+        harness.render(output, 32);
+        REQUIRE( my_object.calls == 3 );
+        REQUIRE( output.samples(0)[15] == 0.0 );
+        REQUIRE( output.samples(0)[19] == 0.0 );
+        REQUIRE( output.samples(0)[20] == 3.0 );
+    }
+
+    SECTION( "events scheduled in the past are applied at the start of the next vector" ) {
+        harness.render(output, 16);
+        REQUIRE( my_object.events.post_at(2, my_object.gain, 4.0) );
+
+        harness.render(output, 16);
+        REQUIRE( my_object.calls == 2 );
+        REQUIRE( output.samples(0)[15] == 0.0 );
+        REQUIRE( output.samples(0)[16] == 4.0 );
+    }
+}
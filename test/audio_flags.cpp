@@ -0,0 +1,85 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+// Record whether the perform routine was given the same memory for input and output.
+
+template<class min_class_type>
+class aliasing_test_object : public object<min_class_type>, public vector_operator<> {
+public:
+    inlet<>     input   { this, "(signal) Input" };
+    outlet<>    output  { this, "(signal) Output", "signal" };
+
+    bool        aliased { false };
+
+    void operator()(audio_bundle in, audio_bundle out) {
+        aliased = in.samples(0) == out.samples(0);
+        for (auto i = 0; i < in.frame_count(); ++i)
+            out.samples(0)[i] = in.samples(0)[i] * 2.0;
+    }
+};
+
+
+class inplace_test_object : public aliasing_test_object<inplace_test_object> {
+public:
+    MIN_FLAGS { audio_flags::inplace };
+};
+
+
+class separate_test_object : public aliasing_test_object<separate_test_object> {};
+
+
+class inplace_sample_object : public object<inplace_sample_object>, public sample_operator<2, 2> {
+public:
+    MIN_FLAGS { audio_flags::inplace };
+
+    inlet<>     left_in     { this, "(signal) Left" };
+    inlet<>     right_in    { this, "(signal) Right" };
+    outlet<>    left_out    { this, "(signal) Left", "signal" };
+    outlet<>    right_out   { this, "(signal) Right", "signal" };
+
+    samples<2> operator()(sample left, sample right) {
+        return { { right, left } };
+    }
+};
+
+
+TEST_CASE( "audio_flags::inplace lets inputs and outputs share memory", "[audio_flags]" ) {
+    signal_generator    ramp { 2, [](long channel, long long frame) { return channel == 0 ? static_cast<sample>(frame) : -1.0; }, 128 };
+    render_capture      output;
+
+    SECTION( "an in-place object is given the same vectors for input and output" ) {
+        render_harness<inplace_test_object> harness { 48000.0, 64 };
+        signal_generator                    mono { 1, [](long, long long frame) { return static_cast<sample>(frame); }, 128 };
+
+        harness.render(mono, output);
+        REQUIRE( harness.object().aliased );
+        REQUIRE( output.samples(0)[127] == 254.0 );
+    }
+
+    SECTION( "other objects are given separate vectors" ) {
+        render_harness<separate_test_object>    harness { 48000.0, 64 };
+        signal_generator                        mono { 1, [](long, long long frame) { return static_cast<sample>(frame); }, 128 };
+
+        harness.render(mono, output);
+        REQUIRE( !harness.object().aliased );
+        REQUIRE( output.samples(0)[127] == 254.0 );
+    }
+
+    SECTION( "a sample_operator reads every input of a frame before writing its outputs" ) {
+        render_harness<inplace_sample_object> harness { 48000.0, 64 };
+
+        harness.render(ramp, output);
+        for (auto i = 0; i < 128; ++i) {
+            REQUIRE( output.samples(0)[i] == -1.0 );
+            REQUIRE( output.samples(1)[i] == i );
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+namespace {
+
+    // Counts the calls to service() and asks to be called again a number of times.
+
+    class background_thread_test_client : public background_thread::client {
+    public:
+        std::atomic<int>    calls { 0 };
+        std::atomic<int>    repeats { 0 };
+        std::atomic<bool>   busy { false };
+        std::atomic<int>    busy_ms { 0 };
+
+        std::chrono::microseconds service() override {
+            busy = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(busy_ms.load()));
+            calls++;
+            busy = false;
+
+            if (repeats > 0) {
+                repeats--;
+                return std::chrono::microseconds { 1000 };
+            }
+            return {};
+        }
+    };
+
+
+    // Wait, but not forever, until a client has been called a number of times.
+
+    bool wait_for_calls(const background_thread_test_client& a_client, const int count) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+        while (a_client.calls < count && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return a_client.calls >= count;
+    }
+}
+
+
+TEST_CASE( "background_thread serves its clients", "[background_thread]" ) {
+    auto&                           thread = background_thread::shared();
+    background_thread_test_client   client;
+
+    REQUIRE( &background_thread::shared() == &thread );
+
+    thread.add(&client);
+    REQUIRE( wait_for_calls(client, 1) );
+
+    SECTION( "when a client requests it" ) {
+        thread.request();
+        REQUIRE( wait_for_calls(client, 2) );
+    }
+
+    SECTION( "when the audio thread wakes it" ) {
+        thread.wake();
+        REQUIRE( wait_for_calls(client, 2) );
+    }
+
+    SECTION( "after the delay returned by the client, until it returns zero" ) {
+        client.repeats = 3;
+        thread.request();
+        REQUIRE( wait_for_calls(client, 5) );
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE( client.calls == 5 );
+    }
+
+    SECTION( "and removing a client waits until it has been served" ) {
+        client.busy_ms = 100;
+        thread.request();
+
+        while (!client.busy)
+            std::this_thread::yield();
+        thread.remove(&client);
+        REQUIRE( !client.busy );
+        REQUIRE( client.calls == 2 );
+    }
+
+    thread.remove(&client);
+}
@@ -0,0 +1,300 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_buffer_impl.h"
+
+using namespace c74::min;
+
+
+// The mock kernel has no buffer~ objects, so the parts of the buffer~ API used by buffer_lock<> are provided here.
+// Every buffer reference is bound to whichever of these stand-ins is current, as though "set" had been sent to it.
+
+struct test_buffer {
+    vector<float>   samples;
+    long            channel_count;
+    double          samplerate;
+};
+
+static test_buffer* g_bound_buffer { nullptr };
+
+namespace c74::max {
+
+    t_buffer_obj* buffer_ref_getobject(t_buffer_ref*) {
+        return reinterpret_cast<t_buffer_obj*>(g_bound_buffer);
+    }
+
+    float* buffer_locksamples(t_buffer_obj* buffer_object) {
+        return buffer_object ? reinterpret_cast<test_buffer*>(buffer_object)->samples.data() : nullptr;
+    }
+
+    void buffer_unlocksamples(t_buffer_obj*) {}
+    void buffer_edit_begin(t_buffer_obj*) {}
+    void buffer_edit_end(t_buffer_obj*, long) {}
+
+    t_max_err buffer_getinfo(t_buffer_obj* buffer_object, t_buffer_info* info) {
+        const auto b = reinterpret_cast<test_buffer*>(buffer_object);
+
+        *info           = t_buffer_info {};
+        info->b_samples = b->samples.data();
+        info->b_nchans  = b->channel_count;
+        info->b_frames  = static_cast<long>(b->samples.size()) / b->channel_count;
+        info->b_size    = static_cast<long>(b->samples.size());
+        info->b_sr      = static_cast<float>(b->samplerate);
+        return 0;
+    }
+
+}    // namespace c74::max
+
+
+class buffer_test_object : public object<buffer_test_object> {};
+
+
+TEST_CASE( "buffer_channel views one channel of interleaved samples", "[buffer]" ) {
+    // three frames of two channels, as stored by a buffer~
+    float           samples[]   = { 0.0f, 10.0f, 1.0f, 11.0f, 2.0f, 12.0f };
+    buffer_channel  right       { samples + 1, 2, 3 };
+
+    REQUIRE( right.size() == 3 );
+    REQUIRE( right.stride() == 2 );
+    REQUIRE( right.data() == samples + 1 );
+    REQUIRE( right[0] == 10.0f );
+    REQUIRE( right[2] == 12.0f );
+
+    SECTION( "at() limits the frame to the last frame" ) {
+        REQUIRE( right.at(1) == 11.0f );
+        REQUIRE( right.at(100) == 12.0f );
+    }
+
+    SECTION( "samples are written through the view" ) {
+        right[1] = -1.0f;
+        REQUIRE( samples[3] == -1.0f );
+        REQUIRE( samples[2] == 1.0f );
+    }
+}
+
+
+TEST_CASE( "buffer_reader interpolates between frames", "[buffer]" ) {
+    // a ramp in the second of two channels, in which each sample is ten more than its frame
+    float           samples[16];
+    buffer_channel  ramp { samples + 1, 2, 8 };
+
+    for (auto i = 0; i < 8; ++i) {
+        samples[i * 2]  = -1.0f;
+        ramp[i]         = 10.0f + i;
+    }
+
+    SECTION( "interpolation" ) {
+        REQUIRE( buffer_reader(ramp, buffer_interpolation::none).read(2.75) == 12.0 );
+        REQUIRE( buffer_reader(ramp, buffer_interpolation::linear).read(2.75) == Approx(12.75).margin(1e-9) );
+        REQUIRE( buffer_reader(ramp, buffer_interpolation::cubic).read(2.75) == Approx(12.75).margin(1e-9) );
+        REQUIRE( buffer_reader(ramp, buffer_interpolation::linear).read(5.0) == 15.0 );
+    }
+
+    SECTION( "edges" ) {
+        buffer_reader clamped   { ramp, buffer_interpolation::linear, buffer_edge::clamp };
+        buffer_reader wrapped   { ramp, buffer_interpolation::linear, buffer_edge::wrap };
+        buffer_reader folded    { ramp, buffer_interpolation::none, buffer_edge::fold };
+
+        REQUIRE( clamped.read(-3.0) == 10.0 );
+        REQUIRE( clamped.read(100.0) == 17.0 );
+        REQUIRE( wrapped.read(7.5) == Approx(13.5).margin(1e-9) );     // halfway between the last frame and the first
+        REQUIRE( wrapped.read(-0.5) == Approx(13.5).margin(1e-9) );
+        REQUIRE( wrapped.read(19.0) == Approx(13.0).margin(1e-9) );
+        REQUIRE( folded.read(-2.0) == 12.0 );
+        REQUIRE( folded.read(9.0) == 15.0 );
+    }
+
+    SECTION( "a vector matches single samples" ) {
+        sample positions[11];
+        sample output[11];
+
+        // positions across both edges, and then all far enough inside to be read without edge handling
+        for (auto step : { 1.1, 0.3 }) {
+            for (auto i = 0; i < 11; ++i)
+                positions[i] = step > 1.0 ? -2.3 + i * step : 1.2 + i * step;
+
+            for (auto interpolation : { buffer_interpolation::none, buffer_interpolation::linear, buffer_interpolation::cubic, buffer_interpolation::sinc }) {
+                for (auto edge : { buffer_edge::clamp, buffer_edge::wrap, buffer_edge::fold }) {
+                    buffer_reader reader { ramp, interpolation, edge };
+
+                    reader.read(output, positions, 11);
+                    for (auto i = 0; i < 11; ++i)
+                        REQUIRE( output[i] == Approx(reader.read(positions[i])).margin(1e-9) );
+                }
+            }
+        }
+    }
+
+    SECTION( "an empty channel reads silence" ) {
+        buffer_reader   empty { buffer_channel { nullptr, 1, 0 } };
+        sample          output[3] = { 1.0, 1.0, 1.0 };
+
+        REQUIRE( empty.read(1.5) == 0.0 );
+        empty.read(output, output, 3);
+        REQUIRE( output[2] == 0.0 );
+    }
+}
+
+
+TEST_CASE( "buffer_reader with sinc interpolation reconstructs a sine wave", "[buffer]" ) {
+    vector<float>   samples(256);
+    buffer_channel  sine { samples.data(), 1, samples.size() };
+    buffer_reader   reader { sine, buffer_interpolation::sinc };
+    buffer_reader   linear { sine, buffer_interpolation::linear };
+    double          error = 0.0;
+    double          linear_error = 0.0;
+
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = static_cast<float>(std::sin(0.3 * i));
+
+    // away from the edges, where the filter overlaps the repeated first or last frame
+    for (auto position = 32.0; position < 224.0; position += 0.37) {
+        error           = std::max(error, std::abs(reader.read(position) - std::sin(0.3 * position)));
+        linear_error    = std::max(linear_error, std::abs(linear.read(position) - std::sin(0.3 * position)));
+    }
+
+    REQUIRE( error < 1e-3 );
+    REQUIRE( error * 10.0 < linear_error );
+}
+
+
+TEST_CASE( "buffer_lock reads the properties of the buffer~ it is bound to", "[buffer]" ) {
+    buffer_test_object  my_object;
+    buffer_reference    my_buffer { &my_object, nullptr, false };
+    test_buffer         stereo { { 0.0f, 10.0f, 1.0f, 11.0f, 2.0f, 12.0f }, 2, 44100.0 };
+    test_buffer         mono { { 5.0f, 6.0f, 7.0f, 8.0f }, 1, 48000.0 };
+
+    g_bound_buffer = &stereo;
+    {
+        buffer_lock<> b { my_buffer };
+
+        REQUIRE( b.valid() );
+        REQUIRE( b.frame_count() == 3 );
+        REQUIRE( b.channel_count() == 2 );
+        REQUIRE( b.samplerate() == 44100.0 );
+        REQUIRE( b.lookup(2, 1) == 12.0f );
+    }
+
+    SECTION( "a lock after rebinding reads the new buffer~" ) {
+        g_bound_buffer = &mono;
+
+        buffer_lock<false> b { my_buffer };
+
+        REQUIRE( b.frame_count() == 4 );
+        REQUIRE( b.channel_count() == 1 );
+        REQUIRE( b.samplerate() == 48000.0 );
+        REQUIRE( b.lookup(100) == 8.0f );
+    }
+
+    SECTION( "a lock after the buffer~ changes size reads the new size" ) {
+        stereo.samples.assign(10, 1.0f);
+        stereo.channel_count = 5;
+
+        buffer_lock<> b { my_buffer };
+
+        REQUIRE( b.frame_count() == 2 );
+        REQUIRE( b.channel_count() == 5 );
+        REQUIRE( b.data() == stereo.samples.data() );
+    }
+
+    g_bound_buffer = nullptr;
+}
+
+
+TEST_CASE( "buffer_lock copies frames to and from a vector for each channel", "[buffer]" ) {
+    buffer_test_object  my_object;
+    buffer_reference    my_buffer { &my_object, nullptr, false };
+
+    // each sample is its frame plus a tenth of its channel, with whole blocks of four frames and a remainder
+    for (auto channel_count : { 1, 2, 3, 4, 8 }) {
+        test_buffer     frames { vector<float>(11 * channel_count), channel_count, 44100.0 };
+        sample_vector   storage(11 * channel_count, -1.0);
+        vector<sample*> channels;
+
+        for (auto channel = 0; channel < channel_count; ++channel)
+            channels.push_back(storage.data() + channel * 11);
+        for (size_t i = 0; i < frames.samples.size(); ++i)
+            frames.samples[i] = static_cast<float>(i / channel_count) + 0.1f * (i % channel_count);
+
+        g_bound_buffer = &frames;
+
+        {
+            buffer_lock<> b { my_buffer };
+
+            // the range is limited to the end of the buffer~
+            REQUIRE( b.deinterleave(channels.data(), 2, 100) == 9 );
+            for (auto channel = 0; channel < channel_count; ++channel) {
+                for (auto i = 0; i < 9; ++i)
+                    REQUIRE( channels[channel][i] == Approx(2 + i + 0.1 * channel).margin(1e-5) );
+                REQUIRE( channels[channel][9] == -1.0 );
+            }
+            REQUIRE( b.deinterleave(channels.data(), 11, 4) == 0 );
+        }
+
+        {
+            buffer_lock<false> b { my_buffer };
+
+            for (auto channel = 0; channel < channel_count; ++channel) {
+                for (auto i = 0; i < 11; ++i)
+                    channels[channel][i] = -i - 0.25 * channel;
+            }
+
+            REQUIRE( b.interleave(channels.data(), 1, 9) == 9 );
+            for (auto channel = 0; channel < channel_count; ++channel) {
+                REQUIRE( b.lookup(0, channel) == Approx(0.1 * channel).margin(1e-5) );
+                for (auto i = 1; i < 10; ++i)
+                    REQUIRE( b.lookup(i, channel) == Approx(-(i - 1) - 0.25 * channel).margin(1e-5) );
+                REQUIRE( b.lookup(10, channel) == Approx(10 + 0.1 * channel).margin(1e-5) );
+            }
+        }
+
+        g_bound_buffer = nullptr;
+    }
+}
+
+
+// Benchmarks are hidden and only run when requested, e.g. `min-tests [benchmark]`
+
+TEST_CASE( "buffer_reader cost", "[.][benchmark]" ) {
+    const long      frame_count = 64;
+    vector<float>   samples(4096);
+    buffer_channel  channel { samples.data(), 1, samples.size() };
+    sample          positions[frame_count];
+    sample          output[frame_count];
+
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = static_cast<float>(std::sin(0.01 * i));
+    for (auto i = 0; i < frame_count; ++i)
+        positions[i] = 1000.0 + i * 1.37;
+
+    buffer_reader   linear { channel, buffer_interpolation::linear };
+    buffer_reader   cubic { channel, buffer_interpolation::cubic };
+    buffer_reader   sinc { channel, buffer_interpolation::sinc };
+
+    BENCHMARK( "buffer_reader: linear interpolation, 64 samples" ) {
+        linear.read(output, positions, frame_count);
+        return output[0];
+    };
+
+    BENCHMARK( "buffer_reader: cubic interpolation, 64 samples" ) {
+        cubic.read(output, positions, frame_count);
+        return output[0];
+    };
+
+    BENCHMARK( "buffer_reader: sinc interpolation, 64 samples" ) {
+        sinc.read(output, positions, frame_count);
+        return output[0];
+    };
+
+    BENCHMARK( "buffer_channel: linear interpolation by hand, 64 samples" ) {
+        for (auto i = 0; i < frame_count; ++i) {
+            const auto whole    = static_cast<size_t>(positions[i]);
+            const auto fraction = positions[i] - whole;
+            output[i] = channel.at(whole) + (channel.at(whole + 1) - channel.at(whole)) * fraction;
+        }
+        return output[0];
+    };
+}
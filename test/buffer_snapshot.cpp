@@ -0,0 +1,102 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_buffer_impl.h"
+
+using namespace c74::min;
+
+
+// Acquire copies, as the audio thread does at the start of each vector, until one with the expected length arrives.
+
+static const buffer_snapshot::contents& acquire_frames(buffer_snapshot& a_snapshot, const size_t frame_count) {
+    while (a_snapshot.updating() || a_snapshot.acquire().frame_count() != frame_count)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return a_snapshot.acquire();
+}
+
+
+TEST_CASE( "buffer_snapshot hands copies to the audio thread", "[buffer_snapshot]" ) {
+    buffer_snapshot snapshot;
+    sample          output[2] = { 1.0, 1.0 };
+    sample          positions[2] = { 0.5, 1.5 };
+
+    REQUIRE( !snapshot.acquire().valid() );
+    REQUIRE( snapshot.acquire().data() == nullptr );
+    snapshot.acquire().reader(0).read(output, positions, 2);
+    REQUIRE( output[1] == 0.0 );
+
+    // three frames of two channels
+    const float first[] = { 0.0f, 10.0f, 1.0f, 11.0f, 2.0f, 12.0f };
+    snapshot.update(first, 3, 2, 44100.0);
+
+    const auto& contents = acquire_frames(snapshot, 3);
+
+    REQUIRE( contents.valid() );
+    REQUIRE( contents.channel_count() == 2 );
+    REQUIRE( contents.samplerate() == 44100.0 );
+    REQUIRE( contents.lookup(1, 1) == 11.0f );
+    REQUIRE( contents.lookup(100, 0) == 2.0f );
+    REQUIRE( contents.data()[4] == 2.0f );
+    REQUIRE( contents.reader(1).read(0.5) == Approx(10.5).margin(1e-9) );
+
+    SECTION( "a copy is unchanged until the next acquire" ) {
+        const float second[] = { 5.0f, 6.0f, 7.0f, 8.0f };
+        snapshot.update(second, 4);
+        while (snapshot.updating())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        REQUIRE( contents.frame_count() == 3 );
+        REQUIRE( contents.lookup(2, 1) == 12.0f );
+
+        const auto& next = acquire_frames(snapshot, 4);
+        REQUIRE( next.channel_count() == 1 );
+        REQUIRE( next.lookup(3) == 8.0f );
+    }
+
+    SECTION( "an empty update makes the copy empty" ) {
+        snapshot.update(nullptr, 0);
+        REQUIRE( !acquire_frames(snapshot, 0).valid() );
+    }
+}
+
+
+TEST_CASE( "buffer_snapshot copies are never torn", "[buffer_snapshot]" ) {
+    buffer_snapshot snapshot;
+    const auto      generations = 200;
+
+    // each generation is filled with its own number and has its own length
+    std::thread writer { [&snapshot]() {
+        for (auto generation = 1; generation <= generations; ++generation) {
+            vector<float> samples(1000 + generation, static_cast<float>(generation));
+            snapshot.update(samples.data(), samples.size());
+            std::this_thread::yield();
+        }
+    }};
+
+    auto latest     = 0;
+    auto torn       = 0;
+
+    while (latest < generations) {
+        const auto& contents = snapshot.acquire();
+
+        if (contents.valid()) {
+            const auto generation = static_cast<int>(contents.lookup(0));
+
+            if (contents.frame_count() != static_cast<size_t>(1000 + generation))
+                ++torn;
+            for (size_t i = 0; i < contents.frame_count(); ++i) {
+                if (contents.lookup(i) != static_cast<float>(generation))
+                    ++torn;
+            }
+            REQUIRE( generation >= latest );
+            latest = generation;
+        }
+        std::this_thread::yield();
+    }
+    writer.join();
+
+    REQUIRE( torn == 0 );
+}
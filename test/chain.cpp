@@ -0,0 +1,81 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_attribute_impl.h"
+
+using namespace c74::min;
+
+
+class chain_gain_test_object : public object<chain_gain_test_object>, public sample_operator<1, 1> {
+public:
+    attribute<number> gain { this, "gain", 2.0 };
+
+    sample operator()(sample x) {
+        return x * gain;
+    }
+};
+
+
+class chain_offset_test_object : public object<chain_offset_test_object>, public sample_operator<1, 1> {
+public:
+    attribute<number> offset { this, "offset", 1.0 };
+
+    message<> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            m_dspsetup_samplerate = args[0];
+            return {};
+        }
+    };
+
+    sample operator()(sample x) {
+        return x + offset;
+    }
+
+    double m_dspsetup_samplerate { 0.0 };
+};
+
+
+class chain_test_object : public object<chain_test_object>, public sample_operator<1, 1> {
+public:
+    chain<chain_gain_test_object, chain_offset_test_object> m_chain { this, { "pre", "" } };
+
+    sample operator()(sample x) {
+        return m_chain(x);
+    }
+};
+
+
+TEST_CASE( "chain of sample operators", "[chain]" ) {
+    chain_test_object my_object;
+
+    SECTION( "samples pass through the operators in order" ) {
+        REQUIRE( my_object(3.0) == Approx(7.0) );
+    }
+
+    SECTION( "attributes of the operators are exposed with their prefixes" ) {
+        auto& attrs = my_object.attributes();
+
+        REQUIRE( attrs.size() == 2 );
+        REQUIRE( attrs.count("pre_gain") == 1 );
+        REQUIRE( attrs.count("offset") == 1 );
+
+        attrs["pre_gain"]->set({ 0.5 });
+        REQUIRE( double(my_object.m_chain.get<0>().gain) == Approx(0.5) );
+        REQUIRE( my_object(3.0) == Approx(2.5) );
+
+        atoms value = *attrs["offset"];
+        REQUIRE( value.size() == 1 );
+        REQUIRE( double(value[0]) == Approx(1.0) );
+    }
+
+    SECTION( "dspsetup is passed on to the operators" ) {
+        my_object.m_chain.dspsetup(96000.0, 32);
+
+        REQUIRE( my_object.m_chain.get<0>().samplerate() == 96000.0 );
+        REQUIRE( my_object.m_chain.get<1>().vector_size() == 32 );
+        REQUIRE( my_object.m_chain.get<1>().m_dspsetup_samplerate == 96000.0 );
+    }
+}
@@ -0,0 +1,165 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+// A repeatable signal without any structure.
+
+static sample_vector convolver_test_signal(const size_t frame_count, const unsigned seed) {
+    sample_vector   signal(frame_count);
+    auto            state = seed;
+
+    for (auto& x : signal) {
+        state   = state * 1664525 + 1013904223;
+        x       = static_cast<int>(state >> 8) / double(1 << 23) - 1.0;
+    }
+    return signal;
+}
+
+
+static sample_vector direct_convolution(const sample_vector& input, const sample_vector& impulse_response) {
+    sample_vector output(input.size(), 0.0);
+
+    for (size_t n = 0; n < input.size(); ++n) {
+        for (size_t k = 0; k < impulse_response.size() && k <= n; ++k)
+            output[n] += impulse_response[k] * input[n - k];
+    }
+    return output;
+}
+
+
+static void wait_for_impulse_response(const convolver& a_convolver) {
+    while (a_convolver.loading())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+
+TEST_CASE( "convolver matches direct convolution", "[convolver]" ) {
+    const auto input = convolver_test_signal(2000, 1);
+
+    for (size_t partition_size : { 2, 64 }) {
+        for (size_t length : { 1, 100, 777 }) {
+            for (long vector_size : { 1, 64, 100 }) {
+                INFO( "partition size " << partition_size << ", length " << length << ", vector size " << vector_size );
+
+                convolver       my_convolver { partition_size };
+                const auto      impulse_response    = convolver_test_signal(length, 2);
+                const auto      expected            = direct_convolution(input, impulse_response);
+                sample_vector   silence(partition_size, 0.0);
+                sample_vector   output(input.size());
+
+                REQUIRE( my_convolver.latency() == static_cast<long>(partition_size) );
+
+                my_convolver.load(impulse_response.data(), impulse_response.size());
+                wait_for_impulse_response(my_convolver);
+
+                // the first partition fades in the new impulse response
+                my_convolver.process(silence.data(), silence.data(), static_cast<long>(partition_size));
+
+                for (long start = 0; start < static_cast<long>(input.size()); start += vector_size) {
+                    const auto count = std::min(vector_size, static_cast<long>(input.size()) - start);
+                    my_convolver.process(input.data() + start, output.data() + start, count);
+                }
+
+                for (size_t i = 0; i < output.size(); ++i)
+                    REQUIRE( output[i] == Approx(i < partition_size ? 0.0 : expected[i - partition_size]).margin(1e-9) );
+            }
+        }
+    }
+}
+
+
+TEST_CASE( "convolver changes impulse responses while processing", "[convolver]" ) {
+    const auto      input       = convolver_test_signal(6000, 3);
+    const auto      short_ir    = convolver_test_signal(50, 4);
+    const auto      long_ir     = convolver_test_signal(1000, 5);
+    const long      block_size  = 32;
+    sample_vector   output      = input;
+    long            position    = 0;
+
+    convolver my_convolver { block_size };
+
+    // in-place processing, as when Max uses the same vector for input and output
+    auto process = [&](const long frame_count) {
+        for (auto end = position + frame_count; position < end; position += block_size)
+            my_convolver.process(output.data() + position, output.data() + position, std::min(block_size, end - position));
+    };
+
+    my_convolver.load(short_ir.data(), short_ir.size());
+    wait_for_impulse_response(my_convolver);
+    process(1024);
+
+    // the shorter impulse response kept only the spectra of the most recent input, so compare once the rest have been filled in
+    my_convolver.load(long_ir.data(), long_ir.size());
+    wait_for_impulse_response(my_convolver);
+    process(2048);
+
+    my_convolver.load(short_ir.data(), short_ir.size());
+    wait_for_impulse_response(my_convolver);
+    process(6000 - position);
+
+    const auto with_long    = direct_convolution(input, long_ir);
+    const auto with_short   = direct_convolution(input, short_ir);
+
+    for (auto i = 1024 + 1000 + 2 * block_size; i < 1024 + 2048; ++i)
+        REQUIRE( output[i] == Approx(with_long[i - block_size]).margin(1e-9) );
+    for (auto i = 1024 + 2048 + 2 * block_size; i < 6000; ++i)
+        REQUIRE( output[i] == Approx(with_short[i - block_size]).margin(1e-9) );
+}
+
+
+TEST_CASE( "convolver keeps the earlier input when a longer impulse response is loaded", "[convolver]" ) {
+    const auto      short_ir    = convolver_test_signal(50, 8);
+    const auto      long_ir     = convolver_test_signal(1000, 9);
+    const long      block_size  = 32;
+    auto            input       = convolver_test_signal(3000, 10);
+    sample_vector   output(input.size());
+    long            position    = 0;
+
+    // nothing before the last block processed with the short impulse response,
+    // so that its delay line of two spectra holds all of the input the long impulse response needs
+    std::fill(input.begin(), input.begin() + 1000, 0.0);
+
+    convolver my_convolver { block_size };
+
+    auto process = [&](const long frame_count) {
+        for (auto end = position + frame_count; position < end; position += block_size)
+            my_convolver.process(input.data() + position, output.data() + position, std::min(block_size, end - position));
+    };
+
+    my_convolver.load(short_ir.data(), short_ir.size());
+    wait_for_impulse_response(my_convolver);
+    process(1024);
+
+    my_convolver.load(long_ir.data(), long_ir.size());
+    wait_for_impulse_response(my_convolver);
+    process(3000 - position);
+
+    // the block after the load crossfades, after which the output is the complete convolution with the long impulse response
+    const auto with_long = direct_convolution(input, long_ir);
+
+    for (auto i = 1024 + 2 * block_size; i < 3000; ++i)
+        REQUIRE( output[i] == Approx(with_long[i - block_size]).margin(1e-9) );
+}
+
+
+// Benchmarks are hidden and only run when requested, e.g. `min-tests [benchmark]`
+
+TEST_CASE( "convolver cost", "[.][benchmark]" ) {
+    const auto      impulse_response    = convolver_test_signal(480000, 6);    // 10 seconds at 48 kHz
+    auto            signal              = convolver_test_signal(256, 7);
+    convolver       reverb { 256 };
+
+    reverb.load(impulse_response.data(), impulse_response.size());
+    wait_for_impulse_response(reverb);
+
+    BENCHMARK( "convolver: 10 second impulse response, 256 samples" ) {
+        reverb.process(signal.data(), signal.data(), 256);
+        return signal[0];
+    };
+}
@@ -0,0 +1,133 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "delay_line size", "[delay_line]" ) {
+    delay_line<> in_samples { 100 };
+    delay_line<> in_time    { time_value { 10.0 } };
+
+    in_samples.dspsetup(48000.0, 64);
+    in_time.dspsetup(48000.0, 64);
+
+    REQUIRE( in_samples.max_delay() == 100 );
+    REQUIRE( in_samples.size() == 256 );
+    REQUIRE( in_time.max_delay() == 480 );
+    REQUIRE( in_time.size() == 1024 );
+}
+
+
+TEST_CASE( "delay_line whole delays", "[delay_line]" ) {
+    delay_line<float>   delay { 20 };
+    float               input[8];
+    float               output[8];
+
+    delay.dspsetup(48000.0, 8);
+
+    // enough vectors to wrap around the buffer
+    for (auto vector = 0; vector < 10; ++vector) {
+        for (auto i = 0; i < 8; ++i)
+            input[i] = static_cast<float>(vector * 8 + i);
+        delay.write(input, 8);
+        delay.read(output, 5, 8);
+
+        for (auto i = 0; i < 8; ++i)
+            REQUIRE( output[i] == std::max(0.0f, input[i] - 5) );
+    }
+
+    REQUIRE( delay.read(0) == 79.0f );
+    REQUIRE( delay.read(20) == 59.0f );
+    REQUIRE( delay.read(2.25, delay_interpolation::linear) == Approx(76.75).margin(1e-9) );
+}
+
+
+// Write a polynomial in time and read it back with a delay that changes for every sample.
+// Each interpolation must reproduce polynomials up to the degree it is exact for.
+
+static void require_polynomial_delays(const delay_interpolation interpolation, const int degree) {
+    const long      frame_count = 64;
+    delay_line<>    delay { 100 };
+    sample          input[frame_count];
+    sample          delays[frame_count];
+    sample          output[frame_count];
+    auto            polynomial = [degree](const double t) {
+        return 2.0 + (degree > 0 ? 0.5 * t : 0.0) + (degree > 2 ? 1e-3 * t * t - 1e-6 * t * t * t : 0.0);
+    };
+
+    delay.dspsetup(48000.0, frame_count);
+
+    for (auto vector = 0; vector < 10; ++vector) {
+        const auto now = vector * frame_count;
+
+        for (auto i = 0; i < frame_count; ++i) {
+            input[i]    = polynomial(now + i);
+            delays[i]   = 1.0 + 0.37 * i + 0.013 * i * i;
+        }
+        delay.write(input, frame_count);
+        delay.read(output, delays, frame_count, interpolation);
+
+        for (auto i = 0; i < frame_count && vector > 1; ++i) {
+            const auto expected = interpolation == delay_interpolation::none ? polynomial(now + i - std::floor(delays[i])) : polynomial(now + i - delays[i]);
+            REQUIRE( output[i] == Approx(expected).margin(1e-9) );
+        }
+    }
+}
+
+
+TEST_CASE( "delay_line interpolation", "[delay_line]" ) {
+    SECTION( "none" ) {
+        require_polynomial_delays(delay_interpolation::none, 0);
+    }
+    SECTION( "linear" ) {
+        require_polynomial_delays(delay_interpolation::linear, 1);
+    }
+    SECTION( "cubic" ) {
+        require_polynomial_delays(delay_interpolation::cubic, 1);
+    }
+    SECTION( "lagrange" ) {
+        require_polynomial_delays(delay_interpolation::lagrange, 3);
+    }
+
+    SECTION( "allpass" ) {
+        delay_line<>    delay { 64 };
+        const auto      w           = 2.0 * 3.14159265358979323846 * 500.0 / 48000.0;
+        const auto      delay_time  = 10.3;
+
+        delay.dspsetup(48000.0, 1);
+        for (auto n = 0; n < 2000; ++n) {
+            delay.write(std::sin(w * n));
+
+            const auto output = delay.read(delay_time, delay_interpolation::allpass);
+            if (n > 1000)
+                REQUIRE( output == Approx(std::sin(w * (n - delay_time))).margin(1e-4) );
+        }
+    }
+}
+
+
+// Benchmarks are hidden and only run when requested, e.g. `min-tests [benchmark]`
+
+TEST_CASE( "delay_line cost", "[.][benchmark]" ) {
+    const long      frame_count = 64;
+    delay_line<>    delay { 4800 };
+    sample          input[frame_count];
+    sample          delays[frame_count];
+    sample          output[frame_count];
+
+    delay.dspsetup(48000.0, frame_count);
+    for (auto i = 0; i < frame_count; ++i) {
+        input[i]    = std::sin(0.1 * i);
+        delays[i]   = 1000.0 + 300.0 * std::sin(0.01 * i);
+    }
+
+    BENCHMARK( "delay_line: modulated cubic read, 64 samples" ) {
+        delay.write(input, frame_count);
+        delay.read(output, delays, frame_count, delay_interpolation::cubic);
+        return output[0];
+    };
+}
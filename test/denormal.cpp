@@ -0,0 +1,115 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+class denormal_test_object : public object<denormal_test_object>, public sample_operator<1, 1> {
+public:
+    MIN_FLUSH_DENORMALS { true };
+
+    sample operator()(sample x) {
+        return x;
+    }
+};
+
+static_assert(has_flush_denormals<denormal_test_object>::value, "MIN_FLUSH_DENORMALS not detected");
+
+
+// The decaying tail of a one-pole lowpass filter, starting just above the denormal range.
+// volatile prevents the compiler from evaluating the loop at compile time.
+
+static sample decay_tail(const long frame_count) {
+    volatile sample coefficient = 0.99;
+    sample          y           = 1e-300;
+    sample          sum         = 0.0;
+
+    for (auto i = 0; i < frame_count; ++i) {
+        y   *= coefficient;
+        sum += y;
+    }
+    return sum + y;
+}
+
+
+TEST_CASE( "denormal_guard flushes denormals to zero", "[denormal]" ) {
+    volatile sample smallest_normal = std::numeric_limits<sample>::min();
+
+    REQUIRE( smallest_normal / 4.0 != 0.0 );    // denormals are produced by default
+
+    if (denormal_guard::supported()) {
+        {
+            denormal_guard guard;
+            REQUIRE( smallest_normal / 4.0 == 0.0 );
+        }
+        REQUIRE( smallest_normal / 4.0 != 0.0 );    // the previous state is restored
+    }
+}
+
+
+namespace {
+    struct denormal_worker_context {
+        std::atomic<int>                started { 0 };
+        std::atomic<int>                on_worker { 0 };
+        std::atomic<int>                flushing { 0 };
+        std::thread::id                 caller { std::this_thread::get_id() };
+    };
+
+    // Each task waits for the other to start, so that one of them runs on the worker thread.
+
+    void denormal_worker_task(void* a_context, const size_t) {
+        auto&       context     = *static_cast<denormal_worker_context*>(a_context);
+        const auto  deadline    = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+        context.started++;
+        while (context.started < 2 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        if (std::this_thread::get_id() != context.caller)
+            context.on_worker++;
+        if (denormal_guard::active())
+            context.flushing++;
+    }
+}
+
+
+TEST_CASE( "worker_pool tasks flush denormals like the calling thread", "[denormal]" ) {
+    worker_pool pool { 1 };
+
+    if (denormal_guard::supported()) {
+        SECTION( "with a guard" ) {
+            denormal_worker_context context;
+            denormal_guard          guard;
+
+            pool.run(denormal_worker_task, &context, 2);
+            REQUIRE( context.on_worker == 1 );
+            REQUIRE( context.flushing == 2 );
+        }
+        SECTION( "without a guard" ) {
+            denormal_worker_context context;
+
+            pool.run(denormal_worker_task, &context, 2);
+            REQUIRE( context.on_worker == 1 );
+            REQUIRE( context.flushing == 0 );
+        }
+    }
+}
+
+
+// Benchmarks are hidden and only run when requested, e.g. `min-tests [benchmark]`
+
+TEST_CASE( "denormal tail decay cost", "[.][benchmark]" ) {
+    const auto frame_count = 5000;    // the tail is denormal from ~1800 samples onwards
+
+    BENCHMARK( "decaying tail: default" ) {
+        return decay_tail(frame_count);
+    };
+
+    BENCHMARK( "decaying tail: denormal_guard" ) {
+        denormal_guard guard;
+        return decay_tail(frame_count);
+    };
+}
@@ -0,0 +1,66 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "dsp_profiler histogram buckets", "[dsp_profiler]" ) {
+
+    SECTION("each time falls within the bounds of its bucket") {
+        for (uint64_t ns : { 0ull, 1ull, 3ull, 4ull, 5ull, 7ull, 8ull, 9ull, 10ull, 1000ull, 1023ull, 1024ull, 1279ull, 1280ull, 123456789ull }) {
+            const auto index = dsp_profiler::bucket(ns);
+            const auto lower = index == 0 ? 0 : dsp_profiler::bucket_upper_bound(index - 1);
+
+            INFO("time " << ns << " ns in bucket " << index);
+            REQUIRE( index < dsp_profiler::k_bucket_count );
+            REQUIRE( ns >= lower );
+            REQUIRE( ns < dsp_profiler::bucket_upper_bound(index) );
+        }
+    }
+
+    SECTION("very long times are counted in the last used bucket") {
+        REQUIRE( dsp_profiler::bucket(~0ull) == dsp_profiler::bucket(0xFFFFFFFF) );
+        REQUIRE( dsp_profiler::bucket(~0ull) < dsp_profiler::k_bucket_count );
+    }
+}
+
+
+TEST_CASE( "dsp_profiler statistics", "[dsp_profiler]" ) {
+    dsp_profiler profiler;
+    profiler.dspsetup(nullptr, 48000.0);    // 64 samples last 1333 us
+
+    REQUIRE( profiler.statistics().count == 0 );
+
+    // 98 vectors that take 10 us, one that takes 100 us, and one overrun of 2 ms
+
+    for (auto i = 0; i < 98; ++i)
+        profiler.record(10000, 64);
+    profiler.record(100000, 64);
+    profiler.record(2000000, 64);
+
+    const auto stats = profiler.statistics();
+
+    REQUIRE( stats.count == 100 );
+    REQUIRE( stats.mean == Approx((98 * 10.0 + 100.0 + 2000.0) / 100) );
+    REQUIRE( stats.max == Approx(2000.0) );
+    REQUIRE( stats.budget == Approx(64 / 48000.0 * 1e6).epsilon(0.001) );
+    REQUIRE( stats.overruns == 1 );
+    REQUIRE( stats.p99 >= 100.0 );
+    REQUIRE( stats.p99 <= 125.0 );
+
+    SECTION("a reset is applied by the next recording") {
+        profiler.reset();
+        profiler.record(20000, 64);
+
+        const auto after = profiler.statistics();
+
+        REQUIRE( after.count == 1 );
+        REQUIRE( after.mean == Approx(20.0) );
+        REQUIRE( after.max == Approx(20.0) );
+        REQUIRE( after.overruns == 0 );
+    }
+}
@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_MAIN
 
 #include "c74_min_catch.h"
+#include "c74_min_render.h"
 
 using namespace c74::min;
 
@@ -37,3 +38,63 @@ TEST_CASE("Attribute - repetitions", "[attribute]") {
 		REQUIRE(static_cast<number>(my_attr) == 7.5);
 	}
 }
+
+TEST_CASE("Attribute - assignment from a signal", "[attribute]") {
+	TestObject my_object;
+	attribute<number, threadsafe::no, limit::clamp> clamped {&my_object, "Clamped", 0.0, range {-10.0, 10.0}};
+	attribute<number> custom {&my_object, "Custom", 0.0, setter { MIN_FUNCTION { return args; } }};
+	attribute<symbol> text {&my_object, "Text", "foo"};
+
+	SECTION("The value is range-limited without calling set()") {
+		clamped.set_from_signal(25.0);
+		REQUIRE(static_cast<number>(clamped) == 10.0);
+
+		auto setter = clamped.signal_setter_function();
+		REQUIRE(setter != nullptr);
+		setter(clamped, -2.5);
+		REQUIRE(static_cast<number>(clamped) == -2.5);
+	}
+
+	SECTION("Attributes with a custom setter or a non-numeric type are set using atoms") {
+		REQUIRE(custom.signal_setter_function() == nullptr);
+		REQUIRE(text.signal_setter_function() == nullptr);
+	}
+}
+
+
+class signal_mapped_gain : public object<signal_mapped_gain>, public sample_operator<2, 1> {
+public:
+	attribute<number, threadsafe::no, limit::clamp> gain {this, "gain", 1.0, range {0.0, 2.0}};
+
+	inlet<>  input       {this, "(signal) Input"};
+	inlet<>  gain_input  {this, "(signal) Gain", gain};
+	outlet<> output      {this, "(signal) Output", "signal"};
+
+	sample operator()(sample x, sample) {
+		return x * gain;
+	}
+};
+
+
+TEST_CASE("Attribute - signal-rate updates from a mapped inlet", "[attribute]") {
+	render_harness<signal_mapped_gain> harness {48000.0, 64};
+	render_capture                     output;
+
+	SECTION("A changing signal updates the attribute for every sample") {
+		signal_generator source {2, [](long channel, long long frame) { return channel == 0 ? 1.0 : frame / 64.0; }, 192};
+
+		harness.render(source, output);
+		REQUIRE(output.samples(0).size() == 192);
+		for (auto i = 0; i < 192; ++i)
+			REQUIRE(output.samples(0)[i] == std::min(i / 64.0, 2.0));
+		REQUIRE(static_cast<number>(harness.object().gain) == 2.0);
+	}
+
+	SECTION("A constant signal is assigned once for the vector") {
+		signal_generator source {2, [](long channel, long long frame) { return channel == 0 ? static_cast<sample>(frame) : 0.5; }, 64};
+
+		harness.render(source, output);
+		REQUIRE(static_cast<number>(harness.object().gain) == 0.5);
+		REQUIRE(output.samples(0)[63] == 31.5);
+	}
+}
@@ -0,0 +1,114 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+class mc_onepole_test_object : public object<mc_onepole_test_object>, public mc_operator<> {
+public:
+    template<class T>
+    struct channel_state {
+        T previous { 0.0 };
+    };
+
+    template<class T>
+    T operator()(T input, channel_state<T>& state) {
+        auto output     = input + state.previous * 0.5;
+        state.previous  = output;
+        return output;
+    }
+};
+
+static_assert(has_channel_state<mc_onepole_test_object>::value, "channel_state not detected");
+
+
+// Sum the input of each channel, processing groups of four channels on the worker_pool.
+
+class mc_parallel_test_object : public object<mc_parallel_test_object>, public mc_operator<> {
+public:
+    MIN_PARALLEL_CHANNELS { 4 };
+
+    inlet<>     input   { this, "(multichannelsignal) Input" };
+    outlet<>    output  { this, "(multichannelsignal) Output", "multichannelsignal" };
+
+    template<class T>
+    struct channel_state {
+        T sum { 0.0 };
+    };
+
+    template<class T>
+    T operator()(T input, channel_state<T>& state) {
+        state.sum = state.sum + input;
+        return state.sum;
+    }
+};
+
+
+TEST_CASE( "mc_operator per-channel state", "[mc_operator]" ) {
+    using state_type = mc_onepole_test_object::channel_state<lanes<mc_channel_storage::k_width>>;
+
+    mc_onepole_test_object  my_object;
+    const auto              frame_count = 8;
+
+    my_object.channels().resize<state_type>(6, frame_count);
+    REQUIRE( my_object.channels().states<state_type>().size() == 2 );
+
+    // an impulse in each channel, scaled by the channel number, processed in-place
+    vector<sample_vector>   buffers(7, sample_vector(frame_count, 0.0));
+    vector<double*>         channels;
+
+    for (auto channel = 0; channel < buffers.size(); ++channel) {
+        buffers[channel][0] = channel + 1.0;
+        channels.push_back(buffers[channel].data());
+    }
+
+    perform_channels(my_object, channels.data(), 6, channels.data(), 7, frame_count);
+
+    SECTION( "each channel has its own state" ) {
+        for (auto channel = 0; channel < 6; ++channel) {
+            REQUIRE( buffers[channel][0] == Approx(channel + 1.0) );
+            REQUIRE( buffers[channel][1] == Approx((channel + 1.0) * 0.5) );
+            REQUIRE( buffers[channel][3] == Approx((channel + 1.0) * 0.125) );
+        }
+    }
+
+    SECTION( "channels without state are cleared" ) {
+        REQUIRE( buffers[6][0] == 0.0 );
+    }
+
+    SECTION( "a range of channels can be processed on its own" ) {
+        for (auto& buffer : buffers)
+            buffer[0] = 1.0;
+
+        perform_channels(my_object, channels.data(), 6, channels.data(), 7, 1, 4, 7);
+        REQUIRE( buffers[0][0] == 1.0 );                        // not processed
+        REQUIRE( buffers[4][0] == Approx(1.0 + 0.5 * 5.0 / 128.0) );   // processed with the state of channel 4
+        REQUIRE( buffers[6][0] == 0.0 );                        // no state, cleared
+    }
+
+    SECTION( "state is preserved when the channel count is unchanged" ) {
+        my_object.channels().resize<state_type>(6, frame_count);
+        REQUIRE( my_object.channels().states<state_type>()[0].previous[0] == Approx(1.0 / 128.0) );
+    }
+}
+
+
+TEST_CASE( "mc_operator channels processed in parallel", "[mc_operator]" ) {
+    render_harness<mc_parallel_test_object> harness { 48000.0, 64 };
+    signal_generator                        constant { 16, [](long channel, long long) { return channel + 1.0; }, 128 };
+    render_capture                          output;
+
+    // each range of channels must be processed once, with its own state, into its own outputs
+    harness.render(constant, output);
+    REQUIRE( output.channel_count() == 16 );
+    for (auto channel = 0; channel < 16; ++channel) {
+        REQUIRE( output.samples(channel)[0] == channel + 1.0 );
+        REQUIRE( output.samples(channel)[63] == (channel + 1.0) * 64.0 );
+        REQUIRE( output.samples(channel)[127] == (channel + 1.0) * 128.0 );
+    }
+}
@@ -0,0 +1,139 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_attribute_impl.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+class oversampler_test_object : public object<oversampler_test_object>, public sample_operator<1, 1> {
+public:
+    attribute<int>  factor      { this, "oversampling", 1 };
+    oversampler     resampler   { this, factor };
+
+    sample operator()(sample x) {
+        return x;
+    }
+};
+
+
+// Pass a sine wave through the upsampler and downsampler and return the peak of the output once the filters have settled.
+
+static sample oversampler_peak(oversampler& os, const double frequency) {
+    const auto  frame_count = 64;
+    sample      input[frame_count];
+    sample      output[frame_count];
+    const double* ins[1]    = { input };
+    double*     outs[1]     = { output };
+    sample      peak        = 0.0;
+
+    for (auto vector = 0; vector < 32; ++vector) {
+        for (auto i = 0; i < frame_count; ++i)
+            input[i] = std::sin(2.0 * 3.14159265358979323846 * frequency * (vector * frame_count + i) / 48000.0);
+
+        auto up     = os.upsample(ins, 1, frame_count);
+        auto down   = os.outputs(1);
+
+        std::copy(up[0], up[0] + frame_count * os.factor(), down[0]);
+        os.downsample(outs, 1, frame_count);
+
+        if (vector > 4) {
+            for (auto i = 0; i < frame_count; ++i)
+                peak = std::max(peak, std::fabs(output[i]));
+        }
+    }
+    return peak;
+}
+
+
+TEST_CASE( "oversampler", "[oversampler]" ) {
+    oversampler_test_object my_object;
+
+    REQUIRE( my_object.oversampling() == &my_object.resampler );
+
+    my_object.resampler.dspsetup(1, 1, 48000.0, 64);
+    REQUIRE( my_object.resampler.factor() == 1 );
+    REQUIRE( !my_object.resampler.active(1, 1, 64) );
+
+    SECTION( "the factor is rounded down to a power of two" ) {
+        my_object.factor = 5;
+        REQUIRE( my_object.resampler.update() );
+        REQUIRE( my_object.resampler.factor() == 4 );
+        REQUIRE( my_object.resampler.samplerate() == 192000.0 );
+        REQUIRE( !my_object.resampler.update() );
+        REQUIRE( my_object.resampler.active(1, 1, 64) );
+        REQUIRE( !my_object.resampler.active(1, 1, 128) );
+    }
+
+    SECTION( "signals in the passband are unchanged at all factors" ) {
+        for (auto factor : { 2, 4, 8 }) {
+            my_object.factor = factor;
+            my_object.resampler.update();
+            REQUIRE( oversampler_peak(my_object.resampler, 1000.0) == Approx(1.0).epsilon(0.01) );
+        }
+    }
+}
+
+
+class oversampler_setup_object : public object<oversampler_setup_object>, public sample_operator<1, 1> {
+public:
+    inlet<>         input       { this, "(signal) Input" };
+    outlet<>        output      { this, "(signal) Output", "signal" };
+    attribute<int>  factor      { this, "oversampling", 2 };
+    oversampler     resampler   { this, factor };
+
+    double          setup_samplerate    { 0.0 };
+    long            setup_vector_size   { 0 };
+    double          perform_samplerate  { 0.0 };
+
+    message<threadsafe::yes> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            setup_samplerate    = args[0];
+            setup_vector_size   = args[1];
+            return {};
+        }
+    };
+
+    sample operator()(sample x) {
+        perform_samplerate = samplerate();
+        return x;
+    }
+};
+
+
+TEST_CASE( "dspsetup sees the oversampled rate", "[oversampler]" ) {
+    render_harness<oversampler_setup_object>    harness { 48000.0, 64 };
+    signal_generator                            silence { 1, [](long, long long) { return 0.0; }, 64 };
+    render_capture                              output;
+    auto&                                       my_object = harness.object();
+
+    harness.render(silence, output);
+    REQUIRE( my_object.setup_samplerate == 96000.0 );
+    REQUIRE( my_object.setup_vector_size == 128 );
+    REQUIRE( my_object.perform_samplerate == 96000.0 );
+    REQUIRE( my_object.vector_size() == 128 );
+
+    SECTION( "changing the factor while audio is running changes the rate without sending dspsetup again" ) {
+        signal_generator more { 1, [](long, long long) { return 0.0; }, 64 };
+
+        my_object.factor = 4;
+        harness.render(more, output);
+        REQUIRE( my_object.setup_samplerate == 96000.0 );
+        REQUIRE( my_object.setup_vector_size == 128 );
+        REQUIRE( my_object.perform_samplerate == 192000.0 );
+        REQUIRE( my_object.vector_size() == 256 );
+    }
+
+    SECTION( "at a factor of 1 the class reports the rate of the signal chain" ) {
+        signal_generator more { 1, [](long, long long) { return 0.0; }, 64 };
+
+        my_object.factor = 1;
+        harness.render(more, output);
+        REQUIRE( my_object.perform_samplerate == 48000.0 );
+        REQUIRE( my_object.vector_size() == 64 );
+    }
+}
@@ -0,0 +1,192 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+// A voice that outputs its pitch while the note is held and for two vectors after it is released.
+
+struct poly_test_voice {
+    number  pitch { 0.0 };
+    int     release { 0 };
+    bool    held { false };
+    long    vector_size { 0 };
+    sample* rendered_to { nullptr };    // the first output channel of the most recent vector
+
+    void dspsetup(const double, const long a_vector_size) {
+        vector_size = a_vector_size;
+    }
+
+    void note_on(const number a_pitch, const number) {
+        pitch   = a_pitch;
+        held    = true;
+        release = 2;
+    }
+
+    void note_off() {
+        held = false;
+    }
+
+    bool active() const {
+        return held || release > 0;
+    }
+
+    void operator()(audio_bundle output) {
+        rendered_to = output.samples(0);
+        if (!held)
+            --release;
+        for (auto i = 0; i < output.frame_count(); ++i)
+            output.samples(0)[i] += pitch;
+    }
+};
+
+
+class poly_test_object : public object<poly_test_object>, public poly_operator<poly_test_voice, 4> {
+public:
+    outlet<> output { this, "(signal) Output", "signal" };
+};
+
+
+class parallel_poly_test_object : public object<parallel_poly_test_object>, public poly_operator<poly_test_voice, 4, 1> {
+public:
+    outlet<> output { this, "(signal) Output", "signal" };
+};
+
+
+// Process a vector and return the first sample of output, which is the sum of the pitches of the sounding voices.
+
+template<class object_type>
+static sample process_vector(object_type& my_object) {
+    sample_vector   buffer(static_cast<size_t>(my_object.vector_size()));
+    double*         channels[] = { buffer.data() };
+
+    my_object(audio_bundle { nullptr, 0, static_cast<long>(buffer.size()) }, audio_bundle { channels, 1, static_cast<long>(buffer.size()) });
+    return buffer[0];
+}
+
+
+TEST_CASE( "poly_operator assigns notes to voices", "[poly_operator]" ) {
+    poly_test_object my_object;
+
+    my_object.vector_size(64);
+    my_object.prepare_voices(1);
+    REQUIRE( my_object.voice(3).vector_size == 64 );
+
+    SECTION( "only sounding voices are processed" ) {
+        REQUIRE( process_vector(my_object) == 0.0 );
+
+        my_object.note_on(60.0, 100.0);
+        my_object.note_on(64.0, 100.0);
+        REQUIRE( process_vector(my_object) == 124.0 );
+        REQUIRE( my_object.active_voice_count() == 2 );
+
+        // a released voice sounds until its release has finished
+        my_object.note_off(60.0);
+        REQUIRE( process_vector(my_object) == 124.0 );
+        REQUIRE( process_vector(my_object) == 124.0 );
+        REQUIRE( my_object.active_voice_count() == 1 );
+        REQUIRE( process_vector(my_object) == 64.0 );
+
+        // a velocity of zero stops a note
+        my_object.note_on(64.0, 0.0);
+        process_vector(my_object);
+        process_vector(my_object);
+        REQUIRE( my_object.active_voice_count() == 0 );
+    }
+
+    SECTION( "a pitch that is sounding restarts its voice" ) {
+        my_object.note_on(60.0, 100.0);
+        my_object.note_on(60.0, 50.0);
+        REQUIRE( process_vector(my_object) == 60.0 );
+        REQUIRE( my_object.active_voice_count() == 1 );
+    }
+
+    SECTION( "voices are stolen when all are sounding" ) {
+        for (auto pitch : { 62.0, 60.0, 67.0, 64.0 })
+            my_object.note_on(pitch, pitch);
+        process_vector(my_object);
+
+        SECTION( "oldest" ) {
+            my_object.note_on(72.0, 100.0);
+            REQUIRE( process_vector(my_object) == 60.0 + 67.0 + 64.0 + 72.0 );
+        }
+        SECTION( "lowest" ) {
+            my_object.stealing(voice_stealing::lowest);
+            my_object.note_on(72.0, 100.0);
+            REQUIRE( process_vector(my_object) == 62.0 + 67.0 + 64.0 + 72.0 );
+        }
+        SECTION( "highest" ) {
+            my_object.stealing(voice_stealing::highest);
+            my_object.note_on(72.0, 100.0);
+            REQUIRE( process_vector(my_object) == 62.0 + 60.0 + 64.0 + 72.0 );
+        }
+        SECTION( "quietest" ) {
+            my_object.stealing(voice_stealing::quietest);
+            my_object.note_on(72.0, 100.0);
+            REQUIRE( process_vector(my_object) == 62.0 + 67.0 + 64.0 + 72.0 );
+        }
+        SECTION( "released voices first" ) {
+            my_object.note_off(67.0);
+            my_object.note_on(72.0, 100.0);
+            REQUIRE( process_vector(my_object) == 62.0 + 60.0 + 64.0 + 72.0 );
+        }
+        SECTION( "none" ) {
+            my_object.stealing(voice_stealing::none);
+            my_object.note_on(72.0, 100.0);
+            REQUIRE( process_vector(my_object) == 62.0 + 60.0 + 67.0 + 64.0 );
+        }
+    }
+
+    SECTION( "all notes off" ) {
+        my_object.note_on(60.0, 100.0);
+        my_object.note_on(64.0, 100.0);
+        my_object.all_notes_off();
+        for (auto i = 0; i < 3; ++i)
+            process_vector(my_object);
+        REQUIRE( my_object.active_voice_count() == 0 );
+    }
+}
+
+
+TEST_CASE( "poly_operator processes groups of voices in parallel", "[poly_operator]" ) {
+    parallel_poly_test_object   my_object;
+    sample_vector               buffer(64);
+    double*                     channels[] = { buffer.data() };
+
+    my_object.vector_size(64);
+    my_object.prepare_voices(1);
+
+    for (auto pitch : { 1.0, 2.0, 4.0, 8.0 })
+        my_object.note_on(pitch, 100.0);
+
+    for (auto i = 0; i < 100; ++i) {
+        my_object(audio_bundle { nullptr, 0, 64 }, audio_bundle { channels, 1, 64 });
+        REQUIRE( buffer[0] == 15.0 );
+    }
+
+    // each group of voices was given to the worker_pool, which renders them into the outputs of the group
+    // rather than directly into the output of the object
+    for (auto voice = 0; voice < 4; ++voice) {
+        REQUIRE( my_object.voice(voice).rendered_to != nullptr );
+        REQUIRE( my_object.voice(voice).rendered_to != buffer.data() );
+    }
+    REQUIRE( my_object.voice(0).rendered_to != my_object.voice(1).rendered_to );
+}
+
+
+TEST_CASE( "poly_operator processes a single group of voices on the audio thread", "[poly_operator]" ) {
+    poly_test_object    my_object;
+    sample_vector       buffer(64);
+    double*             channels[] = { buffer.data() };
+
+    my_object.vector_size(64);
+    my_object.prepare_voices(1);
+    my_object.note_on(60.0, 100.0);
+
+    my_object(audio_bundle { nullptr, 0, 64 }, audio_bundle { channels, 1, 64 });
+    REQUIRE( my_object.voice(0).rendered_to == buffer.data() );
+}
@@ -0,0 +1,174 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_attribute_impl.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+class render_test_gain : public object<render_test_gain>, public vector_operator<> {
+public:
+    inlet<>     input   { this, "(signal) Input" };
+    outlet<>    output  { this, "(signal) Output", "signal" };
+
+    attribute<number> gain { this, "gain", 0.5 };
+
+    void operator()(audio_bundle in, audio_bundle out) {
+        for (auto i = 0; i < in.frame_count(); ++i)
+            out.samples(0)[i] = in.samples(0)[i] * gain;
+    }
+};
+
+
+TEST_CASE( "render_harness processes a signal through an object", "[render]" ) {
+    render_harness<render_test_gain>    harness { 48000.0, 64 };
+    signal_generator                    ramp { 1, [](long, long long frame) { return static_cast<sample>(frame); }, 1000 };
+    render_capture                      output;
+
+    harness.object().gain = 0.25;
+
+    const auto stats = harness.render(ramp, output);
+
+    REQUIRE( stats.frame_count == 1000 );
+    REQUIRE( stats.duration == Approx(1000.0 / 48000.0).margin(1e-6) );
+    REQUIRE( output.channel_count() == 1 );
+    REQUIRE( output.samples(0).size() == 1000 );
+
+    for (auto i = 0; i < 1000; ++i)
+        REQUIRE( output.samples(0)[i] == Approx(i * 0.25).margin(1e-6) );
+
+    SECTION( "rendering without input" ) {
+        render_capture silence;
+
+        harness.render(silence, 100);
+        REQUIRE( silence.samples(0).size() == 100 );
+        REQUIRE( silence.samples(0)[99] == 0.0 );
+    }
+
+    SECTION( "a source without end requires a frame count" ) {
+        signal_generator    endless { 1, [](long, long long) { return 1.0; } };
+        render_capture      some;
+
+        REQUIRE_THROWS( harness.render(endless, some) );
+        REQUIRE_THROWS( harness.render(some, -1) );
+
+        harness.render(endless, some, 10);
+        REQUIRE( some.samples(0).size() == 10 );
+    }
+}
+
+
+TEST_CASE( "WAV files are written and read back", "[render]" ) {
+    const string        path = "min-tests-render.wav";
+    signal_generator    sine { 2, [](long channel, long long frame) { return channel == 0 ? std::sin(0.01 * frame) : -0.5; }, 300 };
+    sample_vector       left(300);
+    sample_vector       right(300);
+    double*             channels[] = { left.data(), right.data() };
+
+    {
+        wav_file_writer writer { path, 44100.0 };
+
+        while (const auto count = sine.read(channels, 64))
+            writer.write(channels, 2, count);
+    }
+
+    wav_file_reader reader { path };
+
+    REQUIRE( reader.samplerate() == 44100.0 );
+    REQUIRE( reader.channel_count() == 2 );
+    REQUIRE( reader.frame_count() == 300 );
+    REQUIRE( reader.read(channels, 1000) == 300 );
+
+    for (auto i = 0; i < 300; ++i) {
+        REQUIRE( left[i] == Approx(std::sin(0.01 * i)).margin(1e-6) );
+        REQUIRE( right[i] == -0.5 );
+    }
+
+    std::remove(path.c_str());
+}
+
+
+// Write a WAV file with a single 32-bit floating-point sample of 0.5 and a format chunk of the given type and size.
+
+static void write_wav_test_file(const string& path, const uint16_t format, const uint32_t format_size) {
+    std::ofstream   file { path, std::ios::binary };
+    auto            write = [&file](const uint64_t value, const int byte_count) {
+        for (auto i = 0; i < byte_count; ++i)
+            file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    };
+    const float     value = 0.5f;
+    uint32_t        word;
+
+    std::memcpy(&word, &value, sizeof word);
+
+    file.write("RIFF", 4);
+    write(4 + 8 + format_size + 8 + 4, 4);
+    file.write("WAVEfmt ", 8);
+    write(format_size, 4);
+    write(format, 2);
+    write(1, 2);                // channels
+    write(44100, 4);
+    write(44100 * 4, 4);
+    write(4, 2);
+    write(32, 2);
+    if (format_size >= 18)
+        write(format_size - 18, 2);
+    if (format_size >= 26) {
+        write(32, 2);           // valid bits
+        write(4, 4);            // channel mask
+        write(3, 2);            // the sub-format GUID starts with the format code for floating-point
+        for (auto i = 26u; i < format_size; ++i)
+            write(0, 1);
+    }
+    file.write("data", 4);
+    write(4, 4);
+    write(word, 4);
+}
+
+
+TEST_CASE( "WAV files with an extensible format", "[render]" ) {
+    const string path = "min-tests-extensible.wav";
+
+    SECTION( "the format is read from the sub-format" ) {
+        sample_vector   mono(1);
+        double*         channels[] = { mono.data() };
+
+        write_wav_test_file(path, 0xFFFE, 40);
+
+        wav_file_reader reader { path };
+        REQUIRE( reader.read(channels, 1) == 1 );
+        REQUIRE( mono[0] == 0.5 );
+    }
+
+    SECTION( "a format chunk too short to hold the sub-format is refused" ) {
+        write_wav_test_file(path, 0xFFFE, 18);
+        REQUIRE_THROWS( wav_file_reader { path } );
+    }
+
+    std::remove(path.c_str());
+}
+
+
+TEST_CASE( "WAV files are limited to 4 GB", "[render]" ) {
+    const string path = "min-tests-large.wav";
+
+    {
+        wav_file_writer writer { path, 48000.0 };
+        sample_vector   stereo(1);
+        double*         channels[] = { stereo.data(), stereo.data() };
+
+        writer.write(channels, 2, 1);
+
+        // the size is checked before any sample is read
+        REQUIRE_THROWS( writer.write(channels, 2, 0x20000000) );
+    }
+
+    wav_file_reader reader { path };
+    REQUIRE( reader.frame_count() == 1 );
+
+    std::remove(path.c_str());
+}
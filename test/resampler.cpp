@@ -0,0 +1,136 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+// Resample a sine wave and return the largest error against the exact value at each output position,
+// together with the largest error of linear interpolation at the same positions.
+
+struct resampler_error {
+    double sinc;
+    double linear;
+};
+
+static resampler_error resample_sine(resampler& a_resampler, const double ratio, const bool varying) {
+    const long      frame_count = 64;
+    const auto      frequency   = 0.05;    // cycles per input sample
+    auto            sine        = [frequency](const double t) { return std::sin(2.0 * 3.14159265358979323846 * frequency * t); };
+    sample_vector   input(1024);
+    sample          output[frame_count];
+    long            read        = 0;
+    double          position    = 0.0;
+    resampler_error error       { 0.0, 0.0 };
+
+    for (auto vector = 0; vector < 200; ++vector) {
+        const auto vector_ratio = varying ? ratio * (1.0 + 0.3 * std::sin(0.05 * vector)) : ratio;
+
+        a_resampler.ratio(vector_ratio);
+
+        const auto needed = a_resampler.input_required(frame_count);
+        for (auto i = 0; i < needed; ++i)
+            input[i] = sine(static_cast<double>(read + i));
+        read += needed;
+
+        REQUIRE( a_resampler.process(input.data(), needed, output, frame_count) == frame_count );
+
+        for (auto i = 0; i < frame_count; ++i, position += vector_ratio) {
+            const auto whole    = std::floor(position);
+            const auto linear   = sine(whole) + (sine(whole + 1.0) - sine(whole)) * (position - whole);
+
+            // skip the start, where the filter overlaps the silence before the first input sample
+            if (vector > 4) {
+                error.sinc      = std::max(error.sinc, std::abs(output[i] - sine(position)));
+                error.linear    = std::max(error.linear, std::abs(linear - sine(position)));
+            }
+        }
+    }
+    return error;
+}
+
+
+TEST_CASE( "resampler converts a sine wave", "[resampler]" ) {
+    for (auto ratio : { 44100.0 / 48000.0, 48000.0 / 44100.0, 2.3, 0.25 }) {
+        for (auto varying : { false, true }) {
+            INFO( "ratio " << ratio << (varying ? ", varying" : "") );
+
+            resampler my_resampler { 16 };
+            my_resampler.dspsetup(4.0, 64);
+
+            const auto error = resample_sine(my_resampler, ratio, varying);
+
+            REQUIRE( error.sinc < 1e-4 );
+            REQUIRE( error.sinc * 100.0 < error.linear );
+        }
+    }
+}
+
+
+TEST_CASE( "resampler consumes the input it asks for", "[resampler]" ) {
+    resampler       my_resampler { 8 };
+    sample_vector   input(512, 0.5);
+    sample          output[100];
+
+    my_resampler.dspsetup(2.0, 100);
+    REQUIRE( my_resampler.latency() >= 8 );
+
+    const auto latency = my_resampler.latency();
+
+    my_resampler.ratio(1.5);
+    REQUIRE( my_resampler.ratio() == 1.5 );
+    REQUIRE( my_resampler.latency() > latency );
+
+    for (long frame_count : { 1, 37, 100, 3 }) {
+        const auto needed = my_resampler.input_required(frame_count);
+
+        REQUIRE( my_resampler.process(input.data(), needed, output, frame_count) == frame_count );
+        REQUIRE( my_resampler.input_required(1) <= 2 );
+    }
+
+    // without enough input the resampler produces what it can
+    const auto needed = my_resampler.input_required(100);
+    REQUIRE( my_resampler.process(input.data(), needed - 15, output, 100) == 90 );
+
+    my_resampler.ratio(10.0);
+    REQUIRE( my_resampler.ratio() == 2.0 );
+}
+
+
+// Benchmarks are hidden and only run when requested, e.g. `min-tests [benchmark]`
+
+TEST_CASE( "resampler cost", "[.][benchmark]" ) {
+    const long      frame_count = 64;
+    const auto      ratio       = 44100.0 / 48000.0;
+    sample_vector   input(frame_count * 2);
+    sample          output[frame_count];
+    resampler       my_resampler { 16 };
+    double          position    = 0.0;
+
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = std::sin(0.1 * static_cast<double>(i));
+
+    my_resampler.dspsetup(1.0, frame_count);
+    my_resampler.ratio(ratio);
+
+    BENCHMARK( "resampler: windowed sinc, quality 16, 64 samples" ) {
+        const auto needed = my_resampler.input_required(frame_count);
+        my_resampler.process(input.data(), needed, output, frame_count);
+        return output[0];
+    };
+
+    BENCHMARK( "resampler: linear interpolation, 64 samples" ) {
+        for (auto i = 0; i < frame_count; ++i, position += ratio) {
+            if (position >= frame_count)
+                position -= frame_count;
+
+            const auto whole    = static_cast<size_t>(position);
+            const auto fraction = position - static_cast<double>(whole);
+            output[i]           = input[whole] + (input[whole + 1] - input[whole]) * fraction;
+        }
+        return output[0];
+    };
+}
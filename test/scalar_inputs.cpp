@@ -0,0 +1,94 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+class scalar_inputs_test_object : public object<scalar_inputs_test_object>, public sample_operator<2, 1> {
+public:
+    inlet<>     input   { this, "(signal) Input" };
+    inlet<>     gain    { this, "(signal/float) Gain" };
+    outlet<>    output  { this, "(signal) Output", "signal" };
+
+    sample operator()(sample in, sample a_gain) {
+        return in * a_gain;
+    }
+};
+
+
+class scalar_inputs_batch_test_object : public object<scalar_inputs_batch_test_object>, public sample_operator<2, 1> {
+public:
+    MIN_BATCH_LANES { 4 };
+
+    inlet<>     input   { this, "(signal) Input" };
+    inlet<>     gain    { this, "(signal/float) Gain" };
+    outlet<>    output  { this, "(signal) Output", "signal" };
+
+    template<class T>
+    T operator()(T in, T a_gain) {
+        return in * a_gain;
+    }
+};
+
+
+TEST_CASE( "sample_operator inputs without a signal connection", "[sample_operator]" ) {
+    render_harness<scalar_inputs_test_object>   harness { 48000.0, 64 };
+    render_capture                              output;
+    signal_generator                            ramp { 1, [](long, long long frame) { return static_cast<sample>(frame); }, 128 };
+
+    SECTION( "an unconnected inlet receives the float sent to it for every sample" ) {
+        harness.scalar(1, 0.5);
+        harness.render(ramp, output);
+        REQUIRE( output.samples(0)[0] == 0.0 );
+        REQUIRE( output.samples(0)[1] == 0.5 );
+        REQUIRE( output.samples(0)[127] == 63.5 );
+    }
+
+    SECTION( "a new float is used from the next vector" ) {
+        harness.scalar(1, 0.5);
+        harness.render(ramp, output, 64);
+        harness.scalar(1, 2.0);
+        harness.render(ramp, output, 64);
+        REQUIRE( output.samples(0)[63] == 31.5 );
+        REQUIRE( output.samples(0)[64] == 128.0 );
+    }
+
+    SECTION( "a connected inlet receives the signal rather than the float" ) {
+        signal_generator both { 2, [](long channel, long long frame) { return channel == 0 ? static_cast<sample>(frame) : -1.0; }, 128 };
+
+        harness.scalar(1, 0.5);
+        harness.render(both, output);
+        REQUIRE( output.samples(0)[1] == -1.0 );
+        REQUIRE( output.samples(0)[127] == -127.0 );
+    }
+}
+
+
+TEST_CASE( "batched sample_operator inputs without a signal connection", "[sample_operator]" ) {
+    render_harness<scalar_inputs_batch_test_object> harness { 48000.0, 66 };
+    render_capture                                  output;
+    signal_generator                                ramp { 1, [](long, long long frame) { return static_cast<sample>(frame); }, 132 };
+
+    SECTION( "the float sent to an unconnected inlet is in every lane and in the frames after the last pack" ) {
+        harness.scalar(1, 0.5);
+        harness.render(ramp, output);
+        REQUIRE( output.samples(0)[1] == 0.5 );
+        REQUIRE( output.samples(0)[3] == 1.5 );
+        REQUIRE( output.samples(0)[65] == 32.5 );
+        REQUIRE( output.samples(0)[131] == 65.5 );
+    }
+
+    SECTION( "a connected inlet receives the signal rather than the float" ) {
+        signal_generator both { 2, [](long channel, long long frame) { return channel == 0 ? static_cast<sample>(frame) : -1.0; }, 132 };
+
+        harness.scalar(1, 0.5);
+        harness.render(both, output);
+        REQUIRE( output.samples(0)[2] == -2.0 );
+        REQUIRE( output.samples(0)[131] == -131.0 );
+    }
+}
@@ -0,0 +1,70 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+// Add one to the input, so that processed silence can be told apart from the zeros written while bypassed.
+
+class silence_tail_test_object : public object<silence_tail_test_object>, public vector_operator<> {
+public:
+    MIN_SILENCE_TAIL { 128 };
+
+    inlet<>     input   { this, "(signal) Input" };
+    outlet<>    output  { this, "(signal) Output", "signal" };
+    int         calls   { 0 };
+
+    void operator()(audio_bundle in, audio_bundle out) {
+        ++calls;
+        for (auto i = 0; i < in.frame_count(); ++i)
+            out.samples(0)[i] = in.samples(0)[i] + 1.0;
+    }
+};
+
+
+TEST_CASE( "MIN_SILENCE_TAIL bypasses the perform routine while the input is silent", "[silence_tail]" ) {
+    render_harness<silence_tail_test_object>    harness { 48000.0, 64 };
+    render_capture                              output;
+    auto&                                       my_object = harness.object();
+
+    // one vector of sound, three of silence, then sound again
+    signal_generator input { 1, [](long, long long frame) { return frame < 64 || frame >= 256 ? 1.0 : 0.0; }, 320 };
+
+    harness.render(input, output);
+
+    SECTION( "the tail is processed after the input becomes silent" ) {
+        REQUIRE( output.samples(0)[0] == 2.0 );
+        REQUIRE( output.samples(0)[64] == 1.0 );
+        REQUIRE( output.samples(0)[191] == 1.0 );
+    }
+
+    SECTION( "the outputs are cleared without calling the object once the tail has elapsed" ) {
+        REQUIRE( output.samples(0)[192] == 0.0 );
+        REQUIRE( output.samples(0)[255] == 0.0 );
+        REQUIRE( my_object.calls == 4 );
+    }
+
+    SECTION( "processing resumes as soon as the input is not silent" ) {
+        REQUIRE( output.samples(0)[256] == 2.0 );
+        REQUIRE( output.samples(0)[319] == 2.0 );
+    }
+
+    SECTION( "a NaN in the input is not silence" ) {
+        signal_generator silence { 1, [](long, long long) { return 0.0; }, 192 };
+        signal_generator nan { 1, [](long, long long frame) { return frame == 10 ? std::numeric_limits<sample>::quiet_NaN() : 0.0; }, 64 };
+        render_capture   after;
+
+        harness.render(silence, after);
+        REQUIRE( my_object.calls == 6 );
+
+        harness.render(nan, after);
+        REQUIRE( my_object.calls == 7 );
+        REQUIRE( std::isnan(after.samples(0)[192 + 10]) );
+        REQUIRE( after.samples(0)[192] == 1.0 );
+    }
+}
@@ -0,0 +1,256 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "lanes arithmetic", "[simd]" ) {
+
+    sample  source[4] { 1.0, -2.0, 3.0, -4.0 };
+    auto    x = lanes<4>::load(source);
+
+    SECTION( "scalars are broadcast to all lanes" ) {
+        auto y = x * 2.0 + 1.0;
+        REQUIRE( y[0] == 3.0 );
+        REQUIRE( y[1] == -3.0 );
+        REQUIRE( y[2] == 7.0 );
+        REQUIRE( y[3] == -7.0 );
+    }
+
+    SECTION( "lane-wise helpers" ) {
+        auto y = clamp(abs(x), 0.0, 2.5);
+        REQUIRE( y[0] == 1.0 );
+        REQUIRE( y[1] == 2.0 );
+        REQUIRE( y[2] == 2.5 );
+        REQUIRE( y[3] == 2.5 );
+
+        auto z = apply(x, [](sample v) { return v * v; });
+        REQUIRE( z[3] == 16.0 );
+    }
+
+    SECTION( "store writes all lanes back to memory" ) {
+        sample destination[4] {};
+        (-x).store(destination);
+        REQUIRE( destination[0] == -1.0 );
+        REQUIRE( destination[3] == 4.0 );
+    }
+}
+
+
+class batch_test_gain : public object<batch_test_gain>, public sample_operator<2, 1> {
+public:
+    MIN_BATCH_LANES { 4 };
+
+    inlet<>     input       { this, "(signal) Input" };
+    inlet<>     gain        { this, "(signal) Gain" };
+    outlet<>    output      { this, "(signal) Output", "signal" };
+
+    int         batch_calls     { 0 };
+    int         sample_calls    { 0 };
+
+    template<class T>
+    T operator()(T x, T g) {
+        count(x);
+        return x * g;
+    }
+
+private:
+    void count(sample) {
+        ++sample_calls;
+    }
+
+    void count(const lanes<batch_lanes>&) {
+        ++batch_calls;
+    }
+};
+
+
+TEST_CASE( "batched performer", "[simd]" ) {
+    render_harness<batch_test_gain> harness { 48000.0, 66 };    // not a multiple of the pack width so that the tail is exercised
+    signal_generator                source { 2, [](long channel, long long frame) { return channel == 0 ? static_cast<sample>(frame) : 0.5; }, 132 };
+    render_capture                  output;
+
+    harness.render(source, output);
+
+    // each vector of 66 samples is 16 packs of 4 followed by 2 single samples
+    REQUIRE( harness.object().batch_calls == 32 );
+    REQUIRE( harness.object().sample_calls == 4 );
+    REQUIRE( output.samples(0).size() == 132 );
+
+    for (auto i = 0; i < 132; ++i)
+        REQUIRE( output.samples(0)[i] == i * 0.5 );
+}
+
+
+TEST_CASE( "vector kernels", "[simd]" ) {
+
+    const auto      frame_count = 67;    // not a multiple of the pack width so that the tail is exercised
+    sample_vector   source(frame_count);
+    sample_vector   destination(frame_count, 1.0);
+
+    for (auto i = 0; i < frame_count; ++i)
+        source[i] = i;
+
+    SECTION( "clear and copy" ) {
+        simd::copy(destination.data(), source.data(), frame_count);
+        REQUIRE( destination == source );
+
+        simd::clear(destination.data(), frame_count);
+        REQUIRE( destination == sample_vector(frame_count, 0.0) );
+    }
+
+    SECTION( "add and multiply-add" ) {
+        simd::add(destination.data(), source.data(), frame_count);
+        REQUIRE( destination[0] == 1.0 );
+        REQUIRE( destination[66] == 67.0 );
+
+        simd::multiply_add(destination.data(), source.data(), -1.0, frame_count);
+        REQUIRE( destination == sample_vector(frame_count, 1.0) );
+    }
+
+    SECTION( "gain ramp ends one sample past the vector" ) {
+        simd::gain_ramp(destination.data(), destination.data(), 0.0, 1.0, frame_count);
+        for (auto i = 0; i < frame_count; ++i)
+            REQUIRE( destination[i] == Approx(i / static_cast<double>(frame_count)).margin(1e-12) );
+    }
+
+    SECTION( "peak and silence detection" ) {
+        REQUIRE( simd::peak(source.data(), frame_count) == 66.0 );
+
+        simd::clear(destination.data(), frame_count);
+        REQUIRE( simd::silent(destination.data(), frame_count) );
+
+        destination[66] = -1e-30;    // only in the tail
+        REQUIRE( simd::peak(destination.data(), frame_count) == 1e-30 );
+        REQUIRE( !simd::silent(destination.data(), frame_count) );
+
+        simd::clear(destination.data(), frame_count);
+        destination[5] = std::numeric_limits<sample>::quiet_NaN();
+        REQUIRE( !simd::silent(destination.data(), frame_count) );
+
+        simd::clear(destination.data(), frame_count);
+        destination[66] = std::numeric_limits<sample>::quiet_NaN();
+        REQUIRE( !simd::silent(destination.data(), frame_count) );
+    }
+}
+
+
+TEST_CASE( "audio_bundle channel mixing", "[simd]" ) {
+
+    const auto      frame_count = 8;
+    sample_vector   wide[3] { sample_vector(frame_count, 1.0), sample_vector(frame_count, 2.0), sample_vector(frame_count, 4.0) };
+    sample_vector   narrow[2] { sample_vector(frame_count), sample_vector(frame_count) };
+    double*         wide_ptrs[3] { wide[0].data(), wide[1].data(), wide[2].data() };
+    double*         narrow_ptrs[2] { narrow[0].data(), narrow[1].data() };
+    audio_bundle    wide_bundle { wide_ptrs, 3, frame_count };
+    audio_bundle    narrow_bundle { narrow_ptrs, 2, frame_count };
+
+    SECTION( "mixdown wraps extra channels around" ) {
+        narrow_bundle.mixdown(wide_bundle);
+        REQUIRE( narrow[0][frame_count - 1] == 5.0 );
+        REQUIRE( narrow[1][frame_count - 1] == 2.0 );
+    }
+
+    SECTION( "upmix repeats the source channels" ) {
+        narrow_bundle.mixdown(wide_bundle);
+        wide_bundle.upmix(narrow_bundle);
+        REQUIRE( wide[2][0] == 5.0 );
+    }
+}
+
+
+TEST_CASE( "interleaving buffer~ frames", "[simd]" ) {
+
+    const auto  frame_count = 67;    // not a multiple of the block of four frames so that the tail is exercised
+
+    for (size_t channel_count : { 1, 2, 3, 4, 8 }) {
+        vector<float>           frames(frame_count * channel_count);
+        vector<float>           round_trip(frame_count * channel_count);
+        vector<sample_vector>   channels(channel_count, sample_vector(frame_count));
+        vector<sample*>         channel_ptrs;
+
+        for (auto& channel : channels)
+            channel_ptrs.push_back(channel.data());
+        for (size_t i = 0; i < frames.size(); ++i)
+            frames[i] = static_cast<float>(i) + 0.25f;
+
+        simd::deinterleave(channel_ptrs.data(), frames.data(), channel_count, frame_count);
+        for (auto i = 0; i < frame_count; ++i) {
+            for (size_t channel = 0; channel < channel_count; ++channel)
+                REQUIRE( channels[channel][i] == frames[i * channel_count + channel] );
+        }
+
+        simd::interleave(round_trip.data(), channel_ptrs.data(), channel_count, frame_count);
+        REQUIRE( round_trip == frames );
+    }
+}
+
+
+// Benchmarks are hidden and only run when requested, e.g. `min-tests [benchmark]`
+
+TEST_CASE( "vector kernel throughput", "[.][benchmark]" ) {
+
+    const auto      frame_count = 512;
+    sample_vector   source(frame_count, 0.5);
+    sample_vector   destination(frame_count, 0.25);
+
+    BENCHMARK( "multiply-add: scalar loop" ) {
+        for (auto i = 0; i < frame_count; ++i)
+            destination[i] += source[i] * 0.5;
+        return destination[0];
+    };
+
+    BENCHMARK( "multiply-add: simd kernel" ) {
+        simd::multiply_add(destination.data(), source.data(), 0.5, frame_count);
+        return destination[0];
+    };
+
+    BENCHMARK( "clear: scalar loop" ) {
+        for (auto i = 0; i < frame_count; ++i)
+            destination[i] = 0.0;
+        return destination[0];
+    };
+
+    BENCHMARK( "clear: simd kernel" ) {
+        simd::clear(destination.data(), frame_count);
+        return destination[0];
+    };
+
+    BENCHMARK( "gain ramp: scalar loop" ) {
+        const auto step = 0.5 / frame_count;
+        for (auto i = 0; i < frame_count; ++i)
+            destination[i] = source[i] * (0.5 + step * i);
+        return destination[0];
+    };
+
+    BENCHMARK( "gain ramp: simd kernel" ) {
+        simd::gain_ramp(destination.data(), source.data(), 0.5, 1.0, frame_count);
+        return destination[0];
+    };
+
+    const auto              channel_count = 8;
+    vector<float>           frames(frame_count * channel_count, 0.5f);
+    vector<sample_vector>   channels(channel_count, sample_vector(frame_count));
+    sample*                 channel_ptrs[channel_count];
+
+    for (auto channel = 0; channel < channel_count; ++channel)
+        channel_ptrs[channel] = channels[channel].data();
+
+    BENCHMARK( "deinterleave 8 channels: scalar loop" ) {
+        for (auto i = 0; i < frame_count; ++i) {
+            for (auto channel = 0; channel < channel_count; ++channel)
+                channel_ptrs[channel][i] = frames[i * channel_count + channel];
+        }
+        return channels[0][0];
+    };
+
+    BENCHMARK( "deinterleave 8 channels: simd kernel" ) {
+        simd::deinterleave(channel_ptrs, frames.data(), channel_count, frame_count);
+        return channels[0][0];
+    };
+}
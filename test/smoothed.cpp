@@ -0,0 +1,108 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_attribute_impl.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+class smoothed_test_object : public object<smoothed_test_object> {
+public:
+    double samplerate() const {
+        return 1000.0;
+    }
+};
+
+
+TEST_CASE( "smoothed attribute ramps", "[smoothed]" ) {
+    smoothed_test_object    my_object;
+    attribute<number>       my_attr { &my_object, "gain", 0.0 };
+    smoothed                my_smoothed { &my_object, my_attr, 4.0 };    // 4 samples at 1000 Hz
+
+    my_smoothed.dspsetup(8);
+
+    SECTION( "an unchanged attribute produces a constant span" ) {
+        auto span = my_smoothed.next(8);
+        REQUIRE( span.constant() );
+        REQUIRE( span.value() == 0.0 );
+    }
+
+    SECTION( "a new value ramps linearly and then settles" ) {
+        my_attr = 1.0;
+
+        auto span = my_smoothed.next(8);
+        REQUIRE( !span.constant() );
+        REQUIRE( span[0] == Approx(0.25) );
+        REQUIRE( span[3] == Approx(1.0) );
+        REQUIRE( span[7] == Approx(1.0) );
+
+        span = my_smoothed.next(8);
+        REQUIRE( span.constant() );
+        REQUIRE( span.value() == 1.0 );
+    }
+
+    SECTION( "per-sample calls follow the same ramp" ) {
+        my_attr = -1.0;
+        REQUIRE( my_smoothed() == Approx(-0.25) );
+        REQUIRE( my_smoothed() == Approx(-0.5) );
+        REQUIRE( my_smoothed() == Approx(-0.75) );
+        REQUIRE( my_smoothed() == Approx(-1.0) );
+        REQUIRE( !my_smoothed.ramping() );
+    }
+
+    SECTION( "a vector longer than the storage from dspsetup jumps to the new value" ) {
+        my_attr = 1.0;
+
+        auto span = my_smoothed.next(16);
+        REQUIRE( span.constant() );
+        REQUIRE( span.value() == 1.0 );
+        REQUIRE( !my_smoothed.ramping() );
+    }
+}
+
+
+TEST_CASE( "smoothed follows attributes of other arithmetic types", "[smoothed]" ) {
+    smoothed_test_object    my_object;
+    attribute<int>          my_attr { &my_object, "steps", 0 };
+    smoothed                my_smoothed { &my_object, my_attr, 2.0 };    // 2 samples at 1000 Hz
+
+    my_attr = 4;
+    REQUIRE( my_smoothed() == Approx(2.0) );
+    REQUIRE( my_smoothed() == Approx(4.0) );
+    REQUIRE( !my_smoothed.ramping() );
+}
+
+
+// Write the smoothed gain to the output, without a dspsetup message to allocate the storage.
+
+class smoothed_vector_object : public object<smoothed_vector_object>, public vector_operator<> {
+public:
+    outlet<>            output      { this, "(signal) Output", "signal" };
+    attribute<number>   gain        { this, "gain", 0.0 };
+    smoothed            gain_ramp   { this, gain, 4.0 };
+
+    void operator()(audio_bundle in, audio_bundle out) {
+        const auto span = gain_ramp.next(out.frame_count());
+
+        for (auto i = 0; i < out.frame_count(); ++i)
+            out.samples(0)[i] = span[i];
+    }
+};
+
+
+TEST_CASE( "smoothed storage is allocated when the dsp chain is compiled", "[smoothed]" ) {
+    render_harness<smoothed_vector_object>  harness { 1000.0, 8 };
+    render_capture                          output;
+
+    REQUIRE( harness.object().smoothed_attributes().size() == 1 );
+
+    harness.object().gain = 1.0;
+    harness.render(output, 8);
+    REQUIRE( output.samples(0)[0] == Approx(0.25) );
+    REQUIRE( output.samples(0)[2] == Approx(0.75) );
+    REQUIRE( output.samples(0)[7] == 1.0 );
+}
@@ -0,0 +1,163 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+// A repeatable signal with energy in every bin.
+
+static sample_vector spectral_test_signal(const size_t frame_count) {
+    sample_vector signal(frame_count);
+
+    for (size_t i = 0; i < frame_count; ++i)
+        signal[i] = std::sin(0.37 * i) + 0.5 * std::cos(1.91 * i + 0.2) + 0.01 * ((i * 7919) % 101);
+    return signal;
+}
+
+
+TEST_CASE( "fft matches the discrete Fourier transform", "[spectral]" ) {
+    for (size_t size : { 4, 8, 16, 64, 128, 512 }) {
+        INFO( "size " << size );
+
+        fft                             transform   { size };
+        auto                            input       = spectral_test_signal(size);
+        vector<std::complex<sample>>    spectrum    (transform.bin_count());
+        sample_vector                   output      (size);
+
+        REQUIRE( transform.bin_count() == size / 2 + 1 );
+
+        transform.forward(input.data(), spectrum.data());
+
+        for (size_t k = 0; k < transform.bin_count(); ++k) {
+            std::complex<sample> expected {};
+            for (size_t n = 0; n < size; ++n)
+                expected += input[n] * std::polar(1.0, -2.0 * 3.14159265358979323846 * k * n / size);
+
+            REQUIRE( spectrum[k].real() == Approx(expected.real()).margin(1e-9) );
+            REQUIRE( spectrum[k].imag() == Approx(expected.imag()).margin(1e-9) );
+        }
+
+        transform.inverse(spectrum.data(), output.data());
+
+        for (size_t n = 0; n < size; ++n)
+            REQUIRE( output[n] == Approx(input[n]).margin(1e-9) );
+    }
+}
+
+
+class spectral_test_object : public object<spectral_test_object>, public spectral_operator<1, 2> {
+public:
+    inlet<>     in      { this, "(signal) input" };
+    outlet<>    out1    { this, "(signal) input, delayed", "signal" };
+    outlet<>    out2    { this, "(signal) silence", "signal" };
+
+    int         frames_processed { 0 };
+
+    void operator()(spectral_bundle input, spectral_bundle output) {
+        ++frames_processed;
+    }
+};
+
+
+TEST_CASE( "spectral_operator settings", "[spectral]" ) {
+    spectral_test_object my_object;
+
+    REQUIRE( my_object.input_count() == 1 );
+    REQUIRE( my_object.output_count() == 2 );
+    REQUIRE( my_object.frame_size() == 1024 );
+    REQUIRE( my_object.overlap() == 4 );
+
+    my_object.frame_size(1000);
+    my_object.overlap(3);
+
+    REQUIRE( my_object.frame_size() == 1024 );
+    REQUIRE( my_object.overlap() == 4 );
+
+    my_object.frame_size(2);
+    my_object.overlap(1);
+
+    REQUIRE( my_object.frame_size() == 16 );
+    REQUIRE( my_object.overlap() == 2 );
+}
+
+
+TEST_CASE( "overlap_add reconstructs its input", "[spectral]" ) {
+    const long  frame_count = 3000;
+    const auto  input       = spectral_test_signal(frame_count);
+
+    for (size_t frame_size : { 16, 256 }) {
+        for (size_t overlap : { 2, 4, 8 }) {
+            for (long vector_size : { 1, 64, 100 }) {
+                INFO( "frame size " << frame_size << ", overlap " << overlap << ", vector size " << vector_size );
+
+                spectral_test_object    my_object;
+                sample_vector           output1(frame_count);
+                sample_vector           output2(frame_count);
+
+                my_object.frames().dspsetup(1, 2, frame_size, overlap);
+
+                REQUIRE( my_object.frames().hop_size() == frame_size / overlap );
+                REQUIRE( my_object.frames().latency() == frame_size );
+
+                for (long start = 0; start < frame_count; start += vector_size) {
+                    const auto      count       = std::min(vector_size, frame_count - start);
+                    const double*   ins[1]      = { input.data() + start };
+                    double*         outs[2]     = { output1.data() + start, output2.data() + start };
+
+                    my_object.frames().process(ins, 1, outs, 2, count, [&my_object](spectral_bundle in, spectral_bundle out) {
+                        my_object(in, out);
+                    });
+                }
+
+                // the first output receives a copy of the input spectrum and the second output receives zeros
+                for (long i = 0; i < frame_count; ++i) {
+                    const auto expected = i < static_cast<long>(frame_size) ? 0.0 : input[i - frame_size];
+                    REQUIRE( output1[i] == Approx(expected).margin(1e-9) );
+                    REQUIRE( output2[i] == 0.0 );
+                }
+                REQUIRE( my_object.frames_processed == frame_count * overlap / frame_size );
+            }
+        }
+    }
+}
+
+
+TEST_CASE( "spectral_operator performer", "[spectral]" ) {
+    render_harness<spectral_test_object>    harness { 48000.0, 64 };
+    auto&                                   my_object   = harness.object();
+    const auto                              input       = spectral_test_signal(256);
+    signal_generator                        source      { 1, [&input](long, long long frame) { return input[frame]; }, 256 };
+    render_capture                          output;
+
+    my_object.frame_size(16);
+    my_object.overlap(4);
+    harness.render(source, output);
+
+    REQUIRE( my_object.frames().frame_size() == 16 );
+    REQUIRE( my_object.frames_processed == 256 * 4 / 16 );
+    REQUIRE( output.channel_count() == 2 );
+    for (auto i = 0; i < 256; ++i) {
+        REQUIRE( output.samples(0)[i] == Approx(i < 16 ? 0.0 : input[i - 16]).margin(1e-9) );
+        REQUIRE( output.samples(1)[i] == 0.0 );
+    }
+}
+
+
+// Benchmarks are hidden and only run when requested, e.g. `min-tests [benchmark]`
+
+TEST_CASE( "fft cost", "[.][benchmark]" ) {
+    fft                             transform   { 1024 };
+    auto                            signal      = spectral_test_signal(1024);
+    vector<std::complex<sample>>    spectrum    (transform.bin_count());
+
+    BENCHMARK( "fft: forward and inverse, 1024 samples" ) {
+        transform.forward(signal.data(), spectrum.data());
+        transform.inverse(spectrum.data(), signal.data());
+        return signal[0];
+    };
+}
@@ -0,0 +1,188 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_render.h"
+
+using namespace c74::min;
+
+
+// Wait, as an audio thread would between vectors, until the background thread has decoded a number of frames.
+
+static void wait_for_frames(stream_reference& a_stream, const size_t frame_count) {
+    while (a_stream.seeking() || a_stream.available() < frame_count)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+
+TEST_CASE( "stream_reference plays a WAV file from disk", "[stream]" ) {
+    const string        path = "min-tests-stream.wav";
+    signal_generator    ramp { 2, [](long channel, long long frame) { return (channel == 0 ? 1.0 : -1.0) * frame / 1024.0; }, 1000 };
+    sample_vector       left(1000);
+    sample_vector       right(1000);
+    sample_vector       extra(1000, 1.0);
+    double*             channels[] = { left.data(), right.data(), extra.data() };
+
+    {
+        wav_file_writer writer { path, 48000.0 };
+
+        while (const auto count = ramp.read(channels, 64))
+            writer.write(channels, 2, count);
+    }
+
+    stream_reference stream { nullptr };
+
+    REQUIRE( stream.read(channels, 3, 64) == 0 );
+    REQUIRE( left[0] == 0.0 );
+    REQUIRE( !stream.open_file("min-tests-missing.wav") );
+
+    REQUIRE( stream.open_file(path) );
+    REQUIRE( stream.frame_count() == 1000 );
+    REQUIRE( stream.channel_count() == 2 );
+    REQUIRE( stream.samplerate() == 48000.0 );
+
+    wait_for_frames(stream, 1000);
+    REQUIRE( stream.read(channels, 3, 600) == 600 );
+    REQUIRE( stream.read(channels, 3, 600) == 400 );
+
+    for (auto i = 0; i < 400; ++i) {
+        REQUIRE( left[i] == Approx((600 + i) / 1024.0).margin(1e-9) );
+        REQUIRE( right[i] == Approx(-(600 + i) / 1024.0).margin(1e-9) );
+        REQUIRE( extra[i] == 0.0 );
+    }
+    REQUIRE( left[400] == 0.0 );
+    REQUIRE( stream.finished() );
+    REQUIRE( stream.underruns() == 0 );
+
+    SECTION( "seeking" ) {
+        stream.seek(900);
+        wait_for_frames(stream, 100);
+        REQUIRE( stream.read(channels, 1, 1) == 1 );
+        REQUIRE( left[0] == Approx(900 / 1024.0).margin(1e-9) );
+    }
+
+    SECTION( "seeking to the end" ) {
+        stream.seek(5000);
+        wait_for_frames(stream, 0);
+        REQUIRE( stream.finished() );
+        REQUIRE( stream.read(channels, 1, 1) == 0 );
+    }
+
+    SECTION( "looping" ) {
+        stream.looping(true);
+        stream.seek(990);
+        wait_for_frames(stream, 20);
+        REQUIRE( stream.read(channels, 1, 20) == 20 );
+        REQUIRE( left[9] == Approx(999 / 1024.0).margin(1e-9) );
+        REQUIRE( left[10] == 0.0 );
+        REQUIRE( left[19] == Approx(9 / 1024.0).margin(1e-9) );
+    }
+
+    stream.close();
+    REQUIRE( stream.read(channels, 1, 64) == 0 );
+    REQUIRE( stream.finished() );
+    std::remove(path.c_str());
+}
+
+
+TEST_CASE( "stream_reference reads raw files and counts underruns", "[stream]" ) {
+    const string    path = "min-tests-stream.raw";
+    const size_t    frame_count = 3000;
+
+    {
+        std::ofstream file { path, std::ios::binary };
+
+        for (size_t i = 0; i < frame_count; ++i) {
+            const auto value = static_cast<int16_t>(i);
+            file.write(reinterpret_cast<const char*>(&value), 2);
+        }
+    }
+
+    stream_reference    stream { nullptr, nullptr, true, 100 };
+    sample_vector       output(1024);
+    double*             channels[] = { output.data() };
+
+    REQUIRE( stream.read_ahead() == 128 );
+    REQUIRE( stream.open_file(path, { 1, 16, false, 44100.0, 0 }) );
+    REQUIRE( stream.frame_count() == frame_count );
+
+    // the ring holds fewer frames than are asked for, so the read falls short
+    wait_for_frames(stream, 128);
+    REQUIRE( stream.read(channels, 1, 1024) == 128 );
+    REQUIRE( output[127] == Approx(127 / 32768.0).margin(1e-9) );
+    REQUIRE( output[128] == 0.0 );
+    REQUIRE( stream.underruns() == 1 );
+    REQUIRE( stream.underrun_frames() == 1024 - 128 );
+    REQUIRE( stream.lowest_available() == 128 );
+
+    // playback continues where it stopped
+    wait_for_frames(stream, 64);
+    REQUIRE( stream.read(channels, 1, 64) == 64 );
+    REQUIRE( output[0] == Approx(128 / 32768.0).margin(1e-9) );
+
+    stream.reset_underruns();
+    REQUIRE( stream.underruns() == 0 );
+    REQUIRE( stream.lowest_available() == 128 );
+
+    std::remove(path.c_str());
+}
+
+
+// Write a WAV file of one 16-bit sample with a WAVE_FORMAT_EXTENSIBLE format chunk of the given size.
+
+static void write_extensible_test_file(const string& path, const uint32_t format_size) {
+    std::ofstream   file { path, std::ios::binary };
+    auto            write = [&file](const uint64_t value, const int byte_count) {
+        for (auto i = 0; i < byte_count; ++i)
+            file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    };
+
+    file.write("RIFF", 4);
+    write(4 + 8 + format_size + 8 + 2, 4);
+    file.write("WAVEfmt ", 8);
+    write(format_size, 4);
+    write(0xFFFE, 2);
+    write(1, 2);                // channels
+    write(44100, 4);
+    write(44100 * 2, 4);
+    write(2, 2);
+    write(16, 2);
+    if (format_size >= 18)
+        write(format_size - 18, 2);
+    if (format_size >= 26) {
+        write(16, 2);           // valid bits
+        write(4, 4);            // channel mask
+        write(1, 2);            // the sub-format GUID starts with the format code for integers
+        for (auto i = 26u; i < format_size; ++i)
+            write(0, 1);
+    }
+    file.write("data", 4);
+    write(2, 4);
+    write(0x4000, 2);
+}
+
+
+TEST_CASE( "stream_reference reads the sub-format of an extensible WAV file", "[stream]" ) {
+    const string        path = "min-tests-stream-extensible.wav";
+    stream_reference    stream { nullptr };
+
+    SECTION( "the format is read from the sub-format" ) {
+        sample_vector   output(1);
+        double*         channels[] = { output.data() };
+
+        write_extensible_test_file(path, 40);
+        REQUIRE( stream.open_file(path) );
+        wait_for_frames(stream, 1);
+        REQUIRE( stream.read(channels, 1, 1) == 1 );
+        REQUIRE( output[0] == 0.5 );
+    }
+
+    SECTION( "a format chunk too short to hold the sub-format is refused" ) {
+        write_extensible_test_file(path, 18);
+        REQUIRE( !stream.open_file(path) );
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,94 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+namespace {
+    struct worker_pool_test_context {
+        std::array<std::atomic<int>, 64> runs;
+    };
+
+    void worker_pool_test_task(void* context, const size_t index) {
+        static_cast<worker_pool_test_context*>(context)->runs[index]++;
+    }
+}
+
+
+TEST_CASE( "worker_pool runs every task exactly once", "[worker_pool]" ) {
+    worker_pool                 pool { 3 };
+    worker_pool_test_context    context;
+
+    REQUIRE( pool.thread_count() == 3 );
+
+    for (auto job = 0; job < 1000; ++job) {
+        const size_t task_count = 1 + job % context.runs.size();
+
+        for (auto& runs : context.runs)
+            runs = 0;
+
+        pool.run(worker_pool_test_task, &context, task_count);
+
+        for (auto i = 0; i < context.runs.size(); ++i)
+            REQUIRE( context.runs[i] == (i < task_count ? 1 : 0) );
+    }
+}
+
+
+TEST_CASE( "worker_pool without threads runs tasks serially", "[worker_pool]" ) {
+    worker_pool                 pool { 0 };
+    worker_pool_test_context    context;
+
+    for (auto& runs : context.runs)
+        runs = 0;
+
+    pool.run(worker_pool_test_task, &context, 8);
+    REQUIRE( context.runs[7] == 1 );
+    REQUIRE( context.runs[8] == 0 );
+}
+
+
+namespace {
+    struct worker_pool_rendezvous_context {
+        std::atomic<int>    started { 0 };
+        std::atomic<int>    met { 0 };
+    };
+
+    // Each task waits for the other to start, which can only happen if the tasks run on two threads at once.
+
+    void worker_pool_rendezvous_task(void* a_context, const size_t) {
+        auto&       context     = *static_cast<worker_pool_rendezvous_context*>(a_context);
+        const auto  deadline    = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+        context.started++;
+        while (context.started < 2 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        if (context.started == 2)
+            context.met++;
+    }
+}
+
+
+TEST_CASE( "worker_pool wakes blocked threads for a new job", "[worker_pool]" ) {
+    worker_pool pool { 1 };
+
+    for (auto job = 0; job < 3; ++job) {
+        worker_pool_rendezvous_context context;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));    // long enough for the worker to block
+        pool.run(worker_pool_rendezvous_task, &context, 2);
+        REQUIRE( context.met == 2 );
+    }
+}
+
+
+TEST_CASE( "worker_pool is shared by all objects of an external", "[worker_pool]" ) {
+    auto& pool = worker_pool::shared();
+
+    REQUIRE( &worker_pool::shared() == &pool );
+    REQUIRE( symbol("#min_worker_pool").object() == nullptr );
+}